@@ -0,0 +1,86 @@
+#include "action_preview.h"
+#include "card_system.h"
+#include "combo_solver.h"
+#include "game_action.h"
+#include "rng.h"
+
+// 每個執行緒一份複本，預覽不需要配置記憶體
+static _Thread_local game previewState;
+
+static void read_players(game *gs, PreviewPlayer players[2])
+{
+    for (int i = 0; i < 2; i++)
+    {
+        players[i].life = gs->players[i].life;
+        players[i].defense = gs->players[i].defense;
+        players[i].energy = gs->players[i].energy;
+        players[i].position = gs->players[i].locate[0];
+    }
+}
+
+// 技能卡的搭配：組合計畫中這張技能卡的基本牌，不在計畫中時用第一個合法選擇
+static int32_t partner_choice(game *gs)
+{
+    vector choices;
+    get_legal_choices(gs, &choices);
+    if (choices.SIZE == 0)
+        return 0;
+
+    ComboPlan plan;
+    plan_combo(gs, (ComboGoal)(get_card_type(gs->nowUsingCardID) - CARD_TYPE_SKILL_ATK), &plan);
+    vector *hand = &gs->players[gs->now_turn_player_id].hand;
+    for (uint32_t i = 0; i < plan.count; i++)
+    {
+        if (plan.plays[i].skill < 0 || hand->array[plan.plays[i].skill] != gs->nowUsingCardID)
+            continue;
+        int32_t choice = findVector(hand, hand->array[plan.plays[i].basic]) + 1;
+        if (findVector(&choices, choice) >= 0)
+            return choice;
+    }
+    return choices.array[0];
+}
+
+bool preview_choice(game *gs, int32_t choice, ActionPreview *preview)
+{
+    memset(preview, 0, sizeof(ActionPreview));
+    preview->choice = choice;
+    int8_t mover = gs->now_turn_player_id;
+    int8_t opponent = (int8_t)((mover + 1) % 2);
+
+    RngState *previous = rng_get_active();
+    RngState rng;
+    if (previous != NULL)
+        rng = *previous;
+    else
+        rng_seed(&rng, 0, 0);
+    rng_set_active(&rng);
+
+    game *next = &previewState;
+    clone_game(next, gs);
+    bool legal = apply_choice(next, choice);
+    if (legal && next->status == USEBASIC && next->now_turn_player_id == mover)
+    {
+        preview->partnerChoice = partner_choice(next);
+        if (preview->partnerChoice != 0)
+            apply_choice(next, preview->partnerChoice);
+    }
+    rng_set_active(previous);
+    if (!legal)
+        return false;
+
+    read_players(gs, preview->before);
+    read_players(next, preview->after);
+    preview->damage = preview->before[opponent].life + preview->before[opponent].defense -
+                      preview->after[opponent].life - preview->after[opponent].defense;
+    preview->lifeDamage = preview->before[opponent].life - preview->after[opponent].life;
+    preview->energyGained = preview->after[mover].energy - preview->before[mover].energy;
+    preview->nextStatus = next->status;
+    preview->endsTurn = next->now_turn_player_id != mover;
+    preview->winner = get_winner(next);
+    return true;
+}
+
+bool preview_has_effect(const ActionPreview *preview)
+{
+    return preview->winner >= 0 || memcmp(preview->before, preview->after, sizeof(preview->before)) != 0;
+}
@@ -0,0 +1,36 @@
+#ifndef _ACTION_PREVIEW_H
+#define _ACTION_PREVIEW_H
+
+#include "architecture.h"
+
+// 行動預覽：在局面的複本（clone_game）上套用選擇，比較前後的生命、防禦、能量與位置
+// 選技能卡時一併套用組合計畫中搭配的基本牌（沒有計畫時用第一張可搭配的牌），讓預覽顯示實際效果
+// 回合結束的抽牌使用目前亂數的複本，因此與確認後的結果相同，且不影響實際對局的亂數
+
+typedef struct {
+    int32_t life;
+    int32_t defense;
+    int32_t energy;
+    int32_t position;
+} PreviewPlayer;
+
+typedef struct {
+    int32_t choice;
+    int32_t partnerChoice;      // 一併套用的 USEBASIC 選擇，沒有則為 0
+    PreviewPlayer before[2];
+    PreviewPlayer after[2];
+    int32_t damage;             // 對手生命與防禦合計減少的量（扣掉防禦後的傷害見 lifeDamage）
+    int32_t lifeDamage;         // 對手生命減少的量
+    int32_t energyGained;       // 行動玩家的能量變化
+    enum state nextStatus;      // 套用後的狀態
+    bool endsTurn;              // 套用後輪到對手
+    int winner;                 // 套用後的勝利玩家，尚未分出勝負為 -1
+} ActionPreview;
+
+// 不合法的選擇回傳 false；gameState 與目前的亂數都不會改變
+bool preview_choice(game* gameState, int32_t choice, ActionPreview* preview);
+
+// 預覽是否有任何可見的效果（生命、防禦、能量、位置改變或分出勝負）
+bool preview_has_effect(const ActionPreview* preview);
+
+#endif // _ACTION_PREVIEW_H
@@ -0,0 +1,328 @@
+#include <pthread.h>
+#include "bot.h"
+#include "card_system.h"
+#include "combo_solver.h"
+#include "game_state.h"
+#include "nn_eval.h"
+#include "opening_book.h"
+#include "purchase_advisor.h"
+#include "search.h"
+
+static int32_t random_choose(void *ctx, game *gs, vector *choices, RngState *rng)
+{
+    (void)ctx;
+    (void)gs;
+    return choices->array[rng_bounded(rng, choices->SIZE)];
+}
+
+static int32_t hand_card(game *gs, int32_t choice)
+{
+    player *p = &gs->players[gs->now_turn_player_id];
+    if (choice < 1 || (uint32_t)choice > p->hand.SIZE)
+        return 0;
+    return p->hand.array[choice - 1];
+}
+
+// 組合計畫中是否有 skillCard 的組合（basicCard 不為 0 時須搭配這張牌，skillCard 為 0 時任何組合都算）
+// 以卡牌編號比較：同一種牌只有第一張會列在選擇中
+static bool plan_has_pair(game *gs, const ComboPlan *plan, int32_t skillCard, int32_t basicCard)
+{
+    vector *hand = &gs->players[gs->now_turn_player_id].hand;
+    for (uint32_t i = 0; plan != NULL && i < plan->count; i++)
+    {
+        const ComboPlay *play = &plan->plays[i];
+        if (play->skill < 0)
+            continue;
+        if ((skillCard == 0 || hand->array[play->skill] == skillCard) &&
+            (basicCard == 0 || hand->array[play->basic] == basicCard))
+            return true;
+    }
+    return false;
+}
+
+// 行動選擇與選技能卡時依攻擊的組合計畫，選基本牌時依技能卡類型的計畫
+static bool greedy_combo_plan(game *gs, ComboPlan *plan)
+{
+    switch (gs->status)
+    {
+    case CHOOSE_MOVE:
+    case USE_SKILL:
+        plan_combo(gs, COMBO_GOAL_ATTACK, plan);
+        return true;
+    case USEBASIC:
+        plan_combo(gs, (ComboGoal)(get_card_type(gs->nowUsingCardID) - CARD_TYPE_SKILL_ATK), plan);
+        return true;
+    default:
+        return false;
+    }
+}
+
+// 貪婪策略的選擇分數：越高越優先
+// 有組合計畫時先用技能卡，並依計畫搭配基本牌（例如技能卡搭配通用牌，高數值的攻擊牌留著單獨打出換能量）
+static int32_t greedy_score(game *gs, int32_t choice, const ComboPlan *plan)
+{
+    player *me = &gs->players[gs->now_turn_player_id];
+    player *opp = &gs->players[(gs->now_turn_player_id + 1) % 2];
+    bool inRange = check_attack_range(gs, gs->now_turn_player_id, (gs->now_turn_player_id + 1) % 2);
+
+    switch (gs->status)
+    {
+    case CHOOSE_MOVE:
+        switch (choice)
+        {
+        case 1:
+            return 100;
+        case 4:
+            return plan_has_pair(gs, plan, 0, 0) ? 110 : 90;
+        case 3:
+            return inRange ? 10 : 80;
+        case 2:
+            return me->defense < me->maxdefense ? 50 : 5;
+        case 6:
+            return 40;
+        case 0:
+            return 2;
+        default:
+            return 1;
+        }
+
+    case USE_ATK:
+        return choice == 0 ? 0 : get_card_value(hand_card(gs, choice));
+
+    case USE_SKILL:
+        return get_card_value(hand_card(gs, choice)) + (plan_has_pair(gs, plan, hand_card(gs, choice), 0) ? 100 : 0);
+
+    case USEBASIC:
+        return get_card_value(hand_card(gs, choice)) +
+               (plan_has_pair(gs, plan, gs->nowUsingCardID, hand_card(gs, choice)) ? 100 : 0);
+
+    case USE_DEF:
+        if (choice == 0)
+            return me->defense < me->maxdefense ? 0 : 100;
+        return get_card_value(hand_card(gs, choice));
+
+    case USE_MOV:
+        if (choice == 0)
+            return inRange ? 100 : 0;
+        return get_card_value(hand_card(gs, choice));
+
+    case CHOOSE_MOVING_DIR:
+        // 朝對手方向移動
+        return (choice == 1) == (opp->locate[0] > me->locate[0]) ? 1 : 0;
+
+    case BUY_CARD_TYPE:
+        // 技能優先，其次高等級攻擊牌
+        if (choice < 0)
+            return 20 - choice;
+        if (choice <= 3)
+            return 10 + choice;
+        return choice == 10 ? 1 : 5;
+
+    case REMOVE_HG:
+    {
+        // 移除數值最低的牌
+        int32_t cardId = choice > 0 ? me->hand.array[choice - 1]
+                         : choice < 0 ? me->graveyard.array[-choice - 1]
+                                      : 0;
+        return -get_card_value(cardId);
+    }
+
+    default:
+        return 0;
+    }
+}
+
+static int32_t greedy_choose(void *ctx, game *gs, vector *choices, RngState *rng)
+{
+    (void)ctx;
+    int32_t best = choices->array[0];
+    int32_t bestScore = INT32_MIN;
+    uint32_t ties = 0;
+    ComboPlan plan;
+    bool hasPlan = greedy_combo_plan(gs, &plan);
+
+    for (uint32_t i = 0; i < choices->SIZE; i++)
+    {
+        int32_t score = greedy_score(gs, choices->array[i], hasPlan ? &plan : NULL);
+        if (score > bestScore)
+        {
+            best = choices->array[i];
+            bestScore = score;
+            ties = 1;
+        }
+        else if (score == bestScore && rng_bounded(rng, ++ties) == 0)
+        {
+            // 同分時隨機挑選（水庫抽樣）
+            best = choices->array[i];
+        }
+    }
+    return best;
+}
+
+// 購買時依 rollout 建議選擇，其他狀態與 greedy 相同
+// 在平行模擬中使用，建議本身只用目前執行緒
+static const AdvisorConfig advisorBotConfig = {16, 0, 4, NULL, 0, 1};
+
+static int32_t advisor_choose(void *ctx, game *gs, vector *choices, RngState *rng)
+{
+    if (gs->status != BUY_CARD_TYPE || choices->SIZE == 1)
+        return greedy_choose(NULL, gs, choices, rng);
+
+    AdvisorConfig config = *(const AdvisorConfig *)ctx;
+    config.seed = (uint64_t)rng_next(rng) << 32;
+    config.seed |= rng_next(rng);
+    PurchaseAdvice advice;
+    if (!advise_purchase(&config, gs, &advice))
+        return greedy_choose(NULL, gs, choices, rng);
+    return advice.options[0].choice;
+}
+
+static const OpeningBook *openingBook = NULL;
+
+void set_bot_opening_book(const OpeningBook *book)
+{
+    openingBook = book;
+}
+
+static int32_t search_bot_choose(void *ctx, game *gs, vector *choices, RngState *rng)
+{
+    int32_t choice;
+    if (book_lookup(openingBook, gs, choices, &choice))
+        return choice;
+
+    SearchResult result;
+    return search_choose(ctx, gs, choices, rng, &result);
+}
+
+// 預設搜尋設定（深度 3、4000 節點），只用節點限制因此結果可重現
+static SearchConfig searchBotConfig = {3, 0, 4000, 2, evaluate_game, NULL, NULL, NULL};
+
+// 所有執行緒共用一個置換表，第一次使用時才配置
+static TranspositionTable sharedTable;
+static pthread_once_t sharedTableOnce = PTHREAD_ONCE_INIT;
+static SearchConfig searchTableBotConfig = {3, 0, 4000, 2, evaluate_game, NULL, &sharedTable, NULL};
+
+static void init_shared_table(void)
+{
+    tt_init(&sharedTable, TT_DEFAULT_MEGABYTES);
+}
+
+static int32_t search_table_bot_choose(void *ctx, game *gs, vector *choices, RngState *rng)
+{
+    pthread_once(&sharedTableOnce, init_shared_table);
+    return search_bot_choose(ctx, gs, choices, rng);
+}
+
+// 神經網路評估的搜尋設定，未設定網路時與 search 相同
+static SearchConfig searchNnBotConfig = {3, 0, 4000, 2, evaluate_game, NULL, NULL, NULL};
+
+void set_bot_nn_model(const NnModel *model)
+{
+    searchNnBotConfig.eval = model != NULL ? nn_evaluate_game : evaluate_game;
+    searchNnBotConfig.evalCtx = model != NULL ? (void *)model : searchBotConfig.evalCtx;
+}
+
+void set_bot_eval_weights(const EvalWeights *weights)
+{
+    searchBotConfig.evalCtx = (void *)weights;
+    searchTableBotConfig.evalCtx = (void *)weights;
+    if (searchNnBotConfig.eval == evaluate_game)
+        searchNnBotConfig.evalCtx = (void *)weights;
+}
+
+static uint64_t fingerprint_search(uint64_t h, const SearchConfig *config)
+{
+    h = rng_mix64(h ^ (uint64_t)config->maxDepth);
+    h = rng_mix64(h ^ config->timeLimitMs);
+    h = rng_mix64(h ^ config->nodeLimit);
+    h = rng_mix64(h ^ (uint64_t)config->chanceSamples);
+    h = rng_mix64(h ^ (config->eval == nn_evaluate_game));
+    // 權重以內容比對；神經網路的內容由載入的檔案比對
+    if (config->eval == evaluate_game && config->evalCtx != NULL)
+    {
+        EvalWeights *weights = config->evalCtx;
+        for (int i = 0; i < EVAL_WEIGHT_COUNT; i++)
+            h = rng_mix64(h ^ (uint64_t)*eval_weight_at(weights, i));
+    }
+    return h;
+}
+
+uint64_t bot_settings_fingerprint(void)
+{
+    uint64_t h = fingerprint_search(0, &searchBotConfig);
+    h = fingerprint_search(h, &searchTableBotConfig);
+    return fingerprint_search(h, &searchNnBotConfig);
+}
+
+static const BotPolicy botPolicies[] = {
+    {"random", "Uniformly random legal choice", random_choose, NULL},
+    {"greedy", "Attack first, then skills, move toward the opponent", greedy_choose, NULL},
+    {"advisor", "Greedy, but buys by rollouts (16 per option, 4 turns)", advisor_choose, (void *)&advisorBotConfig},
+    {"search", "Expectimax / alpha-beta search, depth 3, 4000 nodes", search_bot_choose, &searchBotConfig},
+    {"search-tt", "Search bot sharing one transposition table across threads", search_table_bot_choose,
+     &searchTableBotConfig},
+    {"search-nn", "Search bot using the neural-network evaluator (--nn FILE)", search_bot_choose,
+     &searchNnBotConfig},
+};
+
+const BotPolicy *find_bot_policy(const char *name)
+{
+    for (int i = 0; i < get_bot_policy_count(); i++)
+    {
+        if (strcmp(get_bot_policy(i)->name, name) == 0)
+            return get_bot_policy(i);
+    }
+    return NULL;
+}
+
+// 執行時註冊的策略（外掛），排在內建策略之後
+static const BotPolicy *registeredPolicies[BOT_MAX_REGISTERED];
+static int registeredCount = 0;
+
+bool register_bot_policy(const BotPolicy *policy)
+{
+    if (registeredCount == BOT_MAX_REGISTERED || find_bot_policy(policy->name) != NULL)
+        return false;
+    registeredPolicies[registeredCount++] = policy;
+    return true;
+}
+
+void unregister_bot_policy(const BotPolicy *policy)
+{
+    for (int i = 0; i < registeredCount; i++)
+    {
+        if (registeredPolicies[i] == policy)
+        {
+            memmove(&registeredPolicies[i], &registeredPolicies[i + 1],
+                    (size_t)(registeredCount - i - 1) * sizeof(BotPolicy *));
+            registeredCount--;
+            return;
+        }
+    }
+}
+
+static int builtin_policy_count(void)
+{
+    return (int)(sizeof(botPolicies) / sizeof(BotPolicy));
+}
+
+int get_bot_policy_count(void)
+{
+    return builtin_policy_count() + registeredCount;
+}
+
+const BotPolicy *get_bot_policy(int index)
+{
+    if (index < 0 || index >= get_bot_policy_count())
+        return NULL;
+    if (index < builtin_policy_count())
+        return &botPolicies[index];
+    return registeredPolicies[index - builtin_policy_count()];
+}
+
+int32_t bot_choose(const BotPolicy *bot, game *gs, vector *choices, RngState *rng)
+{
+    if (choices->SIZE == 0)
+        return 0;
+    return bot->choose(bot->ctx, gs, choices, rng);
+}
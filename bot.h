@@ -0,0 +1,53 @@
+#ifndef _BOT_H
+#define _BOT_H
+
+#include "architecture.h"
+#include "rng.h"
+
+// 電腦玩家的選擇函數：從 choices（由 get_legal_choices 產生）中回傳一個選擇
+typedef int32_t (*BotChooseFn)(void* ctx, game* gameState, vector* choices, RngState* rng);
+
+// 電腦玩家策略
+typedef struct {
+    const char* name;         // 策略名稱（命令列使用）
+    const char* description;  // 說明
+    BotChooseFn choose;       // 選擇函數
+    void* ctx;                // 策略自身的設定資料
+} BotPolicy;
+
+// 依名稱尋找策略，找不到時回傳 NULL
+const BotPolicy* find_bot_policy(const char* name);
+
+// 列舉所有已註冊的策略
+int get_bot_policy_count(void);
+const BotPolicy* get_bot_policy(int index);
+
+// 執行時註冊的策略（外掛）上限
+#define BOT_MAX_REGISTERED 16
+
+// 註冊策略（policy 需在移除前保持有效）；名稱重複或已滿時回傳 false
+// 需在開始模擬前註冊或移除
+bool register_bot_policy(const BotPolicy* policy);
+void unregister_bot_policy(const BotPolicy* policy);
+
+// 搜尋類策略（search、search-tt）在開局庫有收錄的局面直接使用開局庫的選擇
+// NULL 表示不使用；需在開始模擬前設定
+struct OpeningBook;
+void set_bot_opening_book(const struct OpeningBook* book);
+
+// search-nn 策略使用的神經網路（NULL 時改用預設評估函數）；需在開始模擬前設定
+struct NnModel;
+void set_bot_nn_model(const struct NnModel* model);
+
+// search、search-tt 策略（以及未設定網路的 search-nn）使用的評估權重（NULL 表示預設權重）
+// 需在開始模擬前設定
+struct EvalWeights;
+void set_bot_eval_weights(const struct EvalWeights* weights);
+
+// 內建策略目前設定（搜尋深度與節點數、評估權重、是否使用神經網路）的指紋，供 checkpoint 比對
+uint64_t bot_settings_fingerprint(void);
+
+// 讓策略做出選擇（choices 為空時回傳 0）
+int32_t bot_choose(const BotPolicy* bot, game* gameState, vector* choices, RngState* rng);
+
+#endif // _BOT_H
@@ -0,0 +1,83 @@
+#ifndef _BOT_PLUGIN_H
+#define _BOT_PLUGIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 電腦玩家外掛的 C ABI（外掛作者只需要這個標頭檔）
+// 外掛為共享函式庫（gcc -shared -fPIC），匯出 TF_PLUGIN_ENTRY 函數，回傳描述外掛的 TfBotPlugin
+// 模擬工具以 --plugin FILE[:ARGS] 載入，之後以外掛的名稱當作策略名稱使用（例如 --bots NAME greedy）
+//
+// 規則：
+// - 所有指標指向的內容都是唯讀的，只在 choose 呼叫期間有效
+// - choose 可能同時被多個執行緒呼叫（同一個 instance），外掛需自行保證執行緒安全
+// - 選擇的編碼與 architecture.h 的狀態說明表相同；回傳值必須是 choices 之一，否則改用 choices[0]
+// - 需要亂數時使用 random（由主程式的亂數串流產生，結果可重現）
+// - 結構只會在尾端新增欄位，新增時 TF_PLUGIN_ABI_VERSION 不變、size 變大；移除或改變欄位時版本加一
+// - TfGameView 與 TfBotPlugin 的第一個欄位都是 size（寫入方的 sizeof）；讀取尾端新增的欄位前先以 TF_HAS_MEMBER 檢查
+
+#define TF_PLUGIN_ABI_VERSION 2
+#define TF_PLUGIN_ENTRY "tf_bot_plugin"
+
+// 結構 s（第一個欄位為 size）是否包含欄位 member
+#define TF_HAS_MEMBER(type, s, member) ((s)->size >= offsetof(type, member) + sizeof((s)->member))
+
+// TfBotPlugin.flags
+#define TF_PLUGIN_WANTS_FEATURES 0x1u  // 每次 choose 提供 game_features 的特徵
+
+typedef struct {
+    const int32_t* cards;  // 卡牌ID
+    uint32_t count;
+} TfCardList;
+
+typedef struct {
+    int32_t character;     // CharacterID
+    int32_t life;
+    int32_t maxLife;
+    int32_t defense;
+    int32_t maxDefense;
+    int32_t energy;
+    int32_t specialGate;
+    int32_t position;      // 1~9
+    TfCardList hand;
+    TfCardList deck;       // 依抽牌順序，外掛不應依賴（實際對局中看不到）
+    TfCardList graveyard;
+    TfCardList usecards;   // 本回合打出的牌
+    TfCardList metamorphosis;
+} TfPlayerView;
+
+typedef struct {
+    uint32_t size;          // sizeof(TfGameView)（主程式的版本）
+    int32_t self;           // 輪到選擇的玩家（0/1）
+    int32_t status;         // architecture.h 的 enum state
+    int32_t nowAtk;
+    int32_t nowDef;
+    int32_t nowMov;
+    int32_t nowUsingCardId;
+    TfCardList showingCards;  // CHOOSECARDS 時可選的卡牌
+    TfPlayerView players[2];
+    const int8_t* features;   // 以 self 為自己的特徵（TF_PLUGIN_WANTS_FEATURES 時才有，否則為 NULL）
+    uint32_t featureCount;
+    const void* engine;       // 主程式的 const game*，不在 ABI 保證範圍內
+} TfGameView;
+
+typedef struct {
+    uint32_t size;            // sizeof(TfBotPlugin)（外掛編譯時的版本）
+    uint32_t abiVersion;      // TF_PLUGIN_ABI_VERSION
+    uint32_t flags;
+    const char* name;         // 策略名稱（不可與內建策略重複）
+    const char* description;
+    // 建立實例，args 為 --plugin FILE:ARGS 的 ARGS（沒有時為空字串）；失敗時回傳 NULL
+    void* (*create)(const char* args);
+    int32_t (*choose)(void* instance, const TfGameView* view, const int32_t* choices, uint32_t choiceCount,
+                      uint64_t random);
+    void (*destroy)(void* instance);
+    // 之後新增的欄位加在這裡，主程式以 TF_HAS_MEMBER 確認外掛的結構夠長才讀取
+} TfBotPlugin;
+
+// 版本 2 的外掛至少要有到 destroy 為止的欄位
+#define TF_PLUGIN_MIN_SIZE (offsetof(TfBotPlugin, destroy) + sizeof(((TfBotPlugin*)0)->destroy))
+
+typedef const TfBotPlugin* (*TfBotPluginEntry)(void);
+
+#endif // _BOT_PLUGIN_H
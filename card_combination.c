@@ -1,6 +1,45 @@
+#include <pthread.h>
 #include "card_combination.h"
 #include "debug_log.h"
 
+#define COMBINE_WORDS ((CARD_ID_COUNT + 63) / 64)
+
+// combineMatrix[skill] 的第 basic 位元表示兩張牌可以組合
+static uint64_t combineMatrix[CARD_ID_COUNT][COMBINE_WORDS];
+static pthread_once_t combineMatrixOnce = PTHREAD_ONCE_INIT;
+
+static bool combine_rule(int32_t skillCard, int32_t basicCard) {
+    CardType skillType = get_card_type(skillCard);
+    if (skillType < CARD_TYPE_SKILL_ATK || skillType > CARD_TYPE_SKILL_MOV) {
+        return false;
+    }
+    CardType basicType = get_card_type(basicCard);
+    if (!skill_needs_basic_card(skillCard)) {
+        return true;
+    }
+    return basicType == get_required_basic_card_type(skillCard) || basicType == CARD_TYPE_BASIC_GENERAL;
+}
+
+static void init_combine_matrix(void) {
+    for (int32_t skill = 0; skill < CARD_ID_COUNT; skill++) {
+        for (int32_t basic = 0; basic < CARD_ID_COUNT; basic++) {
+            if (combine_rule(skill, basic)) {
+                combineMatrix[skill][basic / 64] |= (uint64_t)1 << (basic % 64);
+            }
+        }
+    }
+}
+
+bool cards_can_combine(int32_t skillCard, int32_t basicCard) {
+    if (skillCard < 0 || skillCard > CARD_ID_MAX || basicCard < 0 || basicCard > CARD_ID_MAX) {
+        return combine_rule(skillCard, basicCard);
+    }
+    pthread_once(&combineMatrixOnce, init_combine_matrix);
+    // 類型相容由矩陣判斷；等級需求來自 card_db，可能在執行時改變，所以不放進矩陣
+    return ((combineMatrix[skillCard][basicCard / 64] >> (basicCard % 64)) & 1) &&
+           (int32_t)get_card_level(basicCard) + 1 >= get_card_requirement(skillCard);
+}
+
 bool check_card_combination(game* gameState, int32_t card1, int32_t card2) {
     (void)gameState;  // 標記參數為有意未使用
     DEBUG_LOG("檢查卡牌組合：%d 和 %d", card1, card2);
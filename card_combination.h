@@ -15,6 +15,11 @@ typedef struct {
 // 檢查卡牌組合是否有效
 bool check_card_combination(game* gameState, int32_t card1, int32_t card2);
 
+// 技能卡與基本卡能否組合（與 check_card_combination 規則相同，但不寫日誌）
+// 卡牌 0..CARD_ID_MAX 查預先計算的相容位元矩陣，出牌選擇與組合求解每個決策都會呼叫
+// 另外要求基本牌等級不低於技能牌在 card_db 中的搭配需求
+bool cards_can_combine(int32_t skillCard, int32_t basicCard);
+
 // 處理卡牌組合效果
 void apply_card_combination(game* gameState, int32_t card1, int32_t card2);
 
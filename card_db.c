@@ -0,0 +1,283 @@
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "card_db.h"
+#include "card_table.h"
+#include "debug_log.h"
+
+// 檔案中每個數值的上限（避免購買花費、能量等欄位溢位）
+#define CARD_DB_MAX_STAT 99
+
+// 預設值：基本牌與技能牌的花費等於等級，攻擊類的牌（含通用牌）射程為 1，沒有搭配需求
+#define CARD_DEFAULT_COST(kind, level) ((kind) == CARD_KIND_BASIC || (kind) == CARD_KIND_SKILL ? (level) : 0)
+#define CARD_DEFAULT_RANGE(type)                                                                          \
+    ((type) == CARD_TYPE_BASIC_ATK || (type) == CARD_TYPE_BASIC_GENERAL || (type) == CARD_TYPE_SKILL_ATK \
+         ? 1                                                                                              \
+         : 0)
+#define CARD_DB_DEFAULT_ENTRY(id, type, kind, level, value, character, name) \
+    [id] = {value, CARD_DEFAULT_COST(kind, level), CARD_DEFAULT_RANGE(type), 0},
+
+static const CardStats defaultStats[CARD_ID_COUNT] = {CARD_TABLE(CARD_DB_DEFAULT_ENTRY)};
+static const CardStats noStats;
+
+static _Atomic(const CardStats *) activeStats = defaultStats;
+
+// 載入過的對應：目前的資料表，以及仍有對局持有快照的舊資料表，新的在前
+typedef struct CardDbMapping {
+    void *map;
+    size_t size;
+    const CardStats *stats;
+    int refs;  // 持有這個對應作為快照的對局數
+    struct CardDbMapping *previous;
+} CardDbMapping;
+
+// 以下欄位由 dbLock 保護
+static pthread_mutex_t dbLock = PTHREAD_MUTEX_INITIALIZER;
+static CardDbMapping *mappings;
+static CardDbMapping *activeMapping;  // NULL 表示使用預設值
+static char watchedPath[1024];
+static struct stat watchedStat;
+
+// 這個執行緒目前對局的快照，巢狀取得時只在最外層切換
+static _Thread_local const CardStats *snapshotStats;
+static _Thread_local CardDbMapping *snapshotMapping;
+static _Thread_local int snapshotDepth;
+
+static atomic_llong nextPollMs;
+
+static long long monotonic_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static bool same_file(const struct stat *a, const struct stat *b)
+{
+    return a->st_dev == b->st_dev && a->st_ino == b->st_ino && a->st_size == b->st_size &&
+           a->st_mtim.tv_sec == b->st_mtim.tv_sec && a->st_mtim.tv_nsec == b->st_mtim.tv_nsec;
+}
+
+static bool valid_stats(const CardStats *stats)
+{
+    for (int id = 0; id < CARD_ID_COUNT; id++)
+    {
+        const CardStats *s = &stats[id];
+        if (s->value < 0 || s->value > CARD_DB_MAX_STAT || s->cost < 0 || s->cost > CARD_DB_MAX_STAT ||
+            s->range < 0 || s->range > CARD_DB_MAX_STAT || s->requirement < 0 || s->requirement > 3)
+            return false;
+    }
+    return true;
+}
+
+// 解除已被取代且沒有快照持有的對應（呼叫前需持有 dbLock）
+static void release_unused_locked(void)
+{
+    CardDbMapping **link = &mappings;
+    while (*link != NULL)
+    {
+        CardDbMapping *mapping = *link;
+        if (mapping == activeMapping || mapping->refs > 0)
+        {
+            link = &mapping->previous;
+            continue;
+        }
+        *link = mapping->previous;
+        munmap(mapping->map, mapping->size);
+        free(mapping);
+    }
+}
+
+// 對應並驗證檔案，成功時切換目前的資料表（呼叫前需持有 dbLock）
+static bool load_locked(const char *path, struct stat *st)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        ERROR_LOG("Cannot open card database %s", path);
+        return false;
+    }
+    if (fstat(fd, st) != 0 || (size_t)st->st_size != sizeof(CardDbHeader) + CARD_ID_COUNT * sizeof(CardStats))
+    {
+        ERROR_LOG("Card database %s has the wrong size", path);
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, (size_t)st->st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    CardDbMapping *mapping = map == MAP_FAILED ? NULL : malloc(sizeof(CardDbMapping));
+    if (mapping == NULL)
+    {
+        ERROR_LOG("Cannot mmap card database %s", path);
+        if (map != MAP_FAILED)
+            munmap(map, (size_t)st->st_size);
+        return false;
+    }
+
+    const CardDbHeader *header = map;
+    const CardStats *stats = (const CardStats *)(header + 1);
+    if (memcmp(header->magic, CARD_DB_MAGIC, 4) != 0 || header->version != CARD_DB_VERSION ||
+        header->cardCount != CARD_ID_COUNT || header->recordSize != sizeof(CardStats) || !valid_stats(stats))
+    {
+        ERROR_LOG("Invalid card database %s", path);
+        munmap(map, (size_t)st->st_size);
+        free(mapping);
+        return false;
+    }
+
+    mapping->map = map;
+    mapping->size = (size_t)st->st_size;
+    mapping->stats = stats;
+    mapping->refs = 0;
+    mapping->previous = mappings;
+    mappings = mapping;
+    activeMapping = mapping;
+    atomic_store_explicit(&activeStats, stats, memory_order_release);
+    release_unused_locked();
+    INFO_LOG("Loaded card database %s", path);
+    return true;
+}
+
+const CardStats *card_db_defaults(void)
+{
+    return defaultStats;
+}
+
+const CardStats *card_db_get(int32_t cardId)
+{
+    if (cardId < 0 || cardId > CARD_ID_MAX)
+        return &noStats;
+    if (snapshotStats != NULL)
+        return &snapshotStats[cardId];
+    return &atomic_load_explicit(&activeStats, memory_order_acquire)[cardId];
+}
+
+void card_db_acquire(void)
+{
+    if (snapshotDepth++ > 0)
+        return;
+    pthread_mutex_lock(&dbLock);
+    snapshotMapping = activeMapping;
+    if (snapshotMapping != NULL)
+        snapshotMapping->refs++;
+    snapshotStats = snapshotMapping != NULL ? snapshotMapping->stats : defaultStats;
+    pthread_mutex_unlock(&dbLock);
+}
+
+void card_db_release(void)
+{
+    if (snapshotDepth == 0 || --snapshotDepth > 0)
+        return;
+    pthread_mutex_lock(&dbLock);
+    if (snapshotMapping != NULL)
+    {
+        snapshotMapping->refs--;
+        release_unused_locked();
+    }
+    pthread_mutex_unlock(&dbLock);
+    snapshotMapping = NULL;
+    snapshotStats = NULL;
+}
+
+int card_db_mapping_count(void)
+{
+    int count = 0;
+    pthread_mutex_lock(&dbLock);
+    for (const CardDbMapping *mapping = mappings; mapping != NULL; mapping = mapping->previous)
+        count++;
+    pthread_mutex_unlock(&dbLock);
+    return count;
+}
+
+bool card_db_load(const char *path)
+{
+    if (strlen(path) >= sizeof(watchedPath))
+        return false;
+
+    pthread_mutex_lock(&dbLock);
+    struct stat st;
+    bool ok = load_locked(path, &st);
+    if (ok)
+    {
+        snprintf(watchedPath, sizeof(watchedPath), "%s", path);
+        watchedStat = st;
+        atomic_store(&nextPollMs, monotonic_ms() + CARD_DB_POLL_INTERVAL_MS);
+    }
+    pthread_mutex_unlock(&dbLock);
+    return ok;
+}
+
+bool card_db_poll(void)
+{
+    long long now = monotonic_ms();
+    if (now < atomic_load(&nextPollMs) || pthread_mutex_trylock(&dbLock) != 0)
+        return false;
+
+    bool reloaded = false;
+    struct stat st;
+    atomic_store(&nextPollMs, now + CARD_DB_POLL_INTERVAL_MS);
+    if (watchedPath[0] != '\0' && stat(watchedPath, &st) == 0 && !same_file(&st, &watchedStat))
+    {
+        // 不合法的檔案也記下來，檔案再次變更前不重複嘗試
+        watchedStat = st;
+        reloaded = load_locked(watchedPath, &st);
+    }
+    pthread_mutex_unlock(&dbLock);
+    return reloaded;
+}
+
+void card_db_reset(void)
+{
+    pthread_mutex_lock(&dbLock);
+    atomic_store_explicit(&activeStats, defaultStats, memory_order_release);
+    activeMapping = NULL;
+    release_unused_locked();
+    watchedPath[0] = '\0';
+    memset(&watchedStat, 0, sizeof(watchedStat));
+    pthread_mutex_unlock(&dbLock);
+}
+
+bool card_db_write(const char *path, const CardStats stats[CARD_ID_COUNT])
+{
+    if (!valid_stats(stats))
+    {
+        ERROR_LOG("Refusing to write invalid card database %s", path);
+        return false;
+    }
+
+    char tmpPath[1024];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    FILE *fp = fopen(tmpPath, "wb");
+    if (fp == NULL)
+    {
+        ERROR_LOG("Cannot open card database file %s", tmpPath);
+        return false;
+    }
+
+    CardDbHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CARD_DB_MAGIC, 4);
+    header.version = CARD_DB_VERSION;
+    header.cardCount = CARD_ID_COUNT;
+    header.recordSize = sizeof(CardStats);
+
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+              fwrite(stats, sizeof(CardStats), CARD_ID_COUNT, fp) == CARD_ID_COUNT && fflush(fp) == 0 &&
+              fsync(fileno(fp)) == 0;
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmpPath, path) != 0)
+    {
+        ERROR_LOG("Cannot write card database file %s", path);
+        remove(tmpPath);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef _CARD_DB_H
+#define _CARD_DB_H
+
+#include "architecture.h"
+#include "card_system.h"
+
+// 卡牌數值資料庫：平衡實驗用的數值（牌值、購買花費、射程、搭配需求）可從二進位檔載入，不必重新編譯
+// 檔案 = header + CardStats[CARD_ID_COUNT]（以卡牌ID索引，0 號不使用），以 mmap 唯讀開啟
+// 沒有載入檔案時使用編譯時的預設值（由 card_spec.tsv 產生）
+// 重新載入時先驗證新檔案，再以原子操作切換目前的資料表
+// 對局以 card_db_acquire / card_db_release 持有快照，整局使用同一份數值（sim_play_game 每局開始時取得）
+// 舊的對應在沒有快照持有後解除；其他執行緒可能重新載入時，查詢的執行緒必須持有快照
+// 修改檔案請先寫暫存檔再改名（card_db_write 就是這樣做），直接覆寫正在使用的檔案會被其他執行緒看到寫到一半的內容
+// 數值以產生檔案的機器的位元組順序保存
+
+#define CARD_DB_MAGIC "TFCD"
+#define CARD_DB_VERSION 1
+
+// 檢查檔案是否變更的最短間隔
+#define CARD_DB_POLL_INTERVAL_MS 100
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t cardCount;   // CARD_ID_COUNT
+    uint32_t recordSize;  // sizeof(CardStats)
+} CardDbHeader;
+
+typedef struct {
+    int32_t value;        // 牌值（攻擊/防禦/移動量、基本牌換得的能量）
+    int32_t cost;         // 購買花費，不能購買的牌為 0
+    int32_t range;        // 當作攻擊使用時的射程，其他牌為 0
+    int32_t requirement;  // 技能牌需要搭配的基本牌最低等級（通用牌視為 LV1），0 表示沒有限制
+} CardStats;
+
+// 編譯時的預設數值
+const CardStats* card_db_defaults(void);
+
+// 目前使用中的數值，未知卡牌回傳全為 0 的資料
+const CardStats* card_db_get(int32_t cardId);
+
+// 這個執行緒之後的查詢固定使用目前的資料表，直到 card_db_release；可以巢狀呼叫
+void card_db_acquire(void);
+void card_db_release(void);
+
+// 目前保留的對應數（使用中的加上仍有快照持有的舊對應），測試用
+int card_db_mapping_count(void);
+
+// 以 mmap 載入資料庫並切換成目前的資料表；檔案不合法時保留原本的資料表並回傳 false
+// 載入成功後會記住路徑，供 card_db_poll 檢查變更
+bool card_db_load(const char* path);
+
+// 距離上次檢查超過 CARD_DB_POLL_INTERVAL_MS 且檔案變更（inode、大小或修改時間不同）時重新載入
+// 有重新載入時回傳 true；可在多個執行緒同時呼叫，同一時間只有一個執行緒檢查
+bool card_db_poll(void);
+
+// 回到編譯時的預設值並解除沒有快照持有的對應
+void card_db_reset(void);
+
+// 寫出資料庫檔案（先寫暫存檔再改名，正在 poll 的程式會看到完整的新檔案）
+bool card_db_write(const char* path, const CardStats stats[CARD_ID_COUNT]);
+
+#endif // _CARD_DB_H
@@ -0,0 +1,133 @@
+#include "card_effect.h"
+#include "card_system.h"
+#include "card_table.h"
+#include "debug_log.h"
+#include "game_action.h"
+#include "game_state.h"
+#include "utils.h"
+
+static const EffectInstr effectCode[CARD_EFFECT_CODE_SIZE] = {CARD_EFFECT_CODE};
+
+// 每張牌的程式在 effectCode 中的位移，0 表示沒有程式
+#define CARD_EFFECT_OFFSET_ENTRY(id, offset) [id] = offset,
+static const uint16_t effectOffsets[CARD_ID_COUNT] = {CARD_EFFECT_PROGRAMS(CARD_EFFECT_OFFSET_ENTRY)};
+
+// 基本牌：獲得等同牌值的能量，再依用途攻擊/防禦/移動
+static const EffectInstr basicPrograms[][4] = {
+    [EFFECT_USE_ATTACK] = {{EFFECT_ADD_CARD, 0}, {EFFECT_ENERGY, 0}, {EFFECT_ATTACK, 0}, {EFFECT_END, 0}},
+    [EFFECT_USE_DEFENSE] = {{EFFECT_ADD_CARD, 0}, {EFFECT_ENERGY, 0}, {EFFECT_DEFENSE, 0}, {EFFECT_END, 0}},
+    [EFFECT_USE_MOVE] = {{EFFECT_ADD_CARD, 0}, {EFFECT_ENERGY, 0}, {EFFECT_MOVE, 0}, {EFFECT_END, 0}},
+};
+
+const EffectInstr *get_card_effect(int32_t cardId)
+{
+    if (cardId < 0 || cardId > CARD_ID_MAX || effectOffsets[cardId] == 0)
+        return NULL;
+    return &effectCode[effectOffsets[cardId]];
+}
+
+// 將對手往遠離自己的方向推開 distance 格
+static void knockback(game *gs, int opponent, int32_t distance)
+{
+    player *self = &gs->players[gs->now_turn_player_id];
+    player *opp = &gs->players[opponent];
+    int target = opp->locate[0] + (opp->locate[0] > self->locate[0] ? distance : -distance);
+
+    if (target < TRACK_MIN)
+        target = TRACK_MIN;
+    if (target > TRACK_MAX)
+        target = TRACK_MAX;
+    opp->locate[0] = (uint8_t)target;
+}
+
+// 從 from 的頂端移動至多 count 張牌到 to
+static void move_top_cards(vector *from, vector *to, int32_t count)
+{
+    for (int32_t i = 0; i < count && from->SIZE > 0; i++)
+    {
+        vector_pushback(to, from->array[from->SIZE - 1]);
+        vector_popback(from);
+    }
+}
+
+bool run_effect_program(game *gs, const EffectInstr *program, int32_t cardId, int32_t basicCard)
+{
+    int opponent = (gs->now_turn_player_id + 1) % 2;
+    player *p = &gs->players[gs->now_turn_player_id];
+    player *opp = &gs->players[opponent];
+    bool move = false;
+    int32_t x = 0;
+
+    // 效果指令的量不會是負數
+    for (const EffectInstr *instr = program;; instr++)
+    {
+        int32_t amount = x > 0 ? x : 0;
+        switch ((EffectOp)instr->op)
+        {
+        case EFFECT_END:
+            return move;
+        case EFFECT_SET:
+            x = instr->arg;
+            break;
+        case EFFECT_ADD:
+            x += instr->arg;
+            break;
+        case EFFECT_ADD_CARD:
+            x += get_card_value(cardId);
+            break;
+        case EFFECT_ADD_BASIC:
+            x += get_card_value(basicCard);
+            break;
+        case EFFECT_ENERGY:
+        {
+            int32_t energy = p->energy + amount;
+            p->energy = (uint8_t)(energy > ENERGY_LIMIT ? ENERGY_LIMIT : energy);
+            break;
+        }
+        case EFFECT_ATTACK:
+            gs->nowATK = instr->arg ? amount : gs->nowATK + amount;
+            gs->totalDamage += amount;
+            apply_damage(gs, opponent, amount);
+            break;
+        case EFFECT_DEFENSE:
+            gs->nowDEF = instr->arg ? amount : gs->nowDEF + amount;
+            apply_defense(gs, gs->now_turn_player_id, amount);
+            break;
+        case EFFECT_MOVE:
+            gs->nowMOV = amount;
+            move = true;
+            break;
+        case EFFECT_KNOCKBACK:
+            knockback(gs, opponent, amount);
+            break;
+        case EFFECT_DRAW:
+            draw_card(p, amount);
+            break;
+        case EFFECT_MILL:
+            move_top_cards(&opp->deck, &opp->graveyard, amount);
+            break;
+        case EFFECT_POISON:
+            move_top_cards(&p->snowWhite.remindPosion, &opp->graveyard, amount);
+            break;
+        default:
+            ERROR_LOG("未知的效果指令：%d", instr->op);
+            return move;
+        }
+    }
+}
+
+bool run_skill_effect(game *gs, int32_t skillCard, int32_t basicCard)
+{
+    const EffectInstr *program = get_card_effect(skillCard);
+    if (program == NULL)
+    {
+        WARN_LOG("卡牌 %d 沒有效果程式", skillCard);
+        return false;
+    }
+    return run_effect_program(gs, program, skillCard, basicCard);
+}
+
+bool run_basic_effect(game *gs, EffectUse use, int32_t cardId)
+{
+    return run_effect_program(gs, basicPrograms[use], cardId, cardId);
+}
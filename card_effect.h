@@ -0,0 +1,64 @@
+#ifndef _CARD_EFFECT_H
+#define _CARD_EFFECT_H
+
+#include "architecture.h"
+
+// 卡牌效果位元組碼：每張技能牌對應一段效果程式（card_spec.tsv 的 effect 欄，建置時由 gen_card_table 組譯）
+// 基本牌依用途（攻擊/防禦/移動）共用三段程式，通用牌也走同一條路徑
+// 程式在單一的 X 暫存器上運算：數值指令累加 X，效果指令以 X 為量作用在局面上；沒有跳躍，依序執行到 end
+//
+// 指令（組合語言名稱）：
+//   end               結束
+//   set N / add N     X = N / X += N
+//   card / basic      X += 打出的牌 / 搭配的基本牌的牌值（基本牌單獨使用時兩者相同）
+//   energy            獲得 X 點能量（上限 ENERGY_LIMIT）
+//   attack M          對對手造成 X 點傷害（先扣防禦）；M = 0 時 X 累加到 nowATK，M = 1 時取代
+//   defense M         獲得 X 點防禦（上限為最大防禦）；M 的意義同上（nowDEF）
+//   move              移動 X 格（nowMOV = X，接著由玩家選方向）
+//   knockback         將對手往遠離自己的方向擊退至多 X 格（不超出軌道）
+//   draw              抽 X 張牌
+//   mill              將對手牌庫頂 X 張牌棄入棄牌堆
+//   poison            將自己中毒牌庫頂部至多 X 張牌放入對手的棄牌堆
+
+typedef enum {
+    EFFECT_END = 0,
+    EFFECT_SET,
+    EFFECT_ADD,
+    EFFECT_ADD_CARD,
+    EFFECT_ADD_BASIC,
+    EFFECT_ENERGY,
+    EFFECT_ATTACK,
+    EFFECT_DEFENSE,
+    EFFECT_MOVE,
+    EFFECT_KNOCKBACK,
+    EFFECT_DRAW,
+    EFFECT_MILL,
+    EFFECT_POISON,
+    EFFECT_OP_COUNT
+} EffectOp;
+
+typedef struct {
+    uint8_t op;   // EffectOp
+    int16_t arg;
+} EffectInstr;
+
+// 基本牌的用途
+typedef enum {
+    EFFECT_USE_ATTACK = 0,
+    EFFECT_USE_DEFENSE,
+    EFFECT_USE_MOVE
+} EffectUse;
+
+// 卡牌的效果程式，沒有程式（必殺、蛻變、中毒/火柴等尚未由引擎打出的牌）時回傳 NULL
+const EffectInstr* get_card_effect(int32_t cardId);
+
+// 目前玩家打出技能牌 skillCard 並搭配 basicCard；回傳 true 表示效果要求移動（接著選方向）
+bool run_skill_effect(game* gameState, int32_t skillCard, int32_t basicCard);
+
+// 目前玩家單獨打出基本牌 cardId 作為 use；回傳值同上
+bool run_basic_effect(game* gameState, EffectUse use, int32_t cardId);
+
+// 以目前玩家執行任意效果程式（測試與新卡牌原型使用）
+bool run_effect_program(game* gameState, const EffectInstr* program, int32_t cardId, int32_t basicCard);
+
+#endif // _CARD_EFFECT_H
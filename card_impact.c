@@ -0,0 +1,268 @@
+#include <pthread.h>
+#include "card_impact.h"
+
+// 基本牌不屬於任何角色，使用最後一組（受測角色輪流）
+#define IMPACT_GROUP_COUNT (CHARACTER_COUNT + 1)
+#define IMPACT_MIXED_GROUP CHARACTER_COUNT
+
+typedef struct {
+    const CardImpactConfig *config;
+    uint64_t chunkCount;           // 每組的區塊數
+    int32_t cards[CARD_ID_MAX];    // 要禁用分析的卡牌
+    uint32_t cardCount;
+    uint8_t *baseline[IMPACT_GROUP_COUNT];  // 有這張牌時每場的得分（勝 2、平 1、負 0）
+    uint64_t uses[IMPACT_GROUP_COUNT][CARD_ID_COUNT];
+    // 成對差統計（以半場為單位，只含整數，合併順序不影響結果）
+    int64_t scoreWith[CARD_ID_COUNT];
+    int64_t scoreWithout[CARD_ID_COUNT];
+    int64_t sumDiffSquared[CARD_ID_COUNT];
+    pthread_mutex_t lock;
+} CardImpactRun;
+
+void init_card_impact_config(CardImpactConfig *config)
+{
+    config->bots[0] = find_bot_policy("greedy");
+    config->bots[1] = find_bot_policy("greedy");
+    config->seed = 1;
+    config->maxTurns = SIM_DEFAULT_MAX_TURNS;
+    config->gamesPerCard = 200;
+    config->threads = 0;
+}
+
+// 只有基本牌與技能牌在起始牌堆或購買區，禁用後才有差別
+static bool card_impact_applicable(int32_t cardId)
+{
+    CardKind kind = get_card_kind(cardId);
+    return kind == CARD_KIND_BASIC || kind == CARD_KIND_SKILL;
+}
+
+static int card_group(int32_t cardId)
+{
+    int8_t owner = get_card_character(cardId);
+    return owner >= 0 ? owner : IMPACT_MIXED_GROUP;
+}
+
+// 第 i 場：對手角色與先後手輪流，基本牌的受測角色也輪流
+static int setup_game(const CardImpactConfig *config, int group, uint64_t i, SimConfig *sim)
+{
+    int focalSeat = (int)((i / CHARACTER_COUNT) % 2);
+    uint8_t focal = group == IMPACT_MIXED_GROUP ? (uint8_t)((i / (2 * CHARACTER_COUNT)) % CHARACTER_COUNT)
+                                                : (uint8_t)group;
+
+    sim_init_config(sim);
+    sim->characters[focalSeat] = focal;
+    sim->characters[1 - focalSeat] = (uint8_t)(i % CHARACTER_COUNT);
+    sim->bots[focalSeat] = config->bots[0];
+    sim->bots[1 - focalSeat] = config->bots[1];
+    sim->seed = config->seed;
+    sim->maxTurns = config->maxTurns;
+    return focalSeat;
+}
+
+static uint8_t focal_score(const SimGameResult *result, int focalSeat)
+{
+    if (result->winner < 0)
+        return 1;
+    return result->winner == focalSeat ? 2 : 0;
+}
+
+static void chunk_range(const CardImpactRun *run, uint64_t chunk, uint64_t *first, uint64_t *last)
+{
+    *first = chunk * SIM_CHUNK_GAMES;
+    *last = *first + SIM_CHUNK_GAMES;
+    if (*last > run->config->gamesPerCard)
+        *last = run->config->gamesPerCard;
+}
+
+// 第一階段：每組打一次完整牌組的對戰，順便統計卡牌使用次數
+static void run_baseline_chunk(void *ctx, size_t task)
+{
+    CardImpactRun *run = ctx;
+    int group = (int)(task / run->chunkCount);
+    uint64_t first, last;
+    chunk_range(run, task % run->chunkCount, &first, &last);
+
+    uint64_t *uses = calloc(CARD_ID_COUNT, sizeof(uint64_t));
+    if (uses == NULL)
+        return;
+
+    for (uint64_t i = first; i < last; i++)
+    {
+        SimConfig sim;
+        SimGameResult result;
+        int focalSeat = setup_game(run->config, group, i, &sim);
+        sim.trackCardUses = true;
+        sim_play_game(&sim, i, &result);
+        run->baseline[group][i] = focal_score(&result, focalSeat);
+        for (int c = 0; c < CARD_ID_COUNT; c++)
+            uses[c] += result.cardUses[focalSeat][c];
+    }
+
+    pthread_mutex_lock(&run->lock);
+    for (int c = 0; c < CARD_ID_COUNT; c++)
+        run->uses[group][c] += uses[c];
+    pthread_mutex_unlock(&run->lock);
+    free(uses);
+}
+
+// 第二階段：同樣的遊戲編號，受測方禁用一張卡牌
+static void run_ban_chunk(void *ctx, size_t task)
+{
+    CardImpactRun *run = ctx;
+    int32_t cardId = run->cards[task / run->chunkCount];
+    int group = card_group(cardId);
+    uint64_t first, last;
+    chunk_range(run, task % run->chunkCount, &first, &last);
+
+    int64_t with = 0, without = 0, diffSquared = 0;
+    for (uint64_t i = first; i < last; i++)
+    {
+        SimConfig sim;
+        SimGameResult result;
+        int focalSeat = setup_game(run->config, group, i, &sim);
+        sim.bannedCard[focalSeat] = cardId;
+        sim_play_game(&sim, i, &result);
+
+        int64_t a = run->baseline[group][i];
+        int64_t b = focal_score(&result, focalSeat);
+        with += a;
+        without += b;
+        diffSquared += (a - b) * (a - b);
+    }
+
+    pthread_mutex_lock(&run->lock);
+    run->scoreWith[cardId] += with;
+    run->scoreWithout[cardId] += without;
+    run->sumDiffSquared[cardId] += diffSquared;
+    pthread_mutex_unlock(&run->lock);
+}
+
+void run_card_impact(const CardImpactConfig *config, CardImpact results[CARD_ID_MAX])
+{
+    CardImpactRun *run = calloc(1, sizeof(CardImpactRun));
+    bool ok = run != NULL;
+    if (ok)
+    {
+        run->config = config;
+        run->chunkCount = (config->gamesPerCard + SIM_CHUNK_GAMES - 1) / SIM_CHUNK_GAMES;
+        pthread_mutex_init(&run->lock, NULL);
+        for (int32_t cardId = 1; cardId <= CARD_ID_MAX; cardId++)
+        {
+            if (card_impact_applicable(cardId))
+                run->cards[run->cardCount++] = cardId;
+        }
+        for (int g = 0; g < IMPACT_GROUP_COUNT; g++)
+        {
+            run->baseline[g] = calloc(config->gamesPerCard > 0 ? config->gamesPerCard : 1, 1);
+            ok = ok && run->baseline[g] != NULL;
+        }
+    }
+
+    if (ok)
+    {
+        sim_parallel_for(IMPACT_GROUP_COUNT * run->chunkCount, config->threads, run_baseline_chunk, run);
+        sim_parallel_for(run->cardCount * run->chunkCount, config->threads, run_ban_chunk, run);
+    }
+
+    double n = (double)config->gamesPerCard;
+    for (int32_t cardId = 1; cardId <= CARD_ID_MAX; cardId++)
+    {
+        CardImpact *result = &results[cardId - 1];
+        int group = card_group(cardId);
+        result->cardId = cardId;
+        result->character = get_card_character(cardId);
+        result->applicable = card_impact_applicable(cardId);
+        result->games = ok && result->applicable ? config->gamesPerCard : 0;
+        if (result->games == 0)
+        {
+            result->winRateWith = result->winRateWithout = result->applicable ? 0.5 : 0;
+            result->impact = result->stdError = result->usesPerGame = 0;
+            continue;
+        }
+
+        // 得分以半場為單位
+        double meanDiff = (double)(run->scoreWith[cardId] - run->scoreWithout[cardId]) / n / 2;
+        double meanDiffSquared = (double)run->sumDiffSquared[cardId] / n / 4;
+        double variance = n > 1 ? (meanDiffSquared - meanDiff * meanDiff) * n / (n - 1) : 0;
+
+        result->winRateWith = (double)run->scoreWith[cardId] / n / 2;
+        result->winRateWithout = (double)run->scoreWithout[cardId] / n / 2;
+        result->impact = meanDiff;
+        result->stdError = variance > 0 ? sqrt(variance / n) : 0;
+        result->usesPerGame = (double)run->uses[group][cardId] / n;
+    }
+
+    if (run == NULL)
+        return;
+    for (int g = 0; g < IMPACT_GROUP_COUNT; g++)
+        free(run->baseline[g]);
+    pthread_mutex_destroy(&run->lock);
+    free(run);
+}
+
+static int compare_impact(const void *a, const void *b)
+{
+    const CardImpact *x = a;
+    const CardImpact *y = b;
+    if (x->applicable != y->applicable)
+        return x->applicable ? -1 : 1;
+    if (x->impact != y->impact)
+        return x->impact < y->impact ? 1 : -1;
+    return x->cardId - y->cardId;
+}
+
+void rank_card_impacts(CardImpact *results, size_t count)
+{
+    qsort(results, count, sizeof(CardImpact), compare_impact);
+}
+
+static const char *impact_character_name(int8_t character)
+{
+    return character >= 0 ? get_character_info((CharacterID)character)->name : "-";
+}
+
+void print_card_impacts(FILE *fp, const CardImpact *results, size_t count)
+{
+    fprintf(fp, "%-5s %-5s %-24s %-14s %8s %8s %8s %8s %6s\n", "rank", "id", "card", "character", "with",
+            "without", "impact", "stderr", "uses");
+    for (size_t i = 0; i < count; i++)
+    {
+        const CardImpact *r = &results[i];
+        if (!r->applicable)
+        {
+            fprintf(fp, "%-5s %-5d %-24s %-14s %8s\n", "-", r->cardId, get_card_name(r->cardId),
+                    impact_character_name(r->character), "n/a");
+            continue;
+        }
+        fprintf(fp, "%-5zu %-5d %-24s %-14s %8.4f %8.4f %+8.4f %8.4f %6.2f\n", i + 1, r->cardId,
+                get_card_name(r->cardId), impact_character_name(r->character), r->winRateWith,
+                r->winRateWithout, r->impact, r->stdError, r->usesPerGame);
+    }
+}
+
+// 禁用這張牌時同一疊技能供應牌庫的 LV3 也買不到（見 card_impact.h）
+static bool impact_includes_lv3(int32_t cardId)
+{
+    return get_card_kind(cardId) == CARD_KIND_SKILL && get_card_level(cardId) == CARD_LEVEL_2;
+}
+
+// 不適用的牌只輸出編號、名稱與角色，數值欄留空
+void write_card_impact_csv(FILE *fp, const CardImpact *results, size_t count)
+{
+    fprintf(fp, "rank,card_id,name,character,applicable,games,win_rate_with,win_rate_without,impact,stderr,"
+                "uses_per_game,includes_lv3\n");
+    for (size_t i = 0; i < count; i++)
+    {
+        const CardImpact *r = &results[i];
+        if (!r->applicable)
+        {
+            fprintf(fp, ",%d,\"%s\",\"%s\",0,,,,,,,\n", r->cardId, get_card_name(r->cardId),
+                    impact_character_name(r->character));
+            continue;
+        }
+        fprintf(fp, "%zu,%d,\"%s\",\"%s\",1,%llu,%.6f,%.6f,%.6f,%.6f,%.4f,%d\n", i + 1, r->cardId,
+                get_card_name(r->cardId), impact_character_name(r->character), (unsigned long long)r->games,
+                r->winRateWith, r->winRateWithout, r->impact, r->stdError, r->usesPerGame,
+                impact_includes_lv3(r->cardId));
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef _CARD_IMPACT_H
+#define _CARD_IMPACT_H
+
+#include "card_system.h"
+#include "character_system.h"
+#include "simulation.h"
+
+// 每張卡牌的影響力分析
+// 受測方在「牌組內有這張牌」與「起始牌堆移除且不能購買」兩種情況下，
+// 以相同的遊戲編號（相同亂數串流）各打一場，比較成對的勝負差
+// 只有基本牌與技能牌能從牌組移除；必殺、蛻變與中毒/火柴等牌不分析，標示為不適用
+// 技能供應牌庫是一疊（下一張購買的是 LV2，之後才是 LV3），禁用 LV2 技能牌時同一疊的 LV3 也買不到，
+// 因此 LV2 技能牌的 impact 包含失去 LV3 的影響，不是 LV2 單張的影響（CSV 的 includes_lv3 欄為 1）
+typedef struct {
+    const BotPolicy* bots[2];  // bots[0] 為受測方，bots[1] 為對手
+    uint64_t seed;
+    uint32_t maxTurns;
+    uint64_t gamesPerCard;     // 每張卡牌的成對場數
+    int threads;               // 0 表示使用全部核心
+} CardImpactConfig;
+
+typedef struct {
+    int32_t cardId;
+    int8_t character;       // 受測角色（CharacterID），基本牌為 -1（輪流使用所有角色）
+    bool applicable;        // 可以禁用（基本牌與技能牌），不適用的牌其餘欄位都是 0
+    uint64_t games;
+    double winRateWith;     // 有這張牌時的勝率（平手算半場）
+    double winRateWithout;  // 沒有這張牌時的勝率
+    double impact;          // winRateWith - winRateWithout
+    double stdError;        // impact 的標準誤（由成對差計算）
+    double usesPerGame;     // 有這張牌時平均每場打出的次數
+} CardImpact;
+
+// 初始化設定（greedy 對 greedy、每張卡牌 200 場）
+void init_card_impact_config(CardImpactConfig* config);
+
+// 分析卡牌 1..CARD_ID_MAX，results[i] 為卡牌 i+1 的結果；記憶體不足時所有結果的 games 為 0
+void run_card_impact(const CardImpactConfig* config, CardImpact results[CARD_ID_MAX]);
+
+// 依 impact 由大到小排序，不適用的牌排在最後
+void rank_card_impacts(CardImpact* results, size_t count);
+
+// 輸出排名表 / CSV
+void print_card_impacts(FILE* fp, const CardImpact* results, size_t count);
+void write_card_impact_csv(FILE* fp, const CardImpact* results, size_t count);
+
+#endif // _CARD_IMPACT_H
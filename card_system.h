@@ -7,6 +7,15 @@
 // Get card name based on card ID
 const char *get_card_name(int32_t cardId);
 
+// 卡牌ID範圍 1~176（基本牌1~10、各角色技能與必殺牌11~130、中毒131~133、火柴134、蛻變牌135~176）
+// 卡牌資料以 card_spec.tsv 為準，建置時產生 card_table.h
+#define CARD_ID_MAX 176
+#define CARD_ID_COUNT (CARD_ID_MAX + 1)
+
+// 白雪公主的中毒牌（等級1~3）
+#define CARD_POISON_LV1 131
+#define CARD_POISON_LV3 133
+
 // 卡牌類型定義
 typedef enum
 {
@@ -20,6 +29,17 @@ typedef enum
     CARD_TYPE_SPECIAL = 7
 } CardType;
 
+// 卡牌種類（比 CardType 更細：區分必殺、蛻變與中毒/火柴）
+typedef enum
+{
+    CARD_KIND_NONE = 0,
+    CARD_KIND_BASIC,
+    CARD_KIND_SKILL,
+    CARD_KIND_ULTIMATE,
+    CARD_KIND_METAMORPHOSIS,
+    CARD_KIND_TOKEN
+} CardKind;
+
 // 卡牌等級定義
 typedef enum
 {
@@ -28,31 +48,30 @@ typedef enum
     CARD_LEVEL_3 = 2
 } CardLevel;
 
-// 卡牌結構
-typedef struct
-{
-    int32_t id;      // 卡牌唯一ID
-    CardType type;   // 卡牌類型
-    CardLevel level; // 卡牌等級
-    int32_t value;   // 卡牌數值（攻擊/防禦/移動值）
-    int32_t cost;    // 卡牌消耗
-} Card;
+// 獲取卡牌數值（以下四項來自 card_db，可在執行時重新載入）
+int32_t get_card_value(int32_t cardId);
 
-// 卡牌初始化函數
-void init_card_system(game *gameState);
+// 獲取卡牌的購買花費
+int32_t get_card_cost(int32_t cardId);
 
-// 卡牌創建函數
-Card create_card(int32_t id, CardType type, CardLevel level);
+// 獲取卡牌當作攻擊使用時的射程
+int32_t get_card_range(int32_t cardId);
 
-// 獲取卡牌數值
-int32_t get_card_value(int32_t cardId);
+// 獲取技能牌需要搭配的基本牌最低等級，0 表示沒有限制
+int32_t get_card_requirement(int32_t cardId);
 
 // 獲取卡牌類型
 CardType get_card_type(int32_t cardId);
 
-// 獲取卡牌等級
+// 獲取卡牌種類，未知卡牌回傳 CARD_KIND_NONE
+CardKind get_card_kind(int32_t cardId);
+
+// 獲取卡牌等級（沒有等級的卡牌回傳 CARD_LEVEL_1）
 CardLevel get_card_level(int32_t cardId);
 
+// 獲取卡牌所屬角色（CharacterID），基本牌回傳 -1
+int8_t get_card_character(int32_t cardId);
+
 // 遊戲開始時抽牌
 void initial_draw(game *gameState);
 
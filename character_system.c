@@ -38,7 +38,13 @@ void init_character(game *gameState, int playerIndex, CharacterID charId)
         break;
 
     case CHAR_SNOW_WHITE:
+        // 中毒牌庫：等級1 2 3 各 6 張，頂部（陣列尾端）為等級1
         vector_init(&p->snowWhite.remindPosion);
+        for (int32_t card = CARD_POISON_LV3; card >= CARD_POISON_LV1; card--)
+        {
+            for (int i = 0; i < 6; i++)
+                vector_pushback(&p->snowWhite.remindPosion, card);
+        }
         break;
 
     case CHAR_SLEEPING:
@@ -18,6 +18,8 @@ typedef enum {
     CHAR_SCHEHERAZADE = 9 // 山魯佐德
 } CharacterID;
 
+#define CHARACTER_COUNT 10
+
 // 角色基礎屬性
 typedef struct {
     int maxLife;
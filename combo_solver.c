@@ -0,0 +1,209 @@
+#include <stdlib.h>
+#include "combo_solver.h"
+#include "card_combination.h"
+#include "card_system.h"
+#include "game_action.h"
+#include "game_state.h"
+
+#define COMBO_MASKS (1 << COMBO_MAX_BASICS)
+
+static const CardType goalBasicTypes[COMBO_GOAL_COUNT] = {CARD_TYPE_BASIC_ATK, CARD_TYPE_BASIC_DEF,
+                                                         CARD_TYPE_BASIC_MOV};
+static const CardType goalSkillTypes[COMBO_GOAL_COUNT] = {CARD_TYPE_SKILL_ATK, CARD_TYPE_SKILL_DEF,
+                                                         CARD_TYPE_SKILL_MOV};
+
+typedef struct {
+    int32_t index;      // 手牌索引
+    int32_t value;
+    uint32_t partners;  // 技能卡可搭配的基本牌（位元 j 為 basics[j]）
+} ComboCard;
+
+// 依牌值由高到低插入，同值時保持手牌順序；超過 limit 時捨棄最低的
+static void insert_card(ComboCard *cards, uint32_t *count, uint32_t limit, ComboCard card)
+{
+    uint32_t pos = *count;
+    while (pos > 0 && cards[pos - 1].value < card.value)
+        pos--;
+    if (pos == limit)
+        return;
+    uint32_t last = *count < limit ? *count : limit - 1;
+    memmove(&cards[pos + 1], &cards[pos], (last - pos) * sizeof(ComboCard));
+    cards[pos] = card;
+    if (*count < limit)
+        (*count)++;
+}
+
+typedef struct {
+    int32_t capped;
+    int32_t energy;
+    uint32_t cards;
+} ComboScore;
+
+static bool better_score(const ComboScore *a, const ComboScore *b)
+{
+    if (a->capped != b->capped)
+        return a->capped > b->capped;
+    if (a->energy != b->energy)
+        return a->energy > b->energy;
+    return a->cards < b->cards;
+}
+
+void solve_combo(const vector *hand, ComboGoal goal, int32_t target, int32_t energy, ComboPlan *plan)
+{
+    memset(plan, 0, sizeof(ComboPlan));
+    ComboCard basics[COMBO_MAX_BASICS];
+    ComboCard skills[COMBO_MAX_SKILLS];
+    uint32_t basicCount = 0;
+    uint32_t skillCount = 0;
+
+    for (uint32_t i = 0; i < hand->SIZE; i++)
+    {
+        CardType type = get_card_type(hand->array[i]);
+        if (type == goalBasicTypes[goal] || type == CARD_TYPE_BASIC_GENERAL)
+        {
+            ComboCard card = {(int32_t)i, get_card_value(hand->array[i]), 0};
+            insert_card(basics, &basicCount, COMBO_MAX_BASICS, card);
+        }
+    }
+    if (basicCount == 0)
+        return;
+
+    // 沒有可搭配的基本牌的技能卡不列入
+    for (uint32_t i = 0; i < hand->SIZE; i++)
+    {
+        if (get_card_type(hand->array[i]) != goalSkillTypes[goal])
+            continue;
+        ComboCard card = {(int32_t)i, get_card_value(hand->array[i]), 0};
+        for (uint32_t j = 0; j < basicCount; j++)
+        {
+            if (cards_can_combine(hand->array[i], hand->array[basics[j].index]))
+                card.partners |= 1u << j;
+        }
+        if (card.partners != 0)
+            insert_card(skills, &skillCount, COMBO_MAX_SKILLS, card);
+    }
+
+    // 各基本牌集合的牌值和與張數
+    uint32_t full = (1u << basicCount) - 1;
+    int32_t sums[COMBO_MASKS];
+    uint8_t sizes[COMBO_MASKS];
+    sums[0] = 0;
+    sizes[0] = 0;
+    for (uint32_t j = 0; j < basicCount; j++)
+    {
+        for (uint32_t m = 1u << j; m < 2u << j; m++)
+        {
+            sums[m] = sums[m - (1u << j)] + basics[j].value;
+            sizes[m] = (uint8_t)(sizes[m - (1u << j)] + 1);
+        }
+    }
+
+    // best[m]：恰好以基本牌集合 m 搭配技能卡時，技能卡牌值和的最大值（-1 表示無法達成）
+    // from[k][m]：第 k 張技能卡在狀態 m 搭配的基本牌，-1 表示不使用
+    int32_t best[COMBO_MASKS];
+    int8_t from[COMBO_MAX_SKILLS][COMBO_MASKS];
+    best[0] = 0;
+    for (uint32_t m = 1; m <= full; m++)
+        best[m] = -1;
+    for (uint32_t k = 0; k < skillCount; k++)
+    {
+        // 由大到小更新，來源 m ^ bit 仍是上一張技能卡的結果
+        for (uint32_t m = full + 1; m-- > 0;)
+        {
+            from[k][m] = -1;
+            for (uint32_t rest = m & skills[k].partners; rest != 0; rest &= rest - 1)
+            {
+                uint32_t bit = rest & -rest;
+                if (best[m ^ bit] >= 0 && best[m ^ bit] + skills[k].value > best[m])
+                {
+                    best[m] = best[m ^ bit] + skills[k].value;
+                    from[k][m] = (int8_t)__builtin_ctz(bit);
+                }
+            }
+        }
+    }
+
+    // 其餘的基本牌中選出單獨打出的子集合
+    int32_t room = ENERGY_LIMIT - energy > 0 ? ENERGY_LIMIT - energy : 0;
+    if (target < 0)
+        target = 0;
+    ComboScore bestScore = {-1, 0, 0};
+    uint32_t bestPaired = 0;
+    uint32_t bestAlone = 0;
+    for (uint32_t paired = 0; paired <= full; paired++)
+    {
+        if (best[paired] < 0)
+            continue;
+        int32_t pairEffect = best[paired] + sums[paired];
+        uint32_t free = full & ~paired;
+        uint32_t alone = free;
+        while (true)
+        {
+            int32_t effect = pairEffect + sums[alone];
+            ComboScore score = {effect < target ? effect : target, sums[alone] < room ? sums[alone] : room,
+                                2u * sizes[paired] + sizes[alone]};
+            if (better_score(&score, &bestScore))
+            {
+                bestScore = score;
+                bestPaired = paired;
+                bestAlone = alone;
+            }
+            if (alone == 0)
+                break;
+            alone = (alone - 1) & free;
+        }
+    }
+
+    // 由最後一張技能卡往回還原搭配
+    uint32_t mask = bestPaired;
+    for (uint32_t k = skillCount; k-- > 0;)
+    {
+        int8_t j = from[k][mask];
+        if (j < 0)
+            continue;
+        ComboPlay *play = &plan->plays[plan->count++];
+        play->skill = skills[k].index;
+        play->basic = basics[j].index;
+        play->value = skills[k].value + basics[j].value;
+        mask ^= 1u << j;
+    }
+    for (uint32_t j = 0; j < basicCount; j++)
+    {
+        if ((bestAlone >> j) & 1)
+        {
+            ComboPlay *play = &plan->plays[plan->count++];
+            play->skill = -1;
+            play->basic = basics[j].index;
+            play->value = basics[j].value;
+        }
+    }
+    plan->effect = best[bestPaired] + sums[bestPaired] + sums[bestAlone];
+    plan->energy = bestScore.energy;
+    plan->cards = bestScore.cards;
+}
+
+void plan_combo(game *gs, ComboGoal goal, ComboPlan *plan)
+{
+    int me = gs->now_turn_player_id;
+    int opp = (me + 1) % 2;
+    player *p = &gs->players[me];
+    int32_t target;
+    switch (goal)
+    {
+    case COMBO_GOAL_ATTACK:
+        if (!check_attack_range(gs, me, opp))
+        {
+            memset(plan, 0, sizeof(ComboPlan));
+            return;
+        }
+        target = gs->players[opp].life + gs->players[opp].defense;
+        break;
+    case COMBO_GOAL_DEFENSE:
+        target = p->maxdefense - p->defense;
+        break;
+    default:
+        target = abs(p->locate[0] - gs->players[opp].locate[0]) - 1;
+        break;
+    }
+    solve_combo(&p->hand, goal, target, p->energy, plan);
+}
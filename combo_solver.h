@@ -0,0 +1,49 @@
+#ifndef _COMBO_SOLVER_H
+#define _COMBO_SOLVER_H
+
+#include "architecture.h"
+
+// 出牌組合求解：在一個行動類型（攻擊、防禦、移動）中，決定哪些技能卡搭配哪張基本卡、哪些基本卡單獨打出
+// 規則與 game_action.c 相同：
+//   基本牌（或通用牌）單獨打出：效果與能量都等於牌值
+//   技能卡 + 相容的基本牌：效果為兩張牌值的和，不獲得能量
+// 目標依序為：效果（超過 target 的部分不計）最大、獲得的能量（不超過上限）最大、使用的牌最少
+// 以基本牌集合的位元遮罩做動態規劃，一般手牌只需數微秒，可以在每個決策呼叫
+
+typedef enum {
+    COMBO_GOAL_ATTACK = 0,
+    COMBO_GOAL_DEFENSE,
+    COMBO_GOAL_MOVE,
+    COMBO_GOAL_COUNT
+} ComboGoal;
+
+// 參與求解的基本牌上限（超過時只使用牌值最高的幾張），技能卡上限
+#define COMBO_MAX_BASICS 10
+#define COMBO_MAX_SKILLS 16
+
+// 不限制效果
+#define COMBO_UNCAPPED INT32_MAX
+
+typedef struct {
+    int32_t skill;  // 技能卡在手牌中的索引，單獨打出基本牌時為 -1
+    int32_t basic;  // 基本牌（或通用牌）在手牌中的索引
+    int32_t value;  // 這次行動的效果
+} ComboPlay;
+
+typedef struct {
+    ComboPlay plays[COMBO_MAX_BASICS];  // 組合在前、單獨打出的基本牌在後
+    uint32_t count;
+    int32_t effect;   // 總效果（未套用 target）
+    int32_t energy;   // 獲得的能量（已套用上限）
+    uint32_t cards;   // 使用的牌數
+} ComboPlan;
+
+// hand 為手牌，target 為有用的效果上限（COMBO_UNCAPPED 表示不限制），energy 為目前能量
+void solve_combo(const vector* hand, ComboGoal goal, int32_t target, int32_t energy, ComboPlan* plan);
+
+// 以目前行動玩家的局面求解：
+//   攻擊的上限為對手生命加防禦，不在攻擊範圍內時沒有任何行動
+//   防禦的上限為防禦上限減目前防禦，移動的上限為走到對手旁邊的距離
+void plan_combo(game* gameState, ComboGoal goal, ComboPlan* plan);
+
+#endif // _COMBO_SOLVER_H
@@ -0,0 +1,476 @@
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "dataset.h"
+#include "character_system.h"
+#include "debug_log.h"
+#include "simulation.h"
+
+#define DATASET_ALIGN 64
+
+// 一次平行模擬的遊戲數，完成後依遊戲編號順序寫入
+#define DATASET_BLOCK_GAMES 32
+
+static const size_t columnWidths[DATASET_COLUMN_COUNT] = {
+    FEATURE_COUNT, DATASET_MASK_BYTES, sizeof(int16_t), sizeof(int8_t),
+    sizeof(int8_t), sizeof(uint16_t), sizeof(uint64_t),
+};
+
+size_t dataset_column_width(DatasetColumn column)
+{
+    return columnWidths[column];
+}
+
+static uint64_t align_offset(uint64_t offset)
+{
+    return (offset + DATASET_ALIGN - 1) / DATASET_ALIGN * DATASET_ALIGN;
+}
+
+// 最壞情況每 128 個位元組多一個控制位元組
+static size_t zero_run_bound(size_t size)
+{
+    return size + size / 128 + 1;
+}
+
+static size_t zero_run_encode(const uint8_t *in, size_t size, uint8_t *out)
+{
+    size_t o = 0;
+    size_t i = 0;
+    while (i < size)
+    {
+        size_t zeros = 0;
+        while (i + zeros < size && in[i + zeros] == 0 && zeros < 128)
+            zeros++;
+        if (zeros >= 2 || (zeros == 1 && i + 1 == size))
+        {
+            out[o++] = (uint8_t)(127 + zeros);
+            i += zeros;
+            continue;
+        }
+
+        // 原始位元組直到遇到兩個以上連續的 0
+        size_t start = i;
+        while (i < size && i - start < 128 && !(in[i] == 0 && i + 1 < size && in[i + 1] == 0))
+            i++;
+        out[o++] = (uint8_t)(i - start - 1);
+        memcpy(out + o, in + start, i - start);
+        o += i - start;
+    }
+    return o;
+}
+
+static bool zero_run_decode(const uint8_t *in, size_t size, uint8_t *out, size_t rawSize)
+{
+    size_t o = 0;
+    size_t i = 0;
+    while (i < size)
+    {
+        uint8_t control = in[i++];
+        if (control >= 128)
+        {
+            size_t zeros = control - 127u;
+            if (o + zeros > rawSize)
+                return false;
+            memset(out + o, 0, zeros);
+            o += zeros;
+        }
+        else
+        {
+            size_t literal = control + 1u;
+            if (i + literal > size || o + literal > rawSize)
+                return false;
+            memcpy(out + o, in + i, literal);
+            i += literal;
+            o += literal;
+        }
+    }
+    return o == rawSize;
+}
+
+static bool write_padding(DatasetWriter *writer)
+{
+    static const uint8_t zeros[DATASET_ALIGN];
+    uint64_t aligned = align_offset(writer->offset);
+    if (aligned > writer->offset && fwrite(zeros, 1, aligned - writer->offset, writer->fp) != aligned - writer->offset)
+        return false;
+    writer->offset = aligned;
+    return true;
+}
+
+bool dataset_writer_open(DatasetWriter *writer, const char *path, uint32_t chunkRows)
+{
+    memset(writer, 0, sizeof(DatasetWriter));
+    snprintf(writer->path, sizeof(writer->path), "%s", path);
+    writer->chunkRows = chunkRows > 0 ? chunkRows : DATASET_DEFAULT_CHUNK_ROWS;
+
+    size_t widest = 0;
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++)
+    {
+        writer->columns[c] = malloc(writer->chunkRows * columnWidths[c]);
+        if (writer->columns[c] == NULL)
+            writer->failed = true;
+        if (columnWidths[c] > widest)
+            widest = columnWidths[c];
+    }
+    writer->scratch = malloc(zero_run_bound(writer->chunkRows * widest));
+
+    char tmpPath[1100];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    writer->fp = fopen(tmpPath, "wb");
+    if (writer->fp == NULL || writer->scratch == NULL || writer->failed)
+    {
+        ERROR_LOG("Cannot open dataset file %s", tmpPath);
+        writer->failed = true;
+        return false;
+    }
+
+    // header 在關閉時補上
+    DatasetHeader header;
+    memset(&header, 0, sizeof(header));
+    writer->failed = fwrite(&header, sizeof(header), 1, writer->fp) != 1;
+    writer->offset = sizeof(header);
+    return !writer->failed;
+}
+
+static bool flush_chunk(DatasetWriter *writer)
+{
+    if (writer->pending == 0)
+        return true;
+    if (writer->chunkCount == writer->chunkCapacity)
+    {
+        uint64_t capacity = writer->chunkCapacity > 0 ? writer->chunkCapacity * 2 : 64;
+        DatasetChunk *grown = realloc(writer->chunks, capacity * sizeof(DatasetChunk));
+        if (grown == NULL)
+            return false;
+        writer->chunks = grown;
+        writer->chunkCapacity = capacity;
+    }
+
+    DatasetChunk *chunk = &writer->chunks[writer->chunkCount];
+    memset(chunk, 0, sizeof(DatasetChunk));
+    chunk->rowCount = writer->pending;
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++)
+    {
+        if (!write_padding(writer))
+            return false;
+        size_t rawSize = writer->pending * columnWidths[c];
+        size_t encoded = zero_run_encode(writer->columns[c], rawSize, writer->scratch);
+        bool compress = encoded < rawSize;
+        const uint8_t *data = compress ? writer->scratch : writer->columns[c];
+        size_t size = compress ? encoded : rawSize;
+        if (fwrite(data, 1, size, writer->fp) != size)
+            return false;
+
+        DatasetColumnInfo *info = &chunk->columns[c];
+        info->offset = writer->offset;
+        info->size = size;
+        info->rawSize = rawSize;
+        info->codec = compress ? DATASET_CODEC_ZERO_RUN : DATASET_CODEC_RAW;
+        writer->offset += size;
+    }
+    writer->chunkCount++;
+    writer->pending = 0;
+    return true;
+}
+
+bool dataset_writer_add(DatasetWriter *writer, const DatasetRow *row)
+{
+    if (writer->failed)
+        return false;
+
+    uint32_t r = writer->pending;
+    memcpy(writer->columns[DATASET_COL_FEATURES] + (size_t)r * FEATURE_COUNT, row->features, FEATURE_COUNT);
+    memcpy(writer->columns[DATASET_COL_MASKS] + (size_t)r * DATASET_MASK_BYTES, row->legalMask, DATASET_MASK_BYTES);
+    memcpy(writer->columns[DATASET_COL_ACTIONS] + r * sizeof(int16_t), &row->action, sizeof(int16_t));
+    memcpy(writer->columns[DATASET_COL_PLAYERS] + r, &row->player, sizeof(int8_t));
+    memcpy(writer->columns[DATASET_COL_OUTCOMES] + r, &row->outcome, sizeof(int8_t));
+    memcpy(writer->columns[DATASET_COL_PLIES] + r * sizeof(uint16_t), &row->ply, sizeof(uint16_t));
+    memcpy(writer->columns[DATASET_COL_GAMES] + r * sizeof(uint64_t), &row->game, sizeof(uint64_t));
+    writer->pending++;
+    writer->rowCount++;
+
+    if (writer->pending == writer->chunkRows && !flush_chunk(writer))
+        writer->failed = true;
+    return !writer->failed;
+}
+
+bool dataset_writer_close(DatasetWriter *writer)
+{
+    char tmpPath[1100];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", writer->path);
+    bool ok = !writer->failed && writer->fp != NULL && flush_chunk(writer) && write_padding(writer);
+
+    if (ok)
+    {
+        DatasetHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, DATASET_MAGIC, 4);
+        header.version = DATASET_VERSION;
+        header.featureCount = FEATURE_COUNT;
+        header.actionCount = RL_ACTION_COUNT;
+        header.columnCount = DATASET_COLUMN_COUNT;
+        header.chunkRows = writer->chunkRows;
+        header.chunkCount = writer->chunkCount;
+        header.rowCount = writer->rowCount;
+        header.indexOffset = writer->offset;
+        ok = fwrite(writer->chunks, sizeof(DatasetChunk), writer->chunkCount, writer->fp) == writer->chunkCount &&
+             fseek(writer->fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, writer->fp) == 1 &&
+             fflush(writer->fp) == 0 && fsync(fileno(writer->fp)) == 0;
+    }
+    if (writer->fp != NULL)
+        ok = fclose(writer->fp) == 0 && ok;
+    if (!ok || rename(tmpPath, writer->path) != 0)
+    {
+        ERROR_LOG("Cannot write dataset file %s", writer->path);
+        remove(tmpPath);
+        ok = false;
+    }
+
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++)
+        free(writer->columns[c]);
+    free(writer->scratch);
+    free(writer->chunks);
+    memset(writer, 0, sizeof(DatasetWriter));
+    return ok;
+}
+
+// 開啟時檢查所有索引，之後讀取不需要再檢查範圍
+static bool valid_dataset(const DatasetHeader *header, size_t size)
+{
+    if (memcmp(header->magic, DATASET_MAGIC, 4) != 0 || header->version != DATASET_VERSION ||
+        header->featureCount != FEATURE_COUNT || header->actionCount != RL_ACTION_COUNT ||
+        header->columnCount != DATASET_COLUMN_COUNT || header->indexOffset > size ||
+        header->chunkCount > (size - header->indexOffset) / sizeof(DatasetChunk))
+        return false;
+
+    const DatasetChunk *chunks = (const DatasetChunk *)((const uint8_t *)header + header->indexOffset);
+    uint64_t rows = 0;
+    for (uint64_t i = 0; i < header->chunkCount; i++)
+    {
+        rows += chunks[i].rowCount;
+        for (int c = 0; c < DATASET_COLUMN_COUNT; c++)
+        {
+            const DatasetColumnInfo *info = &chunks[i].columns[c];
+            if (info->offset > size || info->size > size - info->offset || info->offset % DATASET_ALIGN != 0 ||
+                info->rawSize != chunks[i].rowCount * columnWidths[c] ||
+                (info->codec == DATASET_CODEC_RAW && info->size != info->rawSize) ||
+                info->codec > DATASET_CODEC_ZERO_RUN)
+                return false;
+        }
+    }
+    return rows == header->rowCount;
+}
+
+bool dataset_open(DatasetReader *reader, const char *path)
+{
+    memset(reader, 0, sizeof(DatasetReader));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        ERROR_LOG("Cannot open dataset %s", path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(DatasetHeader))
+    {
+        ERROR_LOG("Dataset %s is too small", path);
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        ERROR_LOG("Cannot mmap dataset %s", path);
+        return false;
+    }
+
+    const DatasetHeader *header = map;
+    if (!valid_dataset(header, (size_t)st.st_size))
+    {
+        ERROR_LOG("Invalid dataset %s", path);
+        munmap(map, (size_t)st.st_size);
+        return false;
+    }
+
+    reader->map = map;
+    reader->size = (size_t)st.st_size;
+    reader->header = header;
+    reader->chunks = (const DatasetChunk *)((const uint8_t *)map + header->indexOffset);
+    return true;
+}
+
+void dataset_close(DatasetReader *reader)
+{
+    if (reader->map != NULL)
+        munmap(reader->map, reader->size);
+    memset(reader, 0, sizeof(DatasetReader));
+}
+
+const void *dataset_column_view(const DatasetReader *reader, uint64_t chunk, DatasetColumn column)
+{
+    const DatasetColumnInfo *info = &reader->chunks[chunk].columns[column];
+    if (info->codec != DATASET_CODEC_RAW)
+        return NULL;
+    return (const uint8_t *)reader->map + info->offset;
+}
+
+bool dataset_read_column(const DatasetReader *reader, uint64_t chunk, DatasetColumn column, void *out)
+{
+    const DatasetColumnInfo *info = &reader->chunks[chunk].columns[column];
+    const uint8_t *data = (const uint8_t *)reader->map + info->offset;
+    if (info->codec == DATASET_CODEC_RAW)
+    {
+        memcpy(out, data, info->rawSize);
+        return true;
+    }
+    return zero_run_decode(data, info->size, out, info->rawSize);
+}
+
+void init_dataset_config(DatasetConfig *config)
+{
+    config->bots[0] = find_bot_policy("greedy");
+    config->bots[1] = find_bot_policy("greedy");
+    config->seed = 1;
+    config->games = 1000;
+    config->maxTurns = SIM_DEFAULT_MAX_TURNS;
+    config->chunkRows = DATASET_DEFAULT_CHUNK_ROWS;
+    config->threads = 0;
+}
+
+// 一場遊戲收集到的列（結果在遊戲結束後補上）
+typedef struct {
+    DatasetRow *rows;
+    size_t count;
+    size_t capacity;
+    bool failed;
+} GameRows;
+
+typedef struct {
+    const DatasetConfig *config;
+    uint64_t firstGame;
+    GameRows *games;
+} DatasetBlock;
+
+static void record_choice(void *ctx, game *gs, vector *choices, int32_t choice)
+{
+    GameRows *rows = ctx;
+    if (rows->failed)
+        return;
+    if (rows->count == rows->capacity)
+    {
+        size_t capacity = rows->capacity > 0 ? rows->capacity * 2 : 128;
+        DatasetRow *grown = realloc(rows->rows, capacity * sizeof(DatasetRow));
+        if (grown == NULL)
+        {
+            rows->failed = true;
+            return;
+        }
+        rows->rows = grown;
+        rows->capacity = capacity;
+    }
+
+    DatasetRow *row = &rows->rows[rows->count];
+    extract_features_int8(gs, gs->now_turn_player_id, row->features);
+    memset(row->legalMask, 0, DATASET_MASK_BYTES);
+    for (uint32_t i = 0; i < choices->SIZE; i++)
+    {
+        int32_t action = RL_CHOICE_TO_ACTION(choices->array[i]);
+        if (action >= 0 && action < RL_ACTION_COUNT)
+            row->legalMask[action / 8] |= (uint8_t)(1u << (action % 8));
+    }
+    row->action = (int16_t)RL_CHOICE_TO_ACTION(choice);
+    row->player = gs->now_turn_player_id;
+    row->outcome = 0;
+    row->ply = rows->count < UINT16_MAX ? (uint16_t)rows->count : UINT16_MAX;
+    row->game = 0;
+    rows->count++;
+}
+
+static void play_dataset_game(void *ctx, size_t task)
+{
+    DatasetBlock *block = ctx;
+    const DatasetConfig *config = block->config;
+    uint64_t gameIndex = block->firstGame + task;
+    GameRows *rows = &block->games[task];
+
+    // 每場的角色只由種子與遊戲編號決定
+    uint64_t pick = rng_mix64(config->seed ^ rng_mix64(gameIndex));
+    SimConfig sim;
+    sim_init_config(&sim);
+    sim.characters[0] = (uint8_t)(pick % CHARACTER_COUNT);
+    sim.characters[1] = (uint8_t)((pick >> 32) % CHARACTER_COUNT);
+    sim.bots[0] = config->bots[0];
+    sim.bots[1] = config->bots[1];
+    sim.seed = config->seed;
+    sim.maxTurns = config->maxTurns;
+    sim.onChoice = record_choice;
+    sim.onChoiceCtx = rows;
+
+    SimGameResult *result = malloc(sizeof(SimGameResult));
+    if (result == NULL)
+    {
+        rows->failed = true;
+        return;
+    }
+    sim_play_game(&sim, gameIndex, result);
+    for (size_t i = 0; i < rows->count; i++)
+    {
+        DatasetRow *row = &rows->rows[i];
+        row->outcome = result->winner < 0 ? 0 : result->winner == row->player ? 1 : -1;
+        row->game = gameIndex;
+    }
+    free(result);
+}
+
+bool generate_dataset(const DatasetConfig *config, const char *path, uint64_t *rowCount)
+{
+    DatasetWriter writer;
+    if (!dataset_writer_open(&writer, path, config->chunkRows))
+    {
+        dataset_writer_close(&writer);
+        return false;
+    }
+
+    GameRows *games = calloc(DATASET_BLOCK_GAMES, sizeof(GameRows));
+    bool ok = games != NULL;
+    for (uint64_t first = 0; ok && first < config->games; first += DATASET_BLOCK_GAMES)
+    {
+        uint64_t count = config->games - first < DATASET_BLOCK_GAMES ? config->games - first : DATASET_BLOCK_GAMES;
+        DatasetBlock block;
+        block.config = config;
+        block.firstGame = first;
+        block.games = games;
+        for (uint64_t i = 0; i < count; i++)
+        {
+            games[i].count = 0;
+            games[i].failed = false;
+        }
+        sim_parallel_for(count, config->threads, play_dataset_game, &block);
+
+        for (uint64_t i = 0; ok && i < count; i++)
+        {
+            ok = !games[i].failed;
+            for (size_t r = 0; ok && r < games[i].count; r++)
+                ok = dataset_writer_add(&writer, &games[i].rows[r]);
+        }
+    }
+
+    uint64_t rows = writer.rowCount;
+    if (games != NULL)
+    {
+        for (int i = 0; i < DATASET_BLOCK_GAMES; i++)
+            free(games[i].rows);
+    }
+    free(games);
+    writer.failed = writer.failed || !ok;
+    ok = dataset_writer_close(&writer);
+    if (ok && rowCount != NULL)
+        *rowCount = rows;
+    return ok;
+}
@@ -0,0 +1,124 @@
+#ifndef _DATASET_H
+#define _DATASET_H
+
+#include "architecture.h"
+#include "bot.h"
+#include "game_features.h"
+#include "rl_env.h"
+
+// 自我對戰的訓練資料集：每個決策點一列，以欄為單位分塊保存
+// 檔案 = header + 各區塊各欄的資料（每段 64 bytes 對齊）+ 檔尾的區塊索引
+// 每一欄獨立壓縮（零值游程編碼，壓縮後沒有變小就保存原始資料）；原始資料的欄可直接從 mmap 讀取
+
+#define DATASET_MAGIC "TFDS"
+#define DATASET_VERSION 1
+#define DATASET_DEFAULT_CHUNK_ROWS 4096
+
+// 合法動作遮罩以位元保存：動作 a 在第 a / 8 個位元組的第 a % 8 位
+#define DATASET_MASK_BYTES ((RL_ACTION_COUNT + 7) / 8)
+
+typedef enum {
+    DATASET_COL_FEATURES = 0,  // int8_t[FEATURE_COUNT]，以行動者為自己的局面特徵
+    DATASET_COL_MASKS,         // uint8_t[DATASET_MASK_BYTES]
+    DATASET_COL_ACTIONS,       // int16_t，選擇的動作（RL_CHOICE_TO_ACTION）
+    DATASET_COL_PLAYERS,       // int8_t，行動者
+    DATASET_COL_OUTCOMES,      // int8_t，最終結果（行動者勝 1、負 -1、平手 0）
+    DATASET_COL_PLIES,         // uint16_t，這是該場第幾個決策
+    DATASET_COL_GAMES,         // uint64_t，遊戲編號
+    DATASET_COLUMN_COUNT
+} DatasetColumn;
+
+typedef enum {
+    DATASET_CODEC_RAW = 0,
+    DATASET_CODEC_ZERO_RUN = 1  // 控制位元組 c：c < 128 接著 c+1 個原始位元組；c >= 128 表示 c-127 個 0
+} DatasetCodec;
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t featureCount;
+    uint32_t actionCount;
+    uint32_t columnCount;
+    uint32_t chunkRows;
+    uint64_t chunkCount;
+    uint64_t rowCount;
+    uint64_t indexOffset;  // 區塊索引（DatasetChunk[chunkCount]）的位置
+} DatasetHeader;
+
+typedef struct {
+    uint64_t offset;   // 從檔案開頭算起
+    uint64_t size;     // 保存的大小
+    uint64_t rawSize;  // 解壓縮後的大小
+    uint32_t codec;
+    uint32_t reserved;
+} DatasetColumnInfo;
+
+typedef struct {
+    uint64_t rowCount;
+    DatasetColumnInfo columns[DATASET_COLUMN_COUNT];
+} DatasetChunk;
+
+// 一列資料
+typedef struct {
+    int8_t features[FEATURE_COUNT];
+    uint8_t legalMask[DATASET_MASK_BYTES];
+    int16_t action;
+    int8_t player;
+    int8_t outcome;
+    uint16_t ply;
+    uint64_t game;
+} DatasetRow;
+
+typedef struct {
+    FILE* fp;
+    char path[1024];
+    uint32_t chunkRows;
+    uint32_t pending;       // 目前區塊已收集的列數
+    uint8_t* columns[DATASET_COLUMN_COUNT];
+    uint8_t* scratch;       // 壓縮用
+    DatasetChunk* chunks;
+    uint64_t chunkCount;
+    uint64_t chunkCapacity;
+    uint64_t rowCount;
+    uint64_t offset;        // 目前寫到的位置
+    bool failed;
+} DatasetWriter;
+
+typedef struct {
+    void* map;
+    size_t size;
+    const DatasetHeader* header;
+    const DatasetChunk* chunks;
+} DatasetReader;
+
+// 每一欄一列的大小
+size_t dataset_column_width(DatasetColumn column);
+
+// 寫入（先寫暫存檔，dataset_writer_close 成功時才改名成 path）
+bool dataset_writer_open(DatasetWriter* writer, const char* path, uint32_t chunkRows);
+bool dataset_writer_add(DatasetWriter* writer, const DatasetRow* row);
+bool dataset_writer_close(DatasetWriter* writer);
+
+// 以 mmap 讀取
+bool dataset_open(DatasetReader* reader, const char* path);
+void dataset_close(DatasetReader* reader);
+// 原始資料的欄直接回傳 mmap 中的位置，壓縮過的欄回傳 NULL
+const void* dataset_column_view(const DatasetReader* reader, uint64_t chunk, DatasetColumn column);
+// 解壓縮一個區塊的一欄到 out（大小為 rowCount * dataset_column_width）
+bool dataset_read_column(const DatasetReader* reader, uint64_t chunk, DatasetColumn column, void* out);
+
+// 以模擬對戰產生資料集
+typedef struct {
+    const BotPolicy* bots[2];
+    uint64_t seed;
+    uint64_t games;
+    uint32_t maxTurns;
+    uint32_t chunkRows;
+    int threads;  // 0 表示使用全部核心；輸出內容與執行緒數無關
+} DatasetConfig;
+
+// 預設：greedy 對 greedy、1000 場、每場隨機角色
+void init_dataset_config(DatasetConfig* config);
+bool generate_dataset(const DatasetConfig* config, const char* path, uint64_t* rowCount);
+
+#endif // _DATASET_H
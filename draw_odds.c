@@ -0,0 +1,149 @@
+#include "draw_odds.h"
+#include "card_system.h"
+#include "rng.h"
+
+// 每個執行緒的快取（直接對應），以組成與抽牌數為鍵
+#define DRAW_CACHE_SIZE 64
+
+typedef struct {
+    PileComposition piles;
+    uint32_t draws;  // 0 表示空位（0 次抽牌不需要快取）
+    DrawOdds odds;
+} DrawCacheEntry;
+
+static _Thread_local DrawCacheEntry drawCache[DRAW_CACHE_SIZE];
+static _Thread_local uint64_t cacheHits = 0;
+static _Thread_local uint64_t cacheMisses = 0;
+
+DrawCategory get_draw_category(int32_t cardId)
+{
+    switch (get_card_type(cardId))
+    {
+    case CARD_TYPE_BASIC_ATK:
+        return DRAW_ATTACK;
+    case CARD_TYPE_BASIC_DEF:
+        return DRAW_DEFENSE;
+    case CARD_TYPE_BASIC_MOV:
+        return DRAW_MOVE;
+    case CARD_TYPE_BASIC_GENERAL:
+        return DRAW_GENERAL;
+    case CARD_TYPE_SKILL_ATK:
+    case CARD_TYPE_SKILL_DEF:
+    case CARD_TYPE_SKILL_MOV:
+        return DRAW_SKILL;
+    default:
+        return DRAW_OTHER;
+    }
+}
+
+static void count_cards(vector *cards, uint16_t *counts)
+{
+    for (uint32_t i = 0; i < cards->SIZE; i++)
+        counts[get_draw_category(cards->array[i])]++;
+}
+
+void count_draw_piles(player *p, bool refill, PileComposition *piles)
+{
+    memset(piles, 0, sizeof(PileComposition));
+    count_cards(&p->deck, piles->deck);
+    count_cards(&p->graveyard, piles->graveyard);
+    if (refill)
+    {
+        count_cards(&p->hand, piles->graveyard);
+        count_cards(&p->usecards, piles->graveyard);
+    }
+}
+
+// C(n, k)，k 不超過 DRAW_MAX_DRAWS，double 可以精確表示
+static double binomial(uint32_t n, uint32_t k)
+{
+    if (k > n)
+        return 0.0;
+    double result = 1.0;
+    for (uint32_t j = 1; j <= k; j++)
+        result = result * (double)(n - k + j) / (double)j;
+    return result;
+}
+
+// 從 total 張（其中 marked 張為目標類別）抽 draws 張，目標類別張數的分布
+static void hypergeometric(uint32_t total, uint32_t marked, uint32_t draws, double *pmf)
+{
+    double all = binomial(total, draws);
+    for (uint32_t i = 0; i <= draws; i++)
+        pmf[i] = binomial(marked, i) * binomial(total - marked, draws - i) / all;
+}
+
+static uint32_t pile_total(const uint16_t *counts)
+{
+    uint32_t total = 0;
+    for (int c = 0; c < DRAW_CATEGORY_COUNT; c++)
+        total += counts[c];
+    return total;
+}
+
+static void compute_odds(const PileComposition *piles, uint32_t draws, DrawOdds *odds)
+{
+    uint32_t deckTotal = pile_total(piles->deck);
+    uint32_t graveTotal = pile_total(piles->graveyard);
+    uint32_t fromDeck = draws < deckTotal ? draws : deckTotal;
+    uint32_t fromGrave = draws - fromDeck < graveTotal ? draws - fromDeck : graveTotal;
+    memset(odds, 0, sizeof(DrawOdds));
+    odds->draws = fromDeck + fromGrave;
+
+    for (int c = 0; c < DRAW_CATEGORY_COUNT; c++)
+    {
+        // 兩堆各自的張數互相獨立，總數的分布為兩者的卷積
+        double deckPmf[DRAW_MAX_DRAWS + 1];
+        double gravePmf[DRAW_MAX_DRAWS + 1];
+        double pmf[DRAW_MAX_DRAWS + 1] = {0};
+        hypergeometric(deckTotal, piles->deck[c], fromDeck, deckPmf);
+        hypergeometric(graveTotal, piles->graveyard[c], fromGrave, gravePmf);
+        for (uint32_t i = 0; i <= fromDeck; i++)
+        {
+            for (uint32_t j = 0; j <= fromGrave; j++)
+                pmf[i + j] += deckPmf[i] * gravePmf[j];
+        }
+
+        double tail = 0.0;
+        for (int k = (int)odds->draws; k >= 0; k--)
+        {
+            tail += pmf[k];
+            odds->atLeast[c][k] = tail > 1.0 ? 1.0 : tail;
+        }
+    }
+}
+
+bool get_draw_odds(const PileComposition *piles, uint32_t draws, DrawOdds *odds)
+{
+    if (draws > DRAW_MAX_DRAWS)
+        return false;
+    if (draws == 0)
+    {
+        compute_odds(piles, 0, odds);
+        return true;
+    }
+
+    uint64_t key = draws;
+    for (int c = 0; c < DRAW_CATEGORY_COUNT; c++)
+        key = rng_mix64(key ^ ((uint64_t)piles->deck[c] << 16 | piles->graveyard[c]));
+    DrawCacheEntry *entry = &drawCache[key % DRAW_CACHE_SIZE];
+    if (entry->draws == draws && memcmp(&entry->piles, piles, sizeof(PileComposition)) == 0)
+    {
+        cacheHits++;
+        *odds = entry->odds;
+        return true;
+    }
+
+    cacheMisses++;
+    compute_odds(piles, draws, odds);
+    entry->piles = *piles;
+    entry->draws = draws;
+    entry->odds = *odds;
+    return true;
+}
+
+void get_draw_cache_stats(uint64_t *hits, uint64_t *misses)
+{
+    *hits = cacheHits;
+    *misses = cacheMisses;
+}
@@ -0,0 +1,46 @@
+#ifndef _DRAW_ODDS_H
+#define _DRAW_ODDS_H
+
+#include "architecture.h"
+
+// 抽牌機率：依牌堆與棄牌堆的組成，計算接下來 n 次抽牌中各類卡牌至少 k 張的精確機率（超幾何分布）
+// 玩家不知道牌堆順序，視為組成相同的均勻隨機排列；牌堆抽完後棄牌堆洗成新的牌堆再繼續抽
+// 結果依 (組成, n) 保存在每個執行緒各自的快取中，畫面更新與搜尋節點不必重算
+
+typedef enum {
+    DRAW_ATTACK = 0,   // 基本攻擊牌
+    DRAW_DEFENSE,      // 基本防禦牌
+    DRAW_MOVE,         // 基本移動牌
+    DRAW_GENERAL,      // 通用牌
+    DRAW_SKILL,        // 技能牌（攻擊、防禦、移動）
+    DRAW_OTHER,        // 其他（蛻變、毒牌等）
+    DRAW_CATEGORY_COUNT
+} DrawCategory;
+
+#define DRAW_MAX_DRAWS 12
+
+// 回合結束補滿手牌的張數
+#define DRAW_REFILL_CARDS 6
+
+typedef struct {
+    uint16_t deck[DRAW_CATEGORY_COUNT];
+    uint16_t graveyard[DRAW_CATEGORY_COUNT];  // 牌堆抽完後洗入的牌
+} PileComposition;
+
+typedef struct {
+    uint32_t draws;  // 實際抽到的張數（兩堆加起來不夠時少於要求）
+    double atLeast[DRAW_CATEGORY_COUNT][DRAW_MAX_DRAWS + 1];  // [類別][k] = P(至少 k 張)
+} DrawOdds;
+
+DrawCategory get_draw_category(int32_t cardId);
+
+// 統計玩家的牌堆組成；refill 為 true 時表示回合結束補牌（手牌與出牌區先進入棄牌堆）
+void count_draw_piles(player* p, bool refill, PileComposition* piles);
+
+// draws 超過 DRAW_MAX_DRAWS 時回傳 false
+bool get_draw_odds(const PileComposition* piles, uint32_t draws, DrawOdds* odds);
+
+// 目前執行緒快取的命中與未命中次數
+void get_draw_cache_stats(uint64_t* hits, uint64_t* misses);
+
+#endif // _DRAW_ODDS_H
@@ -0,0 +1,360 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "engine_protocol.h"
+#include "debug_log.h"
+#include "game_action.h"
+#include "game_codec.h"
+#include "game_init.h"
+#include "rng.h"
+
+void init_engine_options(EngineOptions *options)
+{
+    options->name = "twisted_sim";
+    options->bot = NULL;
+    init_search_config(&options->search);
+    options->seed = 1;
+}
+
+// 解析 go 的參數，不認得的參數忽略
+static void parse_go(char *args, EngineLimits *limits)
+{
+    memset(limits, 0, sizeof(EngineLimits));
+    char *save = NULL;
+    for (char *key = strtok_r(args, " ", &save); key != NULL; key = strtok_r(NULL, " ", &save))
+    {
+        char *value = strtok_r(NULL, " ", &save);
+        if (value == NULL)
+            break;
+        if (strcmp(key, "movetime") == 0)
+            limits->moveTimeMs = (uint32_t)strtoul(value, NULL, 10);
+        else if (strcmp(key, "nodes") == 0)
+            limits->nodeLimit = strtoull(value, NULL, 10);
+        else if (strcmp(key, "depth") == 0)
+            limits->maxDepth = atoi(value);
+    }
+}
+
+static void engine_go(const EngineOptions *options, game *gs, const EngineLimits *limits, RngState *rng, FILE *out)
+{
+    vector choices;
+    get_legal_choices(gs, &choices);
+    if (choices.SIZE == 0)
+    {
+        fprintf(out, "bestchoice none\n");
+        return;
+    }
+
+    if (options->bot != NULL)
+    {
+        fprintf(out, "bestchoice %d\n", bot_choose(options->bot, gs, &choices, rng));
+        return;
+    }
+
+    SearchConfig search = options->search;
+    if (limits->moveTimeMs > 0)
+        search.timeLimitMs = limits->moveTimeMs;
+    if (limits->nodeLimit > 0)
+        search.nodeLimit = limits->nodeLimit;
+    if (limits->maxDepth > 0)
+        search.maxDepth = limits->maxDepth;
+    SearchResult result;
+    int32_t choice = search_choose(&search, gs, &choices, rng, &result);
+    fprintf(out, "info depth %d nodes %llu score %d\n", result.depth, (unsigned long long)result.nodes,
+            result.score);
+    fprintf(out, "bestchoice %d\n", choice);
+}
+
+uint64_t run_engine_loop(const EngineOptions *options, FILE *in, FILE *out)
+{
+    game gameState;
+    bool hasPosition = false;
+    RngState rng;
+    rng_seed(&rng, options->seed, 0);
+    uint64_t searches = 0;
+
+    char *line = NULL;
+    size_t capacity = 0;
+    ssize_t length;
+    while ((length = getline(&line, &capacity, in)) >= 0)
+    {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+            line[--length] = '\0';
+        char *args = strchr(line, ' ');
+        if (args != NULL)
+            *args++ = '\0';
+        else
+            args = line + length;
+
+        if (strcmp(line, "tfp") == 0)
+            fprintf(out, "id name %s\ntfpok\n", options->name);
+        else if (strcmp(line, "isready") == 0)
+            fprintf(out, "readyok\n");
+        else if (strcmp(line, "newgame") == 0)
+        {
+            rng_seed(&rng, options->seed, 0);
+            hasPosition = false;
+        }
+        else if (strcmp(line, "position") == 0)
+        {
+            hasPosition = decode_game_text(args, strlen(args), &gameState);
+            if (!hasPosition)
+                fprintf(out, "info string invalid position\n");
+        }
+        else if (strcmp(line, "go") == 0)
+        {
+            EngineLimits limits;
+            parse_go(args, &limits);
+            if (hasPosition)
+                engine_go(options, &gameState, &limits, &rng, out);
+            else
+                fprintf(out, "bestchoice none\n");
+            searches++;
+        }
+        else if (strcmp(line, "quit") == 0)
+            break;
+        else if (line[0] != '\0')
+            fprintf(out, "info string unknown command %s\n", line);
+        fflush(out);
+    }
+    free(line);
+    return searches;
+}
+
+static int64_t now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static bool write_all(int fd, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+// 讀取一行（不含換行），逾時、引擎結束或行太長時回傳 false
+static bool read_line(ExternalEngine *engine, uint32_t timeoutMs, char *line, size_t size)
+{
+    int64_t deadline = now_ms() + timeoutMs;
+    while (true)
+    {
+        char *newline = memchr(engine->buffer, '\n', engine->buffered);
+        if (newline != NULL)
+        {
+            size_t length = (size_t)(newline - engine->buffer);
+            if (length >= size)
+                return false;
+            memcpy(line, engine->buffer, length);
+            line[length] = '\0';
+            if (length > 0 && line[length - 1] == '\r')
+                line[length - 1] = '\0';
+            engine->buffered -= length + 1;
+            memmove(engine->buffer, newline + 1, engine->buffered);
+            return true;
+        }
+        if (engine->buffered == sizeof(engine->buffer))
+            return false;
+
+        int64_t remaining = deadline - now_ms();
+        if (remaining <= 0)
+            return false;
+        struct pollfd pfd = {engine->fromEngine, POLLIN, 0};
+        int ready = poll(&pfd, 1, (int)remaining);
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready <= 0)
+            return false;
+        ssize_t got = read(engine->fromEngine, engine->buffer + engine->buffered,
+                           sizeof(engine->buffer) - engine->buffered);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return false;
+        engine->buffered += (size_t)got;
+    }
+}
+
+// 送出 command 後等待以 reply 開頭的一行
+static bool expect_reply(ExternalEngine *engine, const char *command, const char *reply, uint32_t timeoutMs)
+{
+    if (!write_all(engine->toEngine, command, strlen(command)))
+        return false;
+    char line[ENGINE_LINE_MAX];
+    while (read_line(engine, timeoutMs, line, sizeof(line)))
+    {
+        if (strncmp(line, "id name ", 8) == 0)
+            snprintf(engine->name, sizeof(engine->name), "%.*s", (int)sizeof(engine->name) - 1, line + 8);
+        else if (strcmp(line, reply) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool engine_start(ExternalEngine *engine, const char *command, uint32_t timeoutMs)
+{
+    memset(engine, 0, sizeof(ExternalEngine));
+    int toChild[2];
+    int fromChild[2];
+    if (pipe(toChild) != 0)
+        return false;
+    if (pipe(fromChild) != 0)
+    {
+        close(toChild[0]);
+        close(toChild[1]);
+        return false;
+    }
+
+    // 引擎結束後寫入不應讓控制端收到 SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+    engine->pid = fork();
+    if (engine->pid == 0)
+    {
+        dup2(toChild[0], STDIN_FILENO);
+        dup2(fromChild[1], STDOUT_FILENO);
+        close(toChild[0]);
+        close(toChild[1]);
+        close(fromChild[0]);
+        close(fromChild[1]);
+        execl("/bin/sh", "sh", "-c", command, (char *)NULL);
+        _exit(127);
+    }
+    close(toChild[0]);
+    close(fromChild[1]);
+    engine->toEngine = toChild[1];
+    engine->fromEngine = fromChild[0];
+    if (engine->pid < 0)
+    {
+        ERROR_LOG("Cannot start engine %s", command);
+        close(engine->toEngine);
+        close(engine->fromEngine);
+        return false;
+    }
+
+    snprintf(engine->name, sizeof(engine->name), "%s", command);
+    if (!expect_reply(engine, "tfp\n", "tfpok", timeoutMs) ||
+        !expect_reply(engine, "isready\n", "readyok", timeoutMs))
+    {
+        ERROR_LOG("Engine %s did not answer the handshake", command);
+        engine_stop(engine);
+        return false;
+    }
+    return true;
+}
+
+void engine_stop(ExternalEngine *engine)
+{
+    write_all(engine->toEngine, "quit\n", 5);
+    close(engine->toEngine);
+
+    // 最多等待一秒
+    int status;
+    for (int i = 0; i < 100; i++)
+    {
+        if (waitpid(engine->pid, &status, WNOHANG) != 0)
+        {
+            close(engine->fromEngine);
+            return;
+        }
+        struct timespec pause = {0, 10000000};
+        nanosleep(&pause, NULL);
+    }
+    WARN_LOG("Engine %s did not quit, killing it", engine->name);
+    kill(engine->pid, SIGKILL);
+    waitpid(engine->pid, &status, 0);
+    close(engine->fromEngine);
+}
+
+bool engine_choose(ExternalEngine *engine, game *gs, const EngineLimits *limits, uint32_t timeoutMs,
+                   int32_t *choice)
+{
+    size_t capacity = GAME_CODEC_MAX_TEXT + 128;
+    char *message = malloc(capacity);
+    if (message == NULL)
+        return false;
+    size_t length = (size_t)snprintf(message, capacity, "position ");
+    size_t stateLength = encode_game_text(gs, message + length, capacity - length);
+    if (stateLength == 0)
+    {
+        free(message);
+        return false;
+    }
+    length += stateLength;
+    length += (size_t)snprintf(message + length, capacity - length, "\ngo movetime %u nodes %llu depth %d\n",
+                               limits->moveTimeMs, (unsigned long long)limits->nodeLimit, limits->maxDepth);
+    bool sent = write_all(engine->toEngine, message, length);
+    free(message);
+    if (!sent)
+        return false;
+
+    char line[ENGINE_LINE_MAX];
+    while (read_line(engine, timeoutMs, line, sizeof(line)))
+    {
+        if (strncmp(line, "bestchoice ", 11) != 0)
+            continue;
+        char *end;
+        long value = strtol(line + 11, &end, 10);
+        if (end == line + 11 || *end != '\0')
+            return false;
+        *choice = (int32_t)value;
+        return true;
+    }
+    return false;
+}
+
+void play_engine_game(ExternalEngine *engines[2], const uint8_t characters[2], uint64_t seed, uint64_t gameIndex,
+                      const EngineLimits *limits, uint32_t timeoutMs, uint32_t maxTurns, EngineGameResult *result)
+{
+    game gameState;
+    vector choices;
+    RngState rng;
+    rng_seed(&rng, seed, gameIndex);
+    RngState *previous = rng_get_active();
+    rng_set_active(&rng);
+    init_duel(&gameState, characters[0], characters[1]);
+
+    result->forfeit = -1;
+    result->turns = 0;
+    result->choices = 0;
+    for (int seat = 0; seat < 2; seat++)
+        write_all(engines[seat]->toEngine, "newgame\n", 8);
+
+    while (result->turns < maxTurns)
+    {
+        get_legal_choices(&gameState, &choices);
+        if (choices.SIZE == 0)
+            break;
+
+        int8_t mover = gameState.now_turn_player_id;
+        int32_t choice;
+        if (!engine_choose(engines[mover], &gameState, limits, timeoutMs, &choice) ||
+            findVector(&choices, choice) < 0 || !apply_choice(&gameState, choice))
+        {
+            WARN_LOG("Engine %s forfeits game %llu (no reply or illegal choice)", engines[mover]->name,
+                     (unsigned long long)gameIndex);
+            result->forfeit = mover;
+            break;
+        }
+        result->choices++;
+        if (gameState.now_turn_player_id != mover)
+            result->turns++;
+    }
+
+    result->winner = result->forfeit >= 0 ? (int8_t)(1 - result->forfeit) : (int8_t)get_winner(&gameState);
+    rng_set_active(previous);
+}
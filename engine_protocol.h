@@ -0,0 +1,82 @@
+#ifndef _ENGINE_PROTOCOL_H
+#define _ENGINE_PROTOCOL_H
+
+#include <stdio.h>
+#include <sys/types.h>
+#include "architecture.h"
+#include "bot.h"
+#include "search.h"
+
+// 外部引擎的文字協定（TFP，類似 UCI），每行一個命令，以 stdin/stdout 溝通
+//
+// 控制端 → 引擎：
+//   tfp                       引擎回覆 "id name NAME" 後回覆 "tfpok"
+//   isready                   引擎回覆 "readyok"
+//   newgame                   重設引擎的亂數
+//   position STATE            設定局面（STATE 為 encode_game_text 的結果）
+//   go [movetime MS] [nodes N] [depth D]
+//                             引擎可先回覆 "info depth D nodes N score S"，最後回覆 "bestchoice C"
+//                             （沒有局面或沒有合法選擇時回覆 "bestchoice none"）
+//   quit                      結束
+// 引擎自行由局面產生合法選擇；不認得的命令回覆 "info string unknown command ..." 後忽略
+//
+// 每一步都傳送完整局面：回合結束時的洗牌使用控制端的亂數，只傳選擇無法讓引擎重現局面
+
+#define ENGINE_LINE_MAX 4096
+
+// go 的限制，0 表示使用引擎的預設值
+typedef struct {
+    uint32_t moveTimeMs;
+    uint64_t nodeLimit;
+    int maxDepth;
+} EngineLimits;
+
+// 引擎端設定
+typedef struct {
+    const char* name;          // id name 回覆的名稱
+    const BotPolicy* bot;      // 不為 NULL 時以這個策略選擇（忽略 go 的限制）
+    SearchConfig search;       // bot 為 NULL 時使用搜尋，go 的限制覆蓋對應的設定
+    uint64_t seed;             // 亂數種子，newgame 時重設
+} EngineOptions;
+
+// 預設：使用 init_search_config 的搜尋，種子 1
+void init_engine_options(EngineOptions* options);
+
+// 讀取命令直到 quit 或輸入結束；回傳處理的 go 命令數
+uint64_t run_engine_loop(const EngineOptions* options, FILE* in, FILE* out);
+
+// 控制端：以 sh -c 啟動的外部引擎
+typedef struct {
+    pid_t pid;
+    int toEngine;       // 寫入引擎 stdin
+    int fromEngine;     // 讀取引擎 stdout
+    char name[64];      // 引擎回覆的名稱
+    char buffer[ENGINE_LINE_MAX];
+    size_t buffered;
+} ExternalEngine;
+
+// 啟動引擎並完成 tfp / isready 交握（timeoutMs 為等待每個回覆的時間）
+// 失敗時回傳 false（錯誤寫入日誌），不需要再呼叫 engine_stop
+bool engine_start(ExternalEngine* engine, const char* command, uint32_t timeoutMs);
+
+// 送出 quit 並等待引擎結束（逾時則強制結束）
+void engine_stop(ExternalEngine* engine);
+
+// 送出 position 與 go，等待 bestchoice；逾時、引擎結束或回覆無法解析時回傳 false
+bool engine_choose(ExternalEngine* engine, game* gameState, const EngineLimits* limits, uint32_t timeoutMs,
+                   int32_t* choice);
+
+// 外部引擎對戰的單場結果
+typedef struct {
+    int8_t winner;     // 0/1，平手為 -1
+    int8_t forfeit;    // 因逾時或不合法選擇判負的座位，沒有則為 -1
+    uint32_t turns;
+    uint32_t choices;
+} EngineGameResult;
+
+// 以 (seed, gameIndex) 的亂數串流進行一場對戰，engines[i] 為座位 i
+// 引擎逾時或回覆不合法的選擇時判負
+void play_engine_game(ExternalEngine* engines[2], const uint8_t characters[2], uint64_t seed, uint64_t gameIndex,
+                      const EngineLimits* limits, uint32_t timeoutMs, uint32_t maxTurns, EngineGameResult* result);
+
+#endif // _ENGINE_PROTOCOL_H
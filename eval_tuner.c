@@ -0,0 +1,161 @@
+#include <math.h>
+#include <pthread.h>
+#include "eval_tuner.h"
+#include "character_system.h"
+#include "simulation.h"
+
+// 每個任務進行的成對對戰組數
+#define TUNER_CHUNK_PAIRS 4
+
+typedef struct {
+    const TunerConfig *config;
+    SearchConfig searches[2];  // 0 為 θ+，1 為 θ-
+    EvalWeights weights[2];
+    BotPolicy bots[2];
+    uint64_t pairs;
+    uint64_t firstStream;
+    pthread_mutex_t lock;
+    int64_t score;             // θ+ 勝場數減 θ- 勝場數
+} TunerRound;
+
+static int32_t tuned_choose(void *ctx, game *gs, vector *choices, RngState *rng)
+{
+    SearchResult result;
+    return search_choose(ctx, gs, choices, rng, &result);
+}
+
+void init_tuner_config(TunerConfig *config)
+{
+    init_eval_weights(&config->start);
+    config->iterations = 100;
+    config->gamesPerIteration = 200;
+    config->a = 0.1;
+    config->c = 0.2;
+    config->bigA = 10.0;
+    config->alpha = 0.602;
+    config->gamma = 0.101;
+    init_search_config(&config->search);
+    config->search.maxDepth = 2;
+    config->search.nodeLimit = 500;
+    config->seed = 1;
+    config->maxTurns = SIM_DEFAULT_MAX_TURNS;
+    config->threads = 0;
+}
+
+// 第 j 組：同一組角色與亂數串流，θ+ 各坐先手、後手一次
+static void play_round_chunk(void *ctx, size_t task)
+{
+    TunerRound *round = ctx;
+    uint64_t first = (uint64_t)task * TUNER_CHUNK_PAIRS;
+    uint64_t last = first + TUNER_CHUNK_PAIRS < round->pairs ? first + TUNER_CHUNK_PAIRS : round->pairs;
+
+    int64_t score = 0;
+    for (uint64_t j = first; j < last; j++)
+    {
+        for (int seatPlus = 0; seatPlus < 2; seatPlus++)
+        {
+            SimConfig sim;
+            sim_init_config(&sim);
+            sim.characters[0] = (uint8_t)(j % CHARACTER_COUNT);
+            sim.characters[1] = (uint8_t)((j / CHARACTER_COUNT) % CHARACTER_COUNT);
+            sim.bots[seatPlus] = &round->bots[0];
+            sim.bots[1 - seatPlus] = &round->bots[1];
+            sim.seed = round->config->seed;
+            sim.maxTurns = round->config->maxTurns;
+
+            SimGameResult result;
+            sim_play_game(&sim, round->firstStream + j, &result);
+            if (result.winner >= 0)
+                score += result.winner == seatPlus ? 1 : -1;
+        }
+    }
+
+    pthread_mutex_lock(&round->lock);
+    round->score += score;
+    pthread_mutex_unlock(&round->lock);
+}
+
+static void to_weights(const double *x, const double *scale, EvalWeights *weights)
+{
+    for (int i = 0; i < EVAL_WEIGHT_COUNT; i++)
+        *eval_weight_at(weights, i) = (int32_t)lround(x[i] * scale[i]);
+}
+
+void run_eval_tuner(const TunerConfig *config, TunerProgressFn progress, void *progressCtx, EvalWeights *result)
+{
+    // 以初始值的大小正規化，所有權重的擾動都是相對比例
+    // 很小的權重（包含 0）至少以 1/c 正規化，第一輪的擾動至少是一個整數單位
+    EvalWeights start = config->start;
+    double minScale = config->c > 0 ? 1.0 / config->c : 1.0;
+    double scale[EVAL_WEIGHT_COUNT];
+    double x[EVAL_WEIGHT_COUNT];
+    for (int i = 0; i < EVAL_WEIGHT_COUNT; i++)
+    {
+        int32_t value = *eval_weight_at(&start, i);
+        scale[i] = fmax(fabs((double)value), minScale);
+        x[i] = value / scale[i];
+    }
+
+    TunerRound *round = malloc(sizeof(TunerRound));
+    if (round == NULL)
+    {
+        *result = start;
+        return;
+    }
+    round->config = config;
+    round->pairs = (config->gamesPerIteration + 1) / 2;
+    pthread_mutex_init(&round->lock, NULL);
+    for (int side = 0; side < 2; side++)
+    {
+        round->searches[side] = config->search;
+        round->searches[side].eval = evaluate_game;
+        round->searches[side].evalCtx = &round->weights[side];
+        round->searches[side].table = NULL;
+        round->bots[side].name = side == 0 ? "tune+" : "tune-";
+        round->bots[side].description = "SPSA perturbed search";
+        round->bots[side].choose = tuned_choose;
+        round->bots[side].ctx = &round->searches[side];
+    }
+
+    RngState rng;
+    rng_seed(&rng, config->seed, 0);
+    for (uint32_t k = 0; k < config->iterations; k++)
+    {
+        double ak = config->a / pow(config->bigA + k + 1, config->alpha);
+        double ck = config->c / pow(k + 1, config->gamma);
+        double delta[EVAL_WEIGHT_COUNT];
+        double cki[EVAL_WEIGHT_COUNT];
+        to_weights(x, scale, &round->weights[0]);
+        round->weights[1] = round->weights[0];
+        for (int i = 0; i < EVAL_WEIGHT_COUNT; i++)
+        {
+            // 擾動以整數權重為單位且至少為 1，否則 θ+ 與 θ- 四捨五入後相同；梯度以實際的擾動量估計
+            double step = fmax(nearbyint(ck * scale[i]), 1.0);
+            delta[i] = rng_bounded(&rng, 2) == 0 ? -1.0 : 1.0;
+            cki[i] = step / scale[i];
+            *eval_weight_at(&round->weights[0], i) += (int32_t)(step * delta[i]);
+            *eval_weight_at(&round->weights[1], i) -= (int32_t)(step * delta[i]);
+        }
+
+        round->score = 0;
+        round->firstStream = (uint64_t)k * round->pairs;
+        sim_parallel_for((round->pairs + TUNER_CHUNK_PAIRS - 1) / TUNER_CHUNK_PAIRS, config->threads,
+                         play_round_chunk, round);
+
+        // 得分差（-1 到 1）當作 f(θ+) - f(θ-) 的估計，往提高勝率的方向更新
+        double score = (double)round->score / (double)(2 * round->pairs);
+        for (int i = 0; i < EVAL_WEIGHT_COUNT; i++)
+            x[i] += ak * score / (2.0 * cki[i] * delta[i]);
+
+        if (progress != NULL)
+        {
+            EvalWeights current;
+            to_weights(x, scale, &current);
+            progress(progressCtx, k, score, &current);
+        }
+    }
+
+    to_weights(x, scale, result);
+    pthread_mutex_destroy(&round->lock);
+    free(round);
+}
@@ -0,0 +1,37 @@
+#ifndef _EVAL_TUNER_H
+#define _EVAL_TUNER_H
+
+#include "architecture.h"
+#include "search.h"
+
+// 以 SPSA 調整 evaluate_game 的權重
+// 每一輪以亂數方向 Δ（每項 ±1）同時擾動所有權重，θ+cΔ 與 θ-cΔ 兩個搜尋電腦對戰，
+// 由勝率差估計梯度後更新 θ；每項權重以初始值的大小正規化，擾動與步長都是相對比例
+// 擾動四捨五入到整數權重且至少為 1，初始為 0 或很小的權重也會被擾動與調整
+// 對戰成對進行：同一組角色與亂數串流各坐先後手一次，降低雜訊
+
+typedef struct {
+    EvalWeights start;      // 起始權重
+    uint32_t iterations;
+    uint32_t gamesPerIteration;  // 每輪場數（偶數）
+    double a;               // 步長 a_k = a / (A + k + 1)^alpha
+    double c;               // 擾動 c_k = c / (k + 1)^gamma（相對於初始值）
+    double bigA;
+    double alpha;
+    double gamma;
+    SearchConfig search;    // 對戰使用的搜尋設定（eval 與 evalCtx 由調整工具設定）
+    uint64_t seed;
+    uint32_t maxTurns;
+    int threads;            // 0 表示使用全部核心；結果與執行緒數無關
+} TunerConfig;
+
+// 每一輪結束時呼叫：score 為 θ+ 對 θ- 的得分差（-1 到 1），weights 為更新後的權重
+typedef void (*TunerProgressFn)(void* ctx, uint32_t iteration, double score, const EvalWeights* weights);
+
+// 預設：預設權重起始、100 輪、每輪 200 場、深度 2、500 節點、a = 0.1、c = 0.2、A = 10
+void init_tuner_config(TunerConfig* config);
+
+// 執行 SPSA，結果寫入 result
+void run_eval_tuner(const TunerConfig* config, TunerProgressFn progress, void* progressCtx, EvalWeights* result);
+
+#endif // _EVAL_TUNER_H
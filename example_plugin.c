@@ -0,0 +1,78 @@
+// 電腦玩家外掛範例：只依賴 bot_plugin.h
+// 編譯：gcc -std=c11 -shared -fPIC -o example_plugin.so example_plugin.c
+// 使用：./twisted_sim run --plugin example_plugin.so:30 --bots example greedy
+// ARGS 為結束回合的機率（百分比，預設 20）：在選擇行動時盡量繼續行動，其他狀態隨機選擇
+#include <stdlib.h>
+#include "bot_plugin.h"
+
+// architecture.h 的 enum state 與 CHOOSE_MOVE 的選擇編碼
+#define EXAMPLE_CHOOSE_MOVE 5
+#define EXAMPLE_MOVE_END 10
+
+typedef struct {
+    uint32_t endPercent;
+} ExampleBot;
+
+static void *example_create(const char *args)
+{
+    ExampleBot *bot = malloc(sizeof(ExampleBot));
+    if (bot == NULL)
+        return NULL;
+    bot->endPercent = args[0] != '\0' ? (uint32_t)strtoul(args, NULL, 10) : 20;
+    if (bot->endPercent > 100)
+    {
+        free(bot);
+        return NULL;
+    }
+    return bot;
+}
+
+// 只讀取 instance 的設定，可同時被多個執行緒呼叫
+static int32_t example_choose(void *instance, const TfGameView *view, const int32_t *choices, uint32_t choiceCount,
+                              uint64_t random)
+{
+    const ExampleBot *bot = instance;
+    uint32_t pick = (uint32_t)(random >> 32);
+    if (view->status != EXAMPLE_CHOOSE_MOVE || choiceCount == 1)
+        return choices[pick % choiceCount];
+
+    uint32_t ends = 0;
+    for (uint32_t i = 0; i < choiceCount; i++)
+        ends += choices[i] == EXAMPLE_MOVE_END;
+    if (ends > 0 && (uint32_t)(random % 100) < bot->endPercent)
+        return EXAMPLE_MOVE_END;
+
+    // 在其他選擇中隨機挑一個
+    uint32_t index = pick % (choiceCount - ends);
+    for (uint32_t i = 0; i < choiceCount; i++)
+    {
+        if (choices[i] == EXAMPLE_MOVE_END)
+            continue;
+        if (index-- == 0)
+            return choices[i];
+    }
+    return choices[0];
+}
+
+static void example_destroy(void *instance)
+{
+    free(instance);
+}
+
+static const TfBotPlugin examplePlugin = {
+    sizeof(TfBotPlugin),
+    TF_PLUGIN_ABI_VERSION,
+    0,
+    "example",
+    "Example plugin: random, keeps acting before ending the turn",
+    example_create,
+    example_choose,
+    example_destroy,
+};
+
+const TfBotPlugin *tf_bot_plugin(void);
+
+const TfBotPlugin *tf_bot_plugin(void)
+{
+    return &examplePlugin;
+}
@@ -0,0 +1,498 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include "game_action.h"
+#include "card_combination.h"
+#include "card_effect.h"
+#include "debug_log.h"
+#include "game_state.h"
+#include "utils.h"
+
+// game 中所有向量的位置，依宣告順序（遞增）排列
+#define PLAYER_VECTOR_OFFSETS(i)                                                                           \
+    offsetof(game, players[i].hand), offsetof(game, players[i].deck), offsetof(game, players[i].usecards),   \
+        offsetof(game, players[i].graveyard), offsetof(game, players[i].metamorphosis),                     \
+        offsetof(game, players[i].attackSkill), offsetof(game, players[i].defenseSkill),                    \
+        offsetof(game, players[i].moveSkill), offsetof(game, players[i].specialDeck),                       \
+        offsetof(game, players[i].snowWhite.remindPosion),                                                  \
+        offsetof(game, players[i].scheherazade.destiny_TOKEN_locate),                                       \
+        offsetof(game, players[i].scheherazade.destiny_TOKEN_type)
+
+#define BUY_DECK_OFFSETS(type)                                                                              \
+    offsetof(game, basicBuyDeck[type][0]), offsetof(game, basicBuyDeck[type][1]),                           \
+        offsetof(game, basicBuyDeck[type][2])
+
+static const size_t gameVectorOffsets[] = {
+    PLAYER_VECTOR_OFFSETS(0), PLAYER_VECTOR_OFFSETS(1), PLAYER_VECTOR_OFFSETS(2), PLAYER_VECTOR_OFFSETS(3),
+    offsetof(game, tentacle_TOKEN_locate), offsetof(game, relicDeck), offsetof(game, relicGraveyard),
+    BUY_DECK_OFFSETS(0), BUY_DECK_OFFSETS(1), BUY_DECK_OFFSETS(2), BUY_DECK_OFFSETS(3),
+    offsetof(game, nowShowingCards),
+};
+
+void clone_game(game *dst, const game *src)
+{
+    // 向量之間的欄位整段複製，向量只複製 SIZE 與使用中的元素
+    size_t pos = 0;
+    for (size_t i = 0; i < sizeof(gameVectorOffsets) / sizeof(size_t); i++)
+    {
+        size_t offset = gameVectorOffsets[i];
+        memcpy((char *)dst + pos, (const char *)src + pos, offset - pos);
+        const vector *from = (const vector *)((const char *)src + offset);
+        vector *to = (vector *)((char *)dst + offset);
+        uint32_t used = from->SIZE < 256 ? from->SIZE : 256;
+        memcpy(to->array, from->array, used * sizeof(int32_t));
+        to->SIZE = from->SIZE;
+        pos = offset + sizeof(vector);
+    }
+    memcpy((char *)dst + pos, (const char *)src + pos, sizeof(game) - pos);
+}
+
+static int opponent_of(game *gs)
+{
+    return (gs->now_turn_player_id + 1) % 2;
+}
+
+static bool is_basic_type(CardType type)
+{
+    return type <= CARD_TYPE_BASIC_GENERAL;
+}
+
+static bool is_skill_type(CardType type)
+{
+    return type >= CARD_TYPE_SKILL_ATK && type <= CARD_TYPE_SKILL_MOV;
+}
+
+// 通用牌視做lv1的任意基本牌
+static bool card_counts_as(int32_t cardId, CardType type)
+{
+    CardType actual = get_card_type(cardId);
+    return actual == type || actual == CARD_TYPE_BASIC_GENERAL;
+}
+
+// 與對手的曼哈頓距離；攻擊牌的射程（get_card_range）不小於距離時才能使用
+static int32_t opponent_distance(game *gs)
+{
+    player *me = &gs->players[gs->now_turn_player_id];
+    player *opp = &gs->players[opponent_of(gs)];
+    return abs(me->locate[0] - opp->locate[0]) + abs(me->locate[1] - opp->locate[1]);
+}
+
+// 同一種卡牌只列出第一張（效果相同）
+static bool seen_before(vector *hand, uint32_t index)
+{
+    for (uint32_t i = 0; i < index; i++)
+    {
+        if (hand->array[i] == hand->array[index])
+            return true;
+    }
+    return false;
+}
+
+// distance 為攻擊距離，非攻擊用途傳入 0（所有牌的射程都不小於 0）
+static void push_matching_cards(player *p, CardType type, int32_t distance, vector *choices)
+{
+    for (uint32_t i = 0; i < p->hand.SIZE; i++)
+    {
+        if (card_counts_as(p->hand.array[i], type) && get_card_range(p->hand.array[i]) >= distance &&
+            !seen_before(&p->hand, i))
+            vector_pushback(choices, (int32_t)i + 1);
+    }
+}
+
+static bool has_matching_card(player *p, CardType type, int32_t distance)
+{
+    for (uint32_t i = 0; i < p->hand.SIZE; i++)
+    {
+        if (card_counts_as(p->hand.array[i], type) && get_card_range(p->hand.array[i]) >= distance)
+            return true;
+    }
+    return false;
+}
+
+// 技能牌是否能搭配手牌中的某張基本牌使用
+static bool skill_has_partner(game *gs, player *p, uint32_t skillIndex)
+{
+    int32_t skillCard = p->hand.array[skillIndex];
+    if (get_card_type(skillCard) == CARD_TYPE_SKILL_ATK && get_card_range(skillCard) < opponent_distance(gs))
+        return false;
+
+    for (uint32_t i = 0; i < p->hand.SIZE; i++)
+    {
+        if (i == skillIndex || !is_basic_type(get_card_type(p->hand.array[i])))
+            continue;
+        if (cards_can_combine(skillCard, p->hand.array[i]))
+            return true;
+    }
+    return false;
+}
+
+static bool any_skill_usable(game *gs, player *p)
+{
+    for (uint32_t i = 0; i < p->hand.SIZE; i++)
+    {
+        if (is_skill_type(get_card_type(p->hand.array[i])) && skill_has_partner(gs, p, i))
+            return true;
+    }
+    return false;
+}
+
+static vector *skill_supply(player *p, int32_t buyChoice)
+{
+    switch (buyChoice)
+    {
+    case -1:
+        return &p->attackSkill;
+    case -2:
+        return &p->defenseSkill;
+    case -3:
+        return &p->moveSkill;
+    default:
+        return NULL;
+    }
+}
+
+static vector *basic_supply(game *gs, int32_t buyChoice, CardLevel *level)
+{
+    if (buyChoice == 10)
+    {
+        *level = CARD_LEVEL_1;
+        return &gs->basicBuyDeck[3][0];
+    }
+    *level = (CardLevel)((buyChoice - 1) % 3);
+    return &gs->basicBuyDeck[(buyChoice - 1) / 3][(buyChoice - 1) % 3];
+}
+
+int32_t get_purchase_cost(game *gs, int32_t buyChoice)
+{
+    player *p = &gs->players[gs->now_turn_player_id];
+    int32_t cost;
+
+    if (buyChoice >= -3 && buyChoice <= -1)
+    {
+        // 技能供應牌庫的第一張是開局時已放入牌堆的1階技能
+        vector *supply = skill_supply(p, buyChoice);
+        if (supply->SIZE <= 1)
+            return -1;
+        cost = get_card_cost(supply->array[1]);
+    }
+    else if (buyChoice >= 1 && buyChoice <= 10)
+    {
+        CardLevel level;
+        vector *supply = basic_supply(gs, buyChoice, &level);
+        if (supply->SIZE == 0)
+            return -1;
+        cost = get_card_cost(supply->array[supply->SIZE - 1]);
+    }
+    else
+    {
+        return -1;
+    }
+
+    return p->energy >= cost ? cost : -1;
+}
+
+int32_t get_purchase_card(game *gs, int32_t buyChoice)
+{
+    player *p = &gs->players[gs->now_turn_player_id];
+
+    if (buyChoice >= -3 && buyChoice <= -1)
+    {
+        vector *supply = skill_supply(p, buyChoice);
+        return supply->SIZE > 1 ? supply->array[1] : 0;
+    }
+    if (buyChoice >= 1 && buyChoice <= 10)
+    {
+        // 從牌組頂部（尾端）購買
+        CardLevel level;
+        vector *supply = basic_supply(gs, buyChoice, &level);
+        return supply->SIZE > 0 ? supply->array[supply->SIZE - 1] : 0;
+    }
+    return 0;
+}
+
+static bool any_purchase_affordable(game *gs)
+{
+    for (int32_t c = -3; c <= 10; c++)
+    {
+        if (c != 0 && get_purchase_cost(gs, c) >= 0)
+            return true;
+    }
+    return false;
+}
+
+// 必須移動X格，除非會重疊或到達場地邊緣；可以穿過對手
+static void move_current_player(game *gs, int8_t right, int32_t distance)
+{
+    player *p = &gs->players[gs->now_turn_player_id];
+    int dir = right ? 1 : -1;
+    int target = p->locate[0] + dir * distance;
+
+    if (target < TRACK_MIN)
+        target = TRACK_MIN;
+    if (target > TRACK_MAX)
+        target = TRACK_MAX;
+    if (target == gs->players[opponent_of(gs)].locate[0])
+        target -= dir;
+
+    p->locate[0] = (uint8_t)target;
+}
+
+static void list_choose_move(game *gs, player *p, vector *choices)
+{
+    vector_pushback(choices, 0);
+    if (has_matching_card(p, CARD_TYPE_BASIC_ATK, opponent_distance(gs)))
+        vector_pushback(choices, 1);
+    if (has_matching_card(p, CARD_TYPE_BASIC_DEF, 0))
+        vector_pushback(choices, 2);
+    if (has_matching_card(p, CARD_TYPE_BASIC_MOV, 0))
+        vector_pushback(choices, 3);
+    if (any_skill_usable(gs, p))
+        vector_pushback(choices, 4);
+    if (any_purchase_affordable(gs))
+        vector_pushback(choices, 6);
+    vector_pushback(choices, 10);
+}
+
+void get_legal_choices(game *gs, vector *choices)
+{
+    clearVector(choices);
+    if (get_winner(gs) >= 0)
+        return;
+
+    player *p = &gs->players[gs->now_turn_player_id];
+
+    switch (gs->status)
+    {
+    case CHOOSE_MOVE:
+        list_choose_move(gs, p, choices);
+        break;
+
+    case REMOVE_HG:
+        // 專注：從手牌或棄牌堆移除一張牌（沒有牌可移除時只能直接結束）
+        for (uint32_t i = 0; i < p->hand.SIZE; i++)
+        {
+            if (!seen_before(&p->hand, i))
+                vector_pushback(choices, (int32_t)i + 1);
+        }
+        for (uint32_t i = 0; i < p->graveyard.SIZE; i++)
+        {
+            if (!seen_before(&p->graveyard, i))
+                vector_pushback(choices, -((int32_t)i + 1));
+        }
+        if (choices->SIZE == 0)
+            vector_pushback(choices, 0);
+        break;
+
+    case USE_ATK:
+    case USE_DEF:
+    case USE_MOV:
+    {
+        // 至少打出一張牌之後才能停止
+        if (gs->nowUsingCardID != 0)
+            vector_pushback(choices, 0);
+        CardType type = gs->status == USE_ATK   ? CARD_TYPE_BASIC_ATK
+                        : gs->status == USE_DEF ? CARD_TYPE_BASIC_DEF
+                                                : CARD_TYPE_BASIC_MOV;
+        push_matching_cards(p, type, type == CARD_TYPE_BASIC_ATK ? opponent_distance(gs) : 0, choices);
+        break;
+    }
+
+    case CHOOSE_MOVING_DIR:
+        vector_pushback(choices, 0);
+        vector_pushback(choices, 1);
+        break;
+
+    case USE_SKILL:
+        for (uint32_t i = 0; i < p->hand.SIZE; i++)
+        {
+            if (is_skill_type(get_card_type(p->hand.array[i])) && !seen_before(&p->hand, i) &&
+                skill_has_partner(gs, p, i))
+                vector_pushback(choices, (int32_t)i + 1);
+        }
+        break;
+
+    case USEBASIC:
+    {
+        int skillIndex = findVector(&p->hand, gs->nowUsingCardID);
+        for (uint32_t i = 0; i < p->hand.SIZE; i++)
+        {
+            int32_t cardId = p->hand.array[i];
+            if ((int)i == skillIndex || !is_basic_type(get_card_type(cardId)) || seen_before(&p->hand, i))
+                continue;
+            if (cards_can_combine(gs->nowUsingCardID, cardId))
+                vector_pushback(choices, (int32_t)i + 1);
+        }
+        break;
+    }
+
+    case BUY_CARD_TYPE:
+        for (int32_t c = -3; c <= 10; c++)
+        {
+            if (c != 0 && get_purchase_cost(gs, c) >= 0)
+                vector_pushback(choices, c);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void do_choose_move(game *gs, int32_t choice)
+{
+    switch (choice)
+    {
+    case 0:
+        gs->status = REMOVE_HG;
+        break;
+    case 1:
+        gs->status = USE_ATK;
+        break;
+    case 2:
+        gs->status = USE_DEF;
+        break;
+    case 3:
+        gs->status = USE_MOV;
+        break;
+    case 4:
+        gs->status = USE_SKILL;
+        break;
+    case 6:
+        gs->status = BUY_CARD_TYPE;
+        break;
+    case 10:
+        end_turn(gs);
+        break;
+    }
+    gs->nowUsingCardID = 0;
+}
+
+static void do_use_basic(game *gs, player *p, int32_t choice)
+{
+    if (choice == 0)
+    {
+        gs->status = CHOOSE_MOVE;
+        gs->nowUsingCardID = 0;
+        return;
+    }
+
+    int32_t cardId = p->hand.array[choice - 1];
+    eraseVector(&p->hand, choice - 1);
+    vector_pushback(&p->usecards, cardId);
+    gs->nowUsingCardID = cardId;
+
+    // 基本牌行動會獲得等同數值的能量（見 card_effect.c 的基本牌程式）
+    EffectUse use = gs->status == USE_ATK ? EFFECT_USE_ATTACK : gs->status == USE_DEF ? EFFECT_USE_DEFENSE : EFFECT_USE_MOVE;
+    if (run_basic_effect(gs, use, cardId))
+        gs->status = CHOOSE_MOVING_DIR;
+}
+
+static void do_use_skill_basic(game *gs, player *p, int32_t choice)
+{
+    int32_t skillCard = gs->nowUsingCardID;
+    int32_t basicCard = p->hand.array[choice - 1];
+    int skillIndex = findVector(&p->hand, skillCard);
+
+    // 先移除索引較大的牌，避免索引位移
+    int first = skillIndex > choice - 1 ? skillIndex : choice - 1;
+    int second = skillIndex > choice - 1 ? choice - 1 : skillIndex;
+    eraseVector(&p->hand, first);
+    eraseVector(&p->hand, second);
+    vector_pushback(&p->usecards, skillCard);
+    vector_pushback(&p->usecards, basicCard);
+
+    // 此行動不會因為基本牌獲得能量；效果由卡牌的效果程式決定
+    gs->status = run_skill_effect(gs, skillCard, basicCard) ? CHOOSE_MOVING_DIR : CHOOSE_MOVE;
+}
+
+static void do_buy(game *gs, player *p, int32_t choice)
+{
+    int32_t cost = get_purchase_cost(gs, choice);
+
+    if (choice < 0)
+    {
+        vector *supply = skill_supply(p, choice);
+        p->energy -= (uint8_t)cost;
+        vector_pushback(&p->graveyard, supply->array[1]);
+        eraseVector(supply, 1);
+    }
+    else if (choice == 10)
+    {
+        buy_card(gs, CARD_TYPE_BASIC_GENERAL, CARD_LEVEL_1);
+    }
+    else
+    {
+        buy_card(gs, (CardType)((choice - 1) / 3), (CardLevel)((choice - 1) % 3));
+    }
+    gs->status = CHOOSE_MOVE;
+}
+
+bool apply_choice(game *gs, int32_t choice)
+{
+    vector legal;
+    get_legal_choices(gs, &legal);
+    if (findVector(&legal, choice) < 0)
+    {
+        DEBUG_LOG("Illegal choice: State=%d, Choice=%d", gs->status, choice);
+        return false;
+    }
+
+    player *p = &gs->players[gs->now_turn_player_id];
+
+    switch (gs->status)
+    {
+    case CHOOSE_MOVE:
+        do_choose_move(gs, choice);
+        break;
+
+    case REMOVE_HG:
+        // 專注會跳過整個行動階段
+        if (choice > 0)
+            eraseVector(&p->hand, choice - 1);
+        else if (choice < 0)
+            eraseVector(&p->graveyard, -choice - 1);
+        gs->status = CHOOSE_MOVE;
+        end_turn(gs);
+        break;
+
+    case USE_ATK:
+    case USE_DEF:
+    case USE_MOV:
+        do_use_basic(gs, p, choice);
+        break;
+
+    case CHOOSE_MOVING_DIR:
+        move_current_player(gs, (int8_t)choice, gs->nowMOV);
+        // 技能移動結束後回到行動選擇，基本移動可以繼續出移動牌
+        gs->status = is_skill_type(get_card_type(gs->nowUsingCardID)) ? CHOOSE_MOVE : USE_MOV;
+        break;
+
+    case USE_SKILL:
+        gs->nowUsingCardID = p->hand.array[choice - 1];
+        gs->status = USEBASIC;
+        break;
+
+    case USEBASIC:
+        do_use_skill_basic(gs, p, choice);
+        break;
+
+    case BUY_CARD_TYPE:
+        do_buy(gs, p, choice);
+        break;
+
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+int get_winner(game *gs)
+{
+    if (gs->players[0].character == UINT8_MAX || gs->players[1].character == UINT8_MAX)
+        return -1;
+    if (gs->players[0].life == 0)
+        return 1;
+    if (gs->players[1].life == 0)
+        return 0;
+    return -1;
+}
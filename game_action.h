@@ -0,0 +1,34 @@
+#ifndef _GAME_ACTION_H
+#define _GAME_ACTION_H
+
+#include "architecture.h"
+
+// 能量上限
+#define ENERGY_LIMIT 25
+
+// 1v1 戰鬥軌道範圍
+#define TRACK_MIN 1
+#define TRACK_MAX 9
+
+// 列出目前狀態下所有合法的選擇
+// 選擇的編碼與 architecture.h 的狀態說明表相同；效果相同的選擇（同一種卡牌）只列出一次
+void get_legal_choices(game* gameState, vector* choices);
+
+// 不經由 stdin/stdout 套用一個選擇（模擬與AI使用）
+// 非法的選擇回傳 false，且不改變遊戲狀態
+bool apply_choice(game* gameState, int32_t choice);
+
+// 複製局面：向量只複製已使用的部分（一般局面只需完整複製的一小部分）
+// 搜尋、rollout 與行動預覽都以「複製後套用」探索選擇；dst 與 src 不可重疊
+void clone_game(game* dst, const game* src);
+
+// 購買選項的能量花費（-1,-2,-3:技能 1~10:基本牌），無法購買時回傳 -1
+int32_t get_purchase_cost(game* gameState, int32_t buyChoice);
+
+// 購買選項會買到的卡牌ID，無牌可買時回傳 0
+int32_t get_purchase_card(game* gameState, int32_t buyChoice);
+
+// 回傳勝利的玩家編號，尚未分出勝負時回傳 -1
+int get_winner(game* gameState);
+
+#endif // _GAME_ACTION_H
@@ -0,0 +1,266 @@
+#include "game_codec.h"
+#include "card_system.h"
+#include "character_system.h"
+#include "game_action.h"
+
+// 編碼與解碼共用同一個欄位列表（visit_game），欄位順序只需要寫一次
+typedef struct {
+    uint8_t *data;        // 編碼時寫入
+    const uint8_t *input; // 解碼時讀取
+    size_t size;
+    size_t pos;
+    bool decoding;
+    bool failed;
+} Codec;
+
+static void put_byte(Codec *c, uint8_t byte)
+{
+    if (c->pos == c->size)
+    {
+        c->failed = true;
+        return;
+    }
+    c->data[c->pos++] = byte;
+}
+
+static void code_value(Codec *c, int64_t *value)
+{
+    if (c->failed)
+        return;
+    if (!c->decoding)
+    {
+        uint64_t zigzag = ((uint64_t)*value << 1) ^ (uint64_t)(*value >> 63);
+        while (zigzag >= 0x80)
+        {
+            put_byte(c, (uint8_t)(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        put_byte(c, (uint8_t)zigzag);
+        return;
+    }
+
+    uint64_t zigzag = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (c->pos == c->size)
+            break;
+        uint8_t byte = c->input[c->pos++];
+        zigzag |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            *value = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+            return;
+        }
+    }
+    c->failed = true;
+}
+
+// 解碼時檢查值是否在欄位型別的範圍內
+static void code_ranged(Codec *c, int64_t *value, int64_t min, int64_t max)
+{
+    code_value(c, value);
+    if (c->decoding && (*value < min || *value > max))
+        c->failed = true;
+}
+
+#define CODE_FIELD(c, field, min, max)              \
+    do                                              \
+    {                                               \
+        int64_t value_ = (field);                   \
+        code_ranged((c), &value_, (min), (max));    \
+        if ((c)->decoding && !(c)->failed)          \
+            (field) = value_;                       \
+    } while (0)
+
+#define CODE_U8(c, field) CODE_FIELD(c, field, 0, UINT8_MAX)
+#define CODE_I8(c, field) CODE_FIELD(c, field, INT8_MIN, INT8_MAX)
+#define CODE_U32(c, field) CODE_FIELD(c, field, 0, UINT32_MAX)
+#define CODE_I32(c, field) CODE_FIELD(c, field, INT32_MIN, INT32_MAX)
+
+static void code_vector(Codec *c, vector *vec)
+{
+    CODE_FIELD(c, vec->SIZE, 0, 256);
+    for (uint32_t i = 0; i < vec->SIZE && !c->failed; i++)
+        CODE_I32(c, vec->array[i]);
+}
+
+// 卡牌向量：每個元素都必須是合法的卡牌編號
+static void code_card_vector(Codec *c, vector *vec)
+{
+    CODE_FIELD(c, vec->SIZE, 0, 256);
+    for (uint32_t i = 0; i < vec->SIZE && !c->failed; i++)
+        CODE_FIELD(c, vec->array[i], 1, CARD_ID_MAX);
+}
+
+static void visit_player(Codec *c, player *p)
+{
+    CODE_I8(c, p->team);
+    CODE_FIELD(c, p->locate[0], TRACK_MIN, TRACK_MAX);
+    CODE_U8(c, p->locate[1]);
+    CODE_FIELD(c, p->character, 0, CHARACTER_COUNT - 1);
+    CODE_U8(c, p->maxlife);
+    CODE_U8(c, p->life);
+    CODE_U8(c, p->maxdefense);
+    CODE_U8(c, p->defense);
+    CODE_U8(c, p->energy);
+    CODE_U8(c, p->specialGate);
+    code_card_vector(c, &p->hand);
+    code_card_vector(c, &p->deck);
+    code_card_vector(c, &p->usecards);
+    code_card_vector(c, &p->graveyard);
+    code_card_vector(c, &p->metamorphosis);
+    code_card_vector(c, &p->attackSkill);
+    code_card_vector(c, &p->defenseSkill);
+    code_card_vector(c, &p->moveSkill);
+    code_card_vector(c, &p->specialDeck);
+
+    // 角色專屬狀態
+    for (int i = 0; i < 3; i++)
+        CODE_FIELD(c, p->redHood.saveCard[i], 0, CARD_ID_MAX);
+    code_card_vector(c, &p->snowWhite.remindPosion);
+    CODE_U32(c, p->sleepingBeauty.AWAKEN_TOKEN);
+    CODE_I8(c, p->sleepingBeauty.AWAKEN);
+    CODE_I8(c, p->sleepingBeauty.dayNightmareDrawRemind);
+    CODE_I32(c, p->sleepingBeauty.atkRise);
+    CODE_I32(c, p->sleepingBeauty.atkRiseTime);
+    CODE_I8(c, p->sleepingBeauty.usedmeta1);
+    CODE_U8(c, p->alice.identity);
+    CODE_I32(c, p->alice.riseBasic);
+    CODE_I32(c, p->alice.restartTurn);
+    CODE_I32(c, p->alice.havedrestart);
+    CODE_U32(c, p->mulan.KI_TOKEN);
+    CODE_U8(c, p->mulan.extraCard);
+    CODE_U8(c, p->mulan.extraDraw);
+    CODE_I8(c, p->kaguya.useDefenseAsATK);
+    CODE_I8(c, p->kaguya.useMoveTarget);
+    CODE_U32(c, p->matchGirl.remindMatch);
+    CODE_U32(c, p->matchGirl.pushedMatch);
+    CODE_U32(c, p->dorothy.COMBO_TOKEN);
+    CODE_I8(c, p->dorothy.canCombo);
+    code_vector(c, &p->scheherazade.destiny_TOKEN_locate);
+    code_vector(c, &p->scheherazade.destiny_TOKEN_type);
+    CODE_I8(c, p->scheherazade.selectToken);
+}
+
+static void visit_game(Codec *c, game *gs)
+{
+    int64_t version = GAME_CODEC_VERSION;
+    code_ranged(c, &version, GAME_CODEC_VERSION, GAME_CODEC_VERSION);
+    CODE_FIELD(c, gs->playerMode, 0, 1);
+    CODE_I8(c, gs->relicMode);
+    int playerCount = gs->playerMode == 1 ? 4 : 2;
+    CODE_FIELD(c, gs->now_turn_player_id, 0, playerCount - 1);
+    CODE_FIELD(c, gs->status, 0, USE_METAMORPHOSIS);
+    CODE_I32(c, gs->nowATK);
+    CODE_I32(c, gs->nowDEF);
+    CODE_I32(c, gs->nowMOV);
+    CODE_FIELD(c, gs->nowUsingCardID, 0, CARD_ID_MAX);
+    CODE_I32(c, gs->totalDamage);
+    code_card_vector(c, &gs->nowShowingCards);
+    code_vector(c, &gs->tentacle_TOKEN_locate);
+    for (int i = 0; i < 11; i++)
+        CODE_U32(c, gs->relic[i]);
+    code_vector(c, &gs->relicDeck);
+    code_vector(c, &gs->relicGraveyard);
+    for (int type = 0; type < 4; type++)
+    {
+        for (int level = 0; level < 3; level++)
+            code_card_vector(c, &gs->basicBuyDeck[type][level]);
+    }
+    for (int i = 0; i < playerCount && !c->failed; i++)
+        visit_player(c, &gs->players[i]);
+}
+
+size_t encode_game(game *gs, uint8_t *out, size_t capacity)
+{
+    Codec c = {out, NULL, capacity, 0, false, false};
+    visit_game(&c, gs);
+    return c.failed ? 0 : c.pos;
+}
+
+bool decode_game(const uint8_t *data, size_t size, game *gs)
+{
+    Codec c = {NULL, data, size, 0, true, false};
+    memset(gs, 0, sizeof(game));
+    visit_game(&c, gs);
+    return !c.failed && c.pos == size;
+}
+
+static const char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+static int base64_value(char ch)
+{
+    if (ch >= 'A' && ch <= 'Z')
+        return ch - 'A';
+    if (ch >= 'a' && ch <= 'z')
+        return ch - 'a' + 26;
+    if (ch >= '0' && ch <= '9')
+        return ch - '0' + 52;
+    if (ch == '-')
+        return 62;
+    if (ch == '_')
+        return 63;
+    return -1;
+}
+
+size_t encode_game_text(game *gs, char *out, size_t capacity)
+{
+    uint8_t *bytes = malloc(GAME_CODEC_MAX_BYTES);
+    if (bytes == NULL)
+        return 0;
+    size_t size = encode_game(gs, bytes, GAME_CODEC_MAX_BYTES);
+    size_t length = (size * 8 + 5) / 6;
+    if (size == 0 || length + 1 > capacity)
+    {
+        free(bytes);
+        return 0;
+    }
+
+    size_t o = 0;
+    uint32_t bits = 0;
+    int pending = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        bits = (bits << 8) | bytes[i];
+        pending += 8;
+        while (pending >= 6)
+        {
+            pending -= 6;
+            out[o++] = base64Chars[(bits >> pending) & 0x3F];
+        }
+    }
+    if (pending > 0)
+        out[o++] = base64Chars[(bits << (6 - pending)) & 0x3F];
+    out[o] = '\0';
+    free(bytes);
+    return o;
+}
+
+bool decode_game_text(const char *text, size_t length, game *gs)
+{
+    if (length > GAME_CODEC_MAX_TEXT)
+        return false;
+    uint8_t *bytes = malloc(length * 6 / 8 + 1);
+    if (bytes == NULL)
+        return false;
+
+    size_t size = 0;
+    uint32_t bits = 0;
+    int pending = 0;
+    bool ok = true;
+    for (size_t i = 0; ok && i < length; i++)
+    {
+        int value = base64_value(text[i]);
+        ok = value >= 0;
+        bits = (bits << 6) | (uint32_t)(value & 0x3F);
+        pending += 6;
+        if (pending >= 8)
+        {
+            pending -= 8;
+            bytes[size++] = (uint8_t)(bits >> pending);
+        }
+    }
+    ok = ok && decode_game(bytes, size, gs);
+    free(bytes);
+    return ok;
+}
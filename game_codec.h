@@ -0,0 +1,25 @@
+#ifndef _GAME_CODEC_H
+#define _GAME_CODEC_H
+
+#include "architecture.h"
+
+// 局面的精簡序列化（外部引擎協定、存檔使用）
+// 每個欄位以 zigzag varint 保存，向量只保存已使用的部分；一般局面約數百 bytes
+// 文字形式為 base64url（不含 '='），可放在一行文字中傳送
+
+#define GAME_CODEC_VERSION 1
+
+// 最大大小（所有向量全滿時），一般局面遠小於此
+#define GAME_CODEC_MAX_BYTES 65536
+#define GAME_CODEC_MAX_TEXT (GAME_CODEC_MAX_BYTES / 3 * 4 + 8)
+
+// 回傳寫入的 bytes 數，空間不足時回傳 0
+size_t encode_game(game* gameState, uint8_t* out, size_t capacity);
+// 資料不完整、有多餘資料或欄位超出範圍（含不存在的角色、卡牌編號與位置）時回傳 false
+bool decode_game(const uint8_t* data, size_t size, game* gameState);
+
+// 文字形式：回傳字元數（不含結尾的 '\0'），空間不足時回傳 0
+size_t encode_game_text(game* gameState, char* out, size_t capacity);
+bool decode_game_text(const char* text, size_t length, game* gameState);
+
+#endif // _GAME_CODEC_H
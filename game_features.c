@@ -0,0 +1,100 @@
+#include "game_features.h"
+
+static int8_t saturate(int64_t value)
+{
+    return value > INT8_MAX ? INT8_MAX : value < INT8_MIN ? INT8_MIN : (int8_t)value;
+}
+
+static void count_pile(int8_t *counts, vector *pile)
+{
+    for (uint32_t i = 0; i < pile->SIZE; i++)
+    {
+        int32_t cardId = pile->array[i];
+        if (cardId > 0 && cardId < CARD_ID_COUNT && counts[cardId] < INT8_MAX)
+            counts[cardId]++;
+    }
+}
+
+static void extract_player(player *p, int8_t *out)
+{
+    uint32_t blue = 0;
+    uint32_t red = 0;
+    vector *tokenTypes = &p->scheherazade.destiny_TOKEN_type;
+    for (uint32_t i = 0; i < tokenTypes->SIZE; i++)
+    {
+        blue += tokenTypes->array[i] == 1;
+        red += tokenTypes->array[i] == 2;
+    }
+
+    out[FEAT_LIFE] = saturate(p->life);
+    out[FEAT_MAX_LIFE] = saturate(p->maxlife);
+    out[FEAT_DEFENSE] = saturate(p->defense);
+    out[FEAT_MAX_DEFENSE] = saturate(p->maxdefense);
+    out[FEAT_ENERGY] = saturate(p->energy);
+    out[FEAT_SPECIAL_GATE] = saturate(p->specialGate);
+    out[FEAT_POSITION] = saturate(p->locate[0]);
+    out[FEAT_HAND_SIZE] = saturate(p->hand.SIZE);
+    out[FEAT_DECK_SIZE] = saturate(p->deck.SIZE);
+    out[FEAT_GRAVEYARD_SIZE] = saturate(p->graveyard.SIZE);
+    out[FEAT_USECARDS_SIZE] = saturate(p->usecards.SIZE);
+    out[FEAT_KI_TOKEN] = saturate(p->mulan.KI_TOKEN);
+    out[FEAT_COMBO_TOKEN] = saturate(p->dorothy.COMBO_TOKEN);
+    out[FEAT_AWAKEN_TOKEN] = saturate(p->sleepingBeauty.AWAKEN_TOKEN);
+    out[FEAT_AWAKEN] = saturate(p->sleepingBeauty.AWAKEN);
+    out[FEAT_DESTINY_BLUE] = saturate(blue);
+    out[FEAT_DESTINY_RED] = saturate(red);
+
+    if (p->character < CHARACTER_COUNT)
+        out[FEATURE_CHARACTER_OFFSET + p->character] = 1;
+
+    int8_t *piles = out + FEATURE_PILE_OFFSET;
+    count_pile(piles + FEAT_PILE_HAND * CARD_ID_COUNT, &p->hand);
+    count_pile(piles + FEAT_PILE_DECK * CARD_ID_COUNT, &p->deck);
+    count_pile(piles + FEAT_PILE_GRAVEYARD * CARD_ID_COUNT, &p->graveyard);
+    count_pile(piles + FEAT_PILE_USECARDS * CARD_ID_COUNT, &p->usecards);
+}
+
+void extract_features_int8(game *gs, int8_t perspective, int8_t *out)
+{
+    memset(out, 0, FEATURE_COUNT);
+    player *me = &gs->players[perspective];
+    player *opp = &gs->players[(perspective + 1) % 2];
+    extract_player(me, out);
+    extract_player(opp, out + FEATURE_PLAYER_SIZE);
+
+    if ((uint32_t)gs->status < FEATURE_STATUS_COUNT)
+        out[FEATURE_GLOBAL_OFFSET + gs->status] = 1;
+    out[FEATURE_DISTANCE] = saturate(abs((int)me->locate[0] - (int)opp->locate[0]));
+}
+
+// 連續的逐項轉換，編譯器可向量化
+static void widen(const int8_t *in, float *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = (float)in[i];
+}
+
+void extract_features(game *gs, int8_t perspective, float *out)
+{
+    int8_t packed[FEATURE_COUNT];
+    extract_features_int8(gs, perspective, packed);
+    widen(packed, out, FEATURE_COUNT);
+}
+
+void extract_features_batch_int8(game *games, size_t count, const int8_t *perspectives, int8_t *out)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int8_t perspective = perspectives != NULL ? perspectives[i] : games[i].now_turn_player_id;
+        extract_features_int8(&games[i], perspective, out + i * FEATURE_COUNT);
+    }
+}
+
+void extract_features_batch(game *games, size_t count, const int8_t *perspectives, float *out)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int8_t perspective = perspectives != NULL ? perspectives[i] : games[i].now_turn_player_id;
+        extract_features(&games[i], perspective, out + i * FEATURE_COUNT);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef _GAME_FEATURES_H
+#define _GAME_FEATURES_H
+
+#include "architecture.h"
+#include "card_system.h"
+#include "character_system.h"
+
+// 固定長度的局面特徵（評估函數、資料集、訓練共用同一種編碼）
+// 以 perspective 為「自己」：前半是自己的區塊、後半是對手的區塊，最後是共用的區塊
+// 數值為原始整數（張數、點數），int8 版本超過範圍時飽和；float 版本由 int8 版本逐項轉換
+
+// 每位玩家的數值欄位
+enum {
+    FEAT_LIFE = 0,
+    FEAT_MAX_LIFE,
+    FEAT_DEFENSE,
+    FEAT_MAX_DEFENSE,
+    FEAT_ENERGY,
+    FEAT_SPECIAL_GATE,
+    FEAT_POSITION,
+    FEAT_HAND_SIZE,
+    FEAT_DECK_SIZE,
+    FEAT_GRAVEYARD_SIZE,
+    FEAT_USECARDS_SIZE,
+    FEAT_KI_TOKEN,
+    FEAT_COMBO_TOKEN,
+    FEAT_AWAKEN_TOKEN,
+    FEAT_AWAKEN,
+    FEAT_DESTINY_BLUE,
+    FEAT_DESTINY_RED,
+    FEATURE_PLAYER_SCALARS
+};
+
+// 每位玩家依卡牌ID計數的牌堆
+enum {
+    FEAT_PILE_HAND = 0,
+    FEAT_PILE_DECK,
+    FEAT_PILE_GRAVEYARD,
+    FEAT_PILE_USECARDS,
+    FEATURE_PILE_COUNT
+};
+
+// 玩家區塊：數值、角色 one-hot、各牌堆的卡牌ID張數
+#define FEATURE_CHARACTER_OFFSET FEATURE_PLAYER_SCALARS
+#define FEATURE_PILE_OFFSET (FEATURE_CHARACTER_OFFSET + CHARACTER_COUNT)
+#define FEATURE_PLAYER_SIZE (FEATURE_PILE_OFFSET + FEATURE_PILE_COUNT * CARD_ID_COUNT)
+
+// 共用區塊：目前狀態 one-hot、雙方距離
+#define FEATURE_STATUS_COUNT (USE_METAMORPHOSIS + 1)
+#define FEATURE_GLOBAL_OFFSET (2 * FEATURE_PLAYER_SIZE)
+#define FEATURE_DISTANCE (FEATURE_GLOBAL_OFFSET + FEATURE_STATUS_COUNT)
+
+// 總長度補到 32 的倍數（AVX2 一次 32 個 int8），補上的部分為 0
+#define FEATURE_USED (FEATURE_DISTANCE + 1)
+#define FEATURE_COUNT ((FEATURE_USED + 31) / 32 * 32)
+
+// 卡牌ID在某個牌堆計數的位置（player 0 為自己、1 為對手）
+#define FEATURE_PILE_INDEX(player, pile, cardId) \
+    ((player) * FEATURE_PLAYER_SIZE + FEATURE_PILE_OFFSET + (pile) * CARD_ID_COUNT + (cardId))
+
+// 擷取單一局面，out 長度為 FEATURE_COUNT
+void extract_features_int8(game* gameState, int8_t perspective, int8_t* out);
+void extract_features(game* gameState, int8_t perspective, float* out);
+
+// 批次擷取 count 個連續的局面，out 為 [count][FEATURE_COUNT]
+// perspectives 為 NULL 時以各局面要行動的玩家為自己
+void extract_features_batch_int8(game* games, size_t count, const int8_t* perspectives, int8_t* out);
+void extract_features_batch(game* games, size_t count, const int8_t* perspectives, float* out);
+
+#endif // _GAME_FEATURES_H
@@ -0,0 +1,135 @@
+#include "game_hash.h"
+#include "rng.h"
+
+static uint64_t hash_value(uint64_t h, int64_t value)
+{
+    return rng_mix64(h ^ (uint64_t)value);
+}
+
+static uint64_t hash_vector(uint64_t h, vector *vec)
+{
+    h = hash_value(h, vec->SIZE);
+    for (uint32_t i = 0; i < vec->SIZE; i++)
+        h = hash_value(h, vec->array[i]);
+    return h;
+}
+
+// 多重集合雜湊：各元素獨立混合後相加，與順序無關
+static uint64_t hash_pile(uint64_t h, vector *vec)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < vec->SIZE; i++)
+        sum += rng_mix64((uint64_t)vec->array[i]);
+    return hash_value(hash_value(h, vec->SIZE), (int64_t)sum);
+}
+
+static uint64_t hash_player(uint64_t h, player *p, bool orderedDeck)
+{
+    h = hash_value(h, p->locate[0]);
+    h = hash_value(h, p->locate[1]);
+    h = hash_value(h, p->character);
+    h = hash_value(h, p->life);
+    h = hash_value(h, p->defense);
+    h = hash_value(h, p->energy);
+    h = hash_value(h, p->specialGate);
+    h = hash_pile(h, &p->hand);
+    h = orderedDeck ? hash_vector(h, &p->deck) : hash_pile(h, &p->deck);
+    h = hash_pile(h, &p->usecards);
+    h = hash_pile(h, &p->graveyard);
+    h = hash_vector(h, &p->metamorphosis);
+    h = hash_vector(h, &p->attackSkill);
+    h = hash_vector(h, &p->defenseSkill);
+    h = hash_vector(h, &p->moveSkill);
+    h = hash_vector(h, &p->specialDeck);
+
+    // 角色專屬狀態
+    for (int i = 0; i < 3; i++)
+        h = hash_value(h, p->redHood.saveCard[i]);
+    h = hash_vector(h, &p->snowWhite.remindPosion);
+    h = hash_value(h, p->sleepingBeauty.AWAKEN_TOKEN);
+    h = hash_value(h, p->sleepingBeauty.AWAKEN);
+    h = hash_value(h, p->sleepingBeauty.dayNightmareDrawRemind);
+    h = hash_value(h, p->sleepingBeauty.atkRise);
+    h = hash_value(h, p->sleepingBeauty.atkRiseTime);
+    h = hash_value(h, p->sleepingBeauty.usedmeta1);
+    h = hash_value(h, p->alice.identity);
+    h = hash_value(h, p->alice.riseBasic);
+    h = hash_value(h, p->alice.restartTurn);
+    h = hash_value(h, p->alice.havedrestart);
+    h = hash_value(h, p->mulan.KI_TOKEN);
+    h = hash_value(h, p->mulan.extraCard);
+    h = hash_value(h, p->mulan.extraDraw);
+    h = hash_value(h, p->kaguya.useDefenseAsATK);
+    h = hash_value(h, p->kaguya.useMoveTarget);
+    h = hash_value(h, p->matchGirl.remindMatch);
+    h = hash_value(h, p->matchGirl.pushedMatch);
+    h = hash_value(h, p->dorothy.COMBO_TOKEN);
+    h = hash_value(h, p->dorothy.canCombo);
+    h = hash_vector(h, &p->scheherazade.destiny_TOKEN_locate);
+    h = hash_vector(h, &p->scheherazade.destiny_TOKEN_type);
+    h = hash_value(h, p->scheherazade.selectToken);
+    return h;
+}
+
+static uint64_t hash_state(game *gs, bool orderedDeck)
+{
+    int playerCount = gs->playerMode == 1 ? 4 : 2;
+    uint64_t h = hash_value(0, playerCount);
+
+    for (int i = 0; i < playerCount; i++)
+        h = hash_player(h, &gs->players[i], orderedDeck);
+
+    h = hash_value(h, gs->now_turn_player_id);
+    h = hash_value(h, gs->status);
+    h = hash_value(h, gs->nowATK);
+    h = hash_value(h, gs->nowDEF);
+    h = hash_value(h, gs->nowMOV);
+    h = hash_value(h, gs->nowUsingCardID);
+    h = hash_value(h, gs->totalDamage);
+    h = hash_vector(h, &gs->nowShowingCards);
+    h = hash_vector(h, &gs->tentacle_TOKEN_locate);
+    for (int type = 0; type < 4; type++)
+    {
+        for (int level = 0; level < 3; level++)
+            h = hash_pile(h, &gs->basicBuyDeck[type][level]);
+    }
+    return h;
+}
+
+uint64_t hash_game(game *gs)
+{
+    return hash_state(gs, true);
+}
+
+uint64_t hash_observation(game *gs)
+{
+    return hash_state(gs, false);
+}
+
+static int compare_card(const void *a, const void *b)
+{
+    int32_t x = *(const int32_t *)a;
+    int32_t y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void sort_pile(vector *vec)
+{
+    qsort(vec->array, vec->SIZE, sizeof(int32_t), compare_card);
+}
+
+void canonicalize_game(game *gs)
+{
+    int playerCount = gs->playerMode == 1 ? 4 : 2;
+    for (int i = 0; i < playerCount; i++)
+    {
+        sort_pile(&gs->players[i].hand);
+        sort_pile(&gs->players[i].usecards);
+        sort_pile(&gs->players[i].graveyard);
+    }
+    for (int type = 0; type < 4; type++)
+    {
+        for (int level = 0; level < 3; level++)
+            sort_pile(&gs->basicBuyDeck[type][level]);
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef _GAME_HASH_H
+#define _GAME_HASH_H
+
+#include "architecture.h"
+
+// 64 位元局面雜湊（置換表、開局庫使用）
+// 只計算影響之後遊戲進行的欄位，向量只計算已使用的部分；
+// 順序不影響規則的牌堆（手牌、棄牌堆、出牌區、基本牌供應堆）以多重集合計算，
+// 只差在這些順序的局面雜湊相同，且 hash_game(x) == hash_game(canonicalize_game(x))
+uint64_t hash_game(game* gameState);
+
+// 玩家可觀察到的局面雜湊：另外把雙方牌堆也當成多重集合（抽牌順序無法得知）
+// 開局庫等以資訊為準的查表使用
+uint64_t hash_observation(game* gameState);
+
+// 把順序不影響規則的牌堆排序成標準形式（會改變手牌編號，只用於比對與保存）
+// 牌堆（抽牌順序）與技能供應堆（購買順序）的順序會影響遊戲，維持不變
+void canonicalize_game(game* gameState);
+
+#endif // _GAME_HASH_H
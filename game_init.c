@@ -11,6 +11,8 @@ void init_game(game *gameState)
 
     // 初始化遊戲模式為1v1
     gameState->playerMode = 0;
+    gameState->relicMode = 0;
+    memset(gameState->relic, 0, sizeof(gameState->relic));
     gameState->now_turn_player_id = 0;
     gameState->status = CHOOSE_IDENTITY;
 
@@ -43,6 +45,19 @@ void init_game(game *gameState)
     DEBUG_LOG("遊戲初始化完成");
 }
 
+void init_duel(game *gameState, uint8_t firstCharacter, uint8_t secondCharacter)
+{
+    init_game(gameState);
+
+    // 直接設置雙方角色，跳過互動式的角色選擇階段
+    init_character(gameState, 0, firstCharacter);
+    init_character(gameState, 1, secondCharacter);
+
+    gameState->now_turn_player_id = 0;
+    gameState->status = CHOOSE_MOVE;
+    initial_draw(gameState);
+}
+
 void init_player(player *p)
 {
     DEBUG_LOG("初始化玩家");
@@ -81,6 +96,7 @@ void init_player(player *p)
     memset(&p->dorothy, 0, sizeof(p->dorothy));
     vector_init(&p->scheherazade.destiny_TOKEN_locate);
     vector_init(&p->scheherazade.destiny_TOKEN_type);
+    p->scheherazade.selectToken = 0;
 
     INFO_LOG("玩家初始化完成");
 }
@@ -6,6 +6,9 @@
 // 遊戲初始化
 void init_game(game* gameState);
 
+// 以指定角色直接開始一場1v1對戰（模擬與AI使用）
+void init_duel(game* gameState, uint8_t firstCharacter, uint8_t secondCharacter);
+
 // 初始化玩家
 void init_player(player* player);
 
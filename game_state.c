@@ -80,6 +80,20 @@ void handle_cleanup_phase(game *gameState)
     current_player->defense = 0;
 }
 
+void handle_end_phase(game *gameState)
+{
+    player *current_player = &gameState->players[gameState->now_turn_player_id];
+
+    // 能量重置為0
+    current_player->energy = 0;
+
+    // 棄掉所有手牌
+    move_all_cards(&current_player->hand, &current_player->graveyard);
+
+    // 抽出六張牌（牌庫為空時會將棄牌堆洗入牌庫）
+    draw_card(current_player, 6);
+}
+
 void handle_action_phase(game *gameState)
 {
     // 處理玩家的行動選擇
@@ -139,6 +153,7 @@ void start_turn(game *gameState)
 void end_turn(game *gameState)
 {
     handle_cleanup_phase(gameState);
+    handle_end_phase(gameState);
     gameState->now_turn_player_id = (gameState->now_turn_player_id + 1) % 2;
     start_turn(gameState);
 }
@@ -7,6 +7,7 @@
 void transition_to_next_state(game* gameState);
 void handle_start_phase(game* gameState);
 void handle_cleanup_phase(game* gameState);
+void handle_end_phase(game* gameState);
 void handle_action_phase(game* gameState);
 void handle_focus_action(game* gameState);
 void handle_attack_action(game* gameState);
@@ -0,0 +1,421 @@
+// 建置工具：由 card_spec.tsv 產生 card_table.h，並與 card_num_spec.md 核對編號、名稱與角色
+// effect 欄的效果程式在這裡組譯成 card_effect.h 的位元組碼（指令說明見 card_effect.h）
+// 用法：./gen_card_table card_spec.tsv card_num_spec.md card_table.h
+// 任何不一致都會輸出錯誤並以非 0 結束，不會寫出標頭檔
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_CARDS 1024
+#define MAX_CHARACTERS 16
+#define NAME_SIZE 64
+#define MAX_PROGRAM 16  // 含結尾的 end
+
+typedef struct {
+    int op;
+    int arg;
+} Instr;
+
+typedef struct {
+    bool present;
+    int type;
+    int level;
+    int value;
+    int character;
+    char name[NAME_SIZE];
+    Instr program[MAX_PROGRAM];
+    int programLength;  // 0 表示沒有效果程式
+} CardRow;
+
+// 組合語言名稱與 card_effect.h 的 EffectOp 對應（名稱不一致時編譯 card_effect.c 會失敗）
+typedef struct {
+    const char *mnemonic;
+    const char *op;
+    bool hasArg;
+    int minArg;
+    int maxArg;
+} Mnemonic;
+
+static const Mnemonic mnemonics[] = {
+    {"end", "EFFECT_END", false, 0, 0},
+    {"set", "EFFECT_SET", true, -99, 99},
+    {"add", "EFFECT_ADD", true, -99, 99},
+    {"card", "EFFECT_ADD_CARD", false, 0, 0},
+    {"basic", "EFFECT_ADD_BASIC", false, 0, 0},
+    {"energy", "EFFECT_ENERGY", false, 0, 0},
+    {"attack", "EFFECT_ATTACK", true, 0, 1},
+    {"defense", "EFFECT_DEFENSE", true, 0, 1},
+    {"move", "EFFECT_MOVE", false, 0, 0},
+    {"knockback", "EFFECT_KNOCKBACK", false, 0, 0},
+    {"draw", "EFFECT_DRAW", false, 0, 0},
+    {"mill", "EFFECT_MILL", false, 0, 0},
+    {"poison", "EFFECT_POISON", false, 0, 0},
+};
+
+#define MNEMONIC_COUNT ((int)(sizeof(mnemonics) / sizeof(mnemonics[0])))
+
+typedef struct {
+    const char *token;
+    const char *cardType;
+    const char *cardKind;
+    bool leveled;  // 等級必須是 1~3
+} TypeInfo;
+
+static const TypeInfo types[] = {
+    {"attack", "CARD_TYPE_BASIC_ATK", "CARD_KIND_BASIC", true},
+    {"defense", "CARD_TYPE_BASIC_DEF", "CARD_KIND_BASIC", true},
+    {"move", "CARD_TYPE_BASIC_MOV", "CARD_KIND_BASIC", true},
+    {"general", "CARD_TYPE_BASIC_GENERAL", "CARD_KIND_BASIC", true},
+    {"skill_attack", "CARD_TYPE_SKILL_ATK", "CARD_KIND_SKILL", true},
+    {"skill_defense", "CARD_TYPE_SKILL_DEF", "CARD_KIND_SKILL", true},
+    {"skill_move", "CARD_TYPE_SKILL_MOV", "CARD_KIND_SKILL", true},
+    {"ultimate", "CARD_TYPE_SPECIAL", "CARD_KIND_ULTIMATE", false},
+    {"metamorphosis", "CARD_TYPE_SPECIAL", "CARD_KIND_METAMORPHOSIS", false},
+    {"token", "CARD_TYPE_SPECIAL", "CARD_KIND_TOKEN", false},
+};
+
+static CardRow rows[MAX_CARDS];
+static int maxId = 0;
+
+static void trim_line(char *line)
+{
+    size_t length = strlen(line);
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r' || line[length - 1] == ' '))
+        line[--length] = '\0';
+}
+
+static bool parse_int(const char *text, int *value)
+{
+    char *end;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0')
+        return false;
+    *value = (int)parsed;
+    return true;
+}
+
+// 組譯一張牌的效果程式；"-" 表示沒有程式，結尾自動補上 end
+static bool assemble(char *text, CardRow *row)
+{
+    row->programLength = 0;
+    if (strcmp(text, "-") == 0)
+        return true;
+
+    char *save = NULL;
+    for (char *token = strtok_r(text, " ", &save); token != NULL; token = strtok_r(NULL, " ", &save))
+    {
+        int m = 0;
+        while (m < MNEMONIC_COUNT && strcmp(token, mnemonics[m].mnemonic) != 0)
+            m++;
+        if (m == MNEMONIC_COUNT || row->programLength == MAX_PROGRAM - 1)
+            return false;
+
+        Instr *instr = &row->program[row->programLength++];
+        instr->op = m;
+        instr->arg = 0;
+        if (mnemonics[m].hasArg)
+        {
+            char *arg = strtok_r(NULL, " ", &save);
+            if (arg == NULL || !parse_int(arg, &instr->arg) || instr->arg < mnemonics[m].minArg ||
+                instr->arg > mnemonics[m].maxArg)
+                return false;
+        }
+        if (m == 0)
+            return strtok_r(NULL, " ", &save) == NULL;
+    }
+    row->program[row->programLength].op = 0;
+    row->program[row->programLength].arg = 0;
+    row->programLength++;
+    return true;
+}
+
+static bool read_spec(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    char line[512];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file) != NULL)
+    {
+        lineNumber++;
+        trim_line(line);
+        if (line[0] == '\0' || line[0] == '#')
+            continue;
+
+        char *fields[7];
+        int count = 0;
+        char *save = NULL;
+        for (char *field = strtok_r(line, "\t", &save); field != NULL && count < 7;
+             field = strtok_r(NULL, "\t", &save))
+            fields[count++] = field;
+
+        int id, level, value, character;
+        int type = -1;
+        for (int t = 0; count == 7 && t < (int)(sizeof(types) / sizeof(types[0])); t++)
+        {
+            if (strcmp(fields[1], types[t].token) == 0)
+                type = t;
+        }
+        if (count != 7 || !parse_int(fields[0], &id) || !parse_int(fields[2], &level) ||
+            !parse_int(fields[3], &value) || !parse_int(fields[4], &character) || type < 0)
+        {
+            fprintf(stderr, "%s:%d: expected 'id type level value character name effect'\n", path, lineNumber);
+            ok = false;
+        }
+        else if (id < 1 || id >= MAX_CARDS || rows[id].present)
+        {
+            fprintf(stderr, "%s:%d: card id %d out of range or duplicated\n", path, lineNumber, id);
+            ok = false;
+        }
+        else if (types[type].leveled ? level < 1 || level > 3 : level != 0)
+        {
+            fprintf(stderr, "%s:%d: card %d has invalid level %d for type %s\n", path, lineNumber, id, level,
+                    types[type].token);
+            ok = false;
+        }
+        else if (value < 0 || value > 255 || character < -1 || character >= MAX_CHARACTERS ||
+                 (character < 0) != (strcmp(types[type].cardKind, "CARD_KIND_BASIC") == 0) || strlen(fields[5]) >= NAME_SIZE)
+        {
+            fprintf(stderr, "%s:%d: card %d has an invalid value, character or name\n", path, lineNumber, id);
+            ok = false;
+        }
+        else if (strpbrk(fields[5], "\"\\") != NULL)
+        {
+            // 名稱直接寫進 card_table.h 的字串常值
+            fprintf(stderr, "%s:%d: card %d name '%s' must not contain '\"' or '\\'\n", path, lineNumber, id,
+                    fields[5]);
+            ok = false;
+        }
+        else if (!assemble(fields[6], &rows[id]) ||
+                 (rows[id].programLength > 0 && strcmp(types[type].cardKind, "CARD_KIND_BASIC") == 0) ||
+                 (rows[id].programLength == 0 && strcmp(types[type].cardKind, "CARD_KIND_SKILL") == 0))
+        {
+            // 技能牌必須有效果程式；基本牌依用途共用 card_effect.c 的程式，不能另外指定
+            fprintf(stderr, "%s:%d: card %d has an invalid effect program\n", path, lineNumber, id);
+            ok = false;
+        }
+        else
+        {
+            CardRow *row = &rows[id];
+            row->present = true;
+            row->type = type;
+            row->level = level;
+            row->value = value;
+            row->character = character;
+            snprintf(row->name, sizeof(row->name), "%s", fields[5]);
+            if (id > maxId)
+                maxId = id;
+        }
+    }
+    fclose(file);
+
+    for (int id = 1; ok && id <= maxId; id++)
+    {
+        if (!rows[id].present)
+        {
+            fprintf(stderr, "%s: card id %d is missing (ids must be dense)\n", path, id);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+// 核對 card_num_spec.md：基本牌段落為「名稱 編號」；技能段落每段第一行是「角色 角色編號」；
+// 蛻變牌段落每段第一行只有角色名稱
+static bool check_markdown(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    enum { SECTION_NONE, SECTION_BASIC, SECTION_SKILL, SECTION_METAMORPHOSIS } section = SECTION_NONE;
+    char characterNames[MAX_CHARACTERS][NAME_SIZE] = {{0}};
+    bool seen[MAX_CARDS] = {false};
+    bool paragraphStart = true;
+    int character = -1;
+    char line[512];
+    int lineNumber = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        lineNumber++;
+        trim_line(line);
+        if (strncmp(line, "## 基本牌", strlen("## 基本牌")) == 0)
+            section = SECTION_BASIC;
+        else if (strcmp(line, "技能牌與必殺牌") == 0)
+            section = SECTION_SKILL;
+        else if (strncmp(line, "## 蛻變牌", strlen("## 蛻變牌")) == 0)
+            section = SECTION_METAMORPHOSIS;
+        if (line[0] == '\0' || line[0] == '#' || strcmp(line, "技能牌與必殺牌") == 0)
+        {
+            paragraphStart = true;
+            continue;
+        }
+
+        char *space = strrchr(line, ' ');
+        int number = -1;
+        if (space != NULL && parse_int(space + 1, &number))
+            *space = '\0';
+        else
+            number = -1;
+
+        if (section == SECTION_SKILL && paragraphStart)
+        {
+            size_t length = strlen(line);
+            if (number < 0 || number >= MAX_CHARACTERS || length >= NAME_SIZE)
+            {
+                fprintf(stderr, "%s:%d: expected 'character id'\n", path, lineNumber);
+                ok = false;
+                break;
+            }
+            character = number;
+            memcpy(characterNames[character], line, length + 1);
+            paragraphStart = false;
+            continue;
+        }
+        if (section == SECTION_METAMORPHOSIS && paragraphStart)
+        {
+            character = -1;
+            for (int c = 0; c < MAX_CHARACTERS; c++)
+            {
+                if (strcmp(characterNames[c], line) == 0)
+                    character = c;
+            }
+            if (character < 0 || number >= 0)
+            {
+                fprintf(stderr, "%s:%d: unknown character '%s'\n", path, lineNumber, line);
+                ok = false;
+                break;
+            }
+            paragraphStart = false;
+            continue;
+        }
+        paragraphStart = false;
+        if (section == SECTION_NONE)
+            continue;
+
+        int expectedCharacter = section == SECTION_BASIC ? -1 : character;
+        if (number < 1 || number >= MAX_CARDS || !rows[number].present)
+        {
+            fprintf(stderr, "%s:%d: card '%s' is not in the card table\n", path, lineNumber, line);
+            ok = false;
+        }
+        else if (seen[number])
+        {
+            fprintf(stderr, "%s:%d: card id %d listed twice\n", path, lineNumber, number);
+            ok = false;
+        }
+        else if (strcmp(rows[number].name, line) != 0 || rows[number].character != expectedCharacter)
+        {
+            fprintf(stderr, "%s:%d: card %d is '%s' (character %d) in the spec but '%s' (character %d) in the table\n",
+                    path, lineNumber, number, line, expectedCharacter, rows[number].name, rows[number].character);
+            ok = false;
+        }
+        else
+        {
+            seen[number] = true;
+        }
+    }
+    fclose(file);
+
+    for (int id = 1; ok && id <= maxId; id++)
+    {
+        if (!seen[id])
+        {
+            fprintf(stderr, "%s: card %d (%s) is missing from the spec\n", path, id, rows[id].name);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static bool write_header(const char *path)
+{
+    char temporary[512];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+    FILE *out = fopen(temporary, "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "%s: cannot write\n", temporary);
+        return false;
+    }
+
+    fprintf(out, "// 由 gen_card_table 從 card_spec.tsv 產生，請勿手動修改\n");
+    fprintf(out, "#ifndef _CARD_TABLE_H\n#define _CARD_TABLE_H\n\n");
+    fprintf(out, "#define CARD_TABLE_MAX_ID %d\n\n", maxId);
+    fprintf(out, "// ROW(編號, 類型, 種類, 等級, 數值, 角色, 名稱)\n");
+    fprintf(out, "#define CARD_TABLE(ROW) \\\n");
+    for (int id = 1; id <= maxId; id++)
+    {
+        const CardRow *row = &rows[id];
+        fprintf(out, "    ROW(%d, %s, %s, %d, %d, %d, \"%s\")%s\n", id, types[row->type].cardType,
+                types[row->type].cardKind, row->level, row->value, row->character, row->name,
+                id < maxId ? " \\" : "");
+    }
+
+    // 效果程式：位移 0 是空程式（沒有效果的牌），相同的程式只保存一份
+    int offsets[MAX_CARDS] = {0};
+    int codeSize = 1;
+    fprintf(out, "\n// 效果程式的位元組碼（EffectInstr 陣列的內容）\n");
+    fprintf(out, "#define CARD_EFFECT_CODE \\\n    {EFFECT_END, 0}");
+    for (int id = 1; id <= maxId; id++)
+    {
+        const CardRow *row = &rows[id];
+        if (row->programLength == 0)
+            continue;
+        for (int other = 1; other < id && offsets[id] == 0; other++)
+        {
+            if (rows[other].programLength == row->programLength &&
+                memcmp(rows[other].program, row->program, (size_t)row->programLength * sizeof(Instr)) == 0)
+                offsets[id] = offsets[other];
+        }
+        if (offsets[id] != 0)
+            continue;
+        offsets[id] = codeSize;
+        codeSize += row->programLength;
+        fprintf(out, ", \\\n   ");
+        for (int i = 0; i < row->programLength; i++)
+            fprintf(out, "%s {%s, %d}", i > 0 ? "," : "", mnemonics[row->program[i].op].op, row->program[i].arg);
+    }
+    fprintf(out, "\n\n#define CARD_EFFECT_CODE_SIZE %d\n\n", codeSize);
+    fprintf(out, "// PROGRAM(編號, 在 CARD_EFFECT_CODE 中的位移)\n");
+    fprintf(out, "#define CARD_EFFECT_PROGRAMS(PROGRAM)");
+    for (int id = 1; id <= maxId; id++)
+    {
+        if (offsets[id] != 0)
+            fprintf(out, " \\\n    PROGRAM(%d, %d)", id, offsets[id]);
+    }
+    fprintf(out, "\n\n#endif // _CARD_TABLE_H\n");
+    if (fclose(out) != 0 || rename(temporary, path) != 0)
+    {
+        fprintf(stderr, "%s: cannot write\n", path);
+        remove(temporary);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        fprintf(stderr, "Usage: %s card_spec.tsv card_num_spec.md card_table.h\n", argv[0]);
+        return 1;
+    }
+    if (!read_spec(argv[1]) || !check_markdown(argv[2]) || !write_header(argv[3]))
+        return 1;
+    return 0;
+}
@@ -13,11 +13,9 @@ int main(void)
 {
     // Initialize game
     game gameState;
+    // 供應牌庫由 init_game 以卡牌ID 1~10 建立
     init_game(&gameState);
 
-    // Initialize card system
-    init_card_system(&gameState);
-
     printf("=== Twisted Fables ===\n");
     printf("1v1 Mode\n");
 
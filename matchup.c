@@ -0,0 +1,141 @@
+#include "matchup.h"
+
+#define WILSON_Z 1.96
+
+void run_matchup_matrix(const BotPolicy *bots[2], uint64_t seed, uint32_t maxTurns,
+                        uint64_t gamesPerPair, int threads, MatchupMatrix *matrix)
+{
+    SimJob jobs[CHARACTER_COUNT * CHARACTER_COUNT];
+
+    for (int a = 0; a < CHARACTER_COUNT; a++)
+    {
+        for (int b = 0; b < CHARACTER_COUNT; b++)
+        {
+            SimJob *job = &jobs[a * CHARACTER_COUNT + b];
+            sim_init_config(&job->config);
+            job->config.characters[0] = (uint8_t)a;
+            job->config.characters[1] = (uint8_t)b;
+            job->config.bots[0] = bots[0];
+            job->config.bots[1] = bots[1];
+            // 每組配對使用獨立的種子
+            job->config.seed = rng_mix64(seed + (uint64_t)(a * CHARACTER_COUNT + b));
+            job->config.maxTurns = maxTurns;
+            job->firstGame = 0;
+            job->lastGame = gamesPerPair;
+            sim_stats_init(&job->stats);
+        }
+    }
+
+    sim_run_jobs(jobs, CHARACTER_COUNT * CHARACTER_COUNT, threads);
+
+    for (int a = 0; a < CHARACTER_COUNT; a++)
+    {
+        for (int b = 0; b < CHARACTER_COUNT; b++)
+            matrix->pairs[a][b] = jobs[a * CHARACTER_COUNT + b].stats;
+    }
+}
+
+void wilson_interval(double successes, double trials, double *low, double *high)
+{
+    if (trials <= 0)
+    {
+        *low = 0;
+        *high = 1;
+        return;
+    }
+
+    double p = successes / trials;
+    double z2 = WILSON_Z * WILSON_Z;
+    double denom = 1 + z2 / trials;
+    double center = (p + z2 / (2 * trials)) / denom;
+    double margin = WILSON_Z * sqrt(p * (1 - p) / trials + z2 / (4 * trials * trials)) / denom;
+    *low = center - margin;
+    *high = center + margin;
+}
+
+void get_matchup_cell(const MatchupMatrix *matrix, int row, int col, MatchupCell *cell)
+{
+    const SimStats *asFirst = &matrix->pairs[row][col];
+    const SimStats *asSecond = &matrix->pairs[col][row];
+
+    uint64_t games = asFirst->games + asSecond->games;
+    double score = (double)asFirst->wins[0] + (double)asSecond->wins[1] +
+                   0.5 * (double)(asFirst->draws + asSecond->draws);
+
+    cell->games = games;
+    cell->winRate = games > 0 ? score / (double)games : 0.5;
+    cell->avgTurns = games > 0 ? (double)(asFirst->totalTurns + asSecond->totalTurns) / (double)games : 0;
+    wilson_interval(score, (double)games, &cell->low, &cell->high);
+}
+
+double get_first_player_win_rate(const MatchupMatrix *matrix, double *low, double *high)
+{
+    double score = 0;
+    double games = 0;
+
+    for (int a = 0; a < CHARACTER_COUNT; a++)
+    {
+        for (int b = 0; b < CHARACTER_COUNT; b++)
+        {
+            const SimStats *stats = &matrix->pairs[a][b];
+            score += (double)stats->wins[0] + 0.5 * (double)stats->draws;
+            games += (double)stats->games;
+        }
+    }
+
+    wilson_interval(score, games, low, high);
+    return games > 0 ? score / games : 0.5;
+}
+
+void print_matchup_matrix(FILE *fp, const MatchupMatrix *matrix)
+{
+    fprintf(fp, "%-4s", "");
+    for (int col = 0; col < CHARACTER_COUNT; col++)
+        fprintf(fp, "%7d", col + 1);
+    fprintf(fp, "   avg turns\n");
+
+    uint64_t totalGames = 0;
+    uint64_t totalTurns = 0;
+    for (int row = 0; row < CHARACTER_COUNT; row++)
+    {
+        fprintf(fp, "%-4d", row + 1);
+        double rowTurns = 0;
+        uint64_t rowGames = 0;
+        for (int col = 0; col < CHARACTER_COUNT; col++)
+        {
+            MatchupCell cell;
+            get_matchup_cell(matrix, row, col, &cell);
+            fprintf(fp, "%7.3f", cell.winRate);
+            rowTurns += cell.avgTurns * (double)cell.games;
+            rowGames += cell.games;
+            totalGames += matrix->pairs[row][col].games;
+            totalTurns += matrix->pairs[row][col].totalTurns;
+        }
+        fprintf(fp, "   %9.2f  %s\n", rowGames > 0 ? rowTurns / (double)rowGames : 0,
+                get_character_info((CharacterID)row)->name);
+    }
+
+    double low, high;
+    double firstRate = get_first_player_win_rate(matrix, &low, &high);
+    fprintf(fp, "\nGames: %llu\n", (unsigned long long)totalGames);
+    fprintf(fp, "Average game length: %.2f turns\n", totalGames > 0 ? (double)totalTurns / (double)totalGames : 0);
+    fprintf(fp, "First player win rate: %.4f [%.4f, %.4f]\n", firstRate, low, high);
+}
+
+void write_matchup_csv(FILE *fp, const MatchupMatrix *matrix)
+{
+    fprintf(fp, "row,col,games,win_rate,ci_low,ci_high,avg_turns,first_player_wins,second_player_wins,draws\n");
+    for (int row = 0; row < CHARACTER_COUNT; row++)
+    {
+        for (int col = 0; col < CHARACTER_COUNT; col++)
+        {
+            MatchupCell cell;
+            const SimStats *stats = &matrix->pairs[row][col];
+            get_matchup_cell(matrix, row, col, &cell);
+            fprintf(fp, "%d,%d,%llu,%.6f,%.6f,%.6f,%.3f,%llu,%llu,%llu\n", row + 1, col + 1,
+                    (unsigned long long)cell.games, cell.winRate, cell.low, cell.high, cell.avgTurns,
+                    (unsigned long long)stats->wins[0], (unsigned long long)stats->wins[1],
+                    (unsigned long long)stats->draws);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef _MATCHUP_H
+#define _MATCHUP_H
+
+#include "character_system.h"
+#include "simulation.h"
+
+// 角色對戰勝率矩陣
+// pairs[a][b] 為角色 a 先手、角色 b 後手的統計
+typedef struct {
+    SimStats pairs[CHARACTER_COUNT][CHARACTER_COUNT];
+} MatchupMatrix;
+
+// 單一格的摘要（合併雙方先後手）
+typedef struct {
+    double winRate;   // 列角色對行角色的勝率（平手算半場）
+    double low;       // 95% Wilson 信賴區間下界
+    double high;      // 95% Wilson 信賴區間上界
+    double avgTurns;  // 平均回合數
+    uint64_t games;
+} MatchupCell;
+
+// 對每一組有序角色配對進行 gamesPerPair 場對戰
+// bots[0] 使用列角色、bots[1] 使用行角色
+void run_matchup_matrix(const BotPolicy* bots[2], uint64_t seed, uint32_t maxTurns,
+                        uint64_t gamesPerPair, int threads, MatchupMatrix* matrix);
+
+// 取得 row 對 col 的勝率摘要
+void get_matchup_cell(const MatchupMatrix* matrix, int row, int col, MatchupCell* cell);
+
+// 先手勝率（所有對戰合計，平手算半場）
+double get_first_player_win_rate(const MatchupMatrix* matrix, double* low, double* high);
+
+// 95% Wilson 信賴區間
+void wilson_interval(double successes, double trials, double* low, double* high);
+
+// 輸出文字表格 / CSV
+void print_matchup_matrix(FILE* fp, const MatchupMatrix* matrix);
+void write_matchup_csv(FILE* fp, const MatchupMatrix* matrix);
+
+#endif // _MATCHUP_H
@@ -0,0 +1,410 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <unistd.h>
+#include "nn_eval.h"
+#include "debug_log.h"
+#include "rng.h"
+#include "search.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NN_X86 1
+#include <immintrin.h>
+#endif
+
+// 一層全連接：只計算 blocks 列出的非零輸入區段
+typedef void (*NnLinearFn)(const int8_t *in, const uint32_t *blocks, size_t blockCount, const int8_t *weights,
+                           size_t inCount, const int32_t *bias, size_t outCount, int32_t *out);
+
+static void linear_scalar(const int8_t *in, const uint32_t *blocks, size_t blockCount, const int8_t *weights,
+                          size_t inCount, const int32_t *bias, size_t outCount, int32_t *out)
+{
+    for (size_t o = 0; o < outCount; o++)
+    {
+        const int8_t *row = weights + o * inCount;
+        int32_t acc = bias[o];
+        for (size_t b = 0; b < blockCount; b++)
+        {
+            size_t offset = (size_t)blocks[b] * NN_BLOCK;
+            for (size_t i = offset; i < offset + NN_BLOCK; i++)
+                acc += (int32_t)in[i] * row[i];
+        }
+        out[o] = acc;
+    }
+}
+
+#ifdef NN_X86
+// 有號 int8 相乘：maddubs(|x|, w * sign(x))；|x| <= 128、|w| <= 127，兩兩相加不會超過 int16
+__attribute__((target("ssse3"))) static void linear_ssse3(const int8_t *in, const uint32_t *blocks,
+                                                           size_t blockCount, const int8_t *weights, size_t inCount,
+                                                           const int32_t *bias, size_t outCount, int32_t *out)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    for (size_t o = 0; o < outCount; o++)
+    {
+        const int8_t *row = weights + o * inCount;
+        __m128i acc = _mm_setzero_si128();
+        for (size_t b = 0; b < blockCount; b++)
+        {
+            size_t offset = (size_t)blocks[b] * NN_BLOCK;
+            for (size_t half = 0; half < NN_BLOCK; half += 16)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(in + offset + half));
+                __m128i w = _mm_loadu_si128((const __m128i *)(row + offset + half));
+                __m128i products = _mm_maddubs_epi16(_mm_abs_epi8(x), _mm_sign_epi8(w, x));
+                acc = _mm_add_epi32(acc, _mm_madd_epi16(products, ones));
+            }
+        }
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+        out[o] = bias[o] + _mm_cvtsi128_si32(acc);
+    }
+}
+
+__attribute__((target("avx2"))) static int32_t hsum_avx2(__m256i acc)
+{
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2"))) static __m256i dot_avx2(__m256i acc, __m256i x, const int8_t *w)
+{
+    __m256i weights = _mm256_loadu_si256((const __m256i *)w);
+    __m256i products = _mm256_maddubs_epi16(_mm256_abs_epi8(x), _mm256_sign_epi8(weights, x));
+    return _mm256_add_epi32(acc, _mm256_madd_epi16(products, _mm256_set1_epi16(1)));
+}
+
+// 一次計算 4 個輸出，共用輸入的載入
+__attribute__((target("avx2"))) static void linear_avx2(const int8_t *in, const uint32_t *blocks, size_t blockCount,
+                                                         const int8_t *weights, size_t inCount, const int32_t *bias,
+                                                         size_t outCount, int32_t *out)
+{
+    size_t o = 0;
+    for (; o + 4 <= outCount; o += 4)
+    {
+        const int8_t *row = weights + o * inCount;
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        __m256i acc2 = _mm256_setzero_si256();
+        __m256i acc3 = _mm256_setzero_si256();
+        for (size_t b = 0; b < blockCount; b++)
+        {
+            size_t offset = (size_t)blocks[b] * NN_BLOCK;
+            __m256i x = _mm256_loadu_si256((const __m256i *)(in + offset));
+            acc0 = dot_avx2(acc0, x, row + offset);
+            acc1 = dot_avx2(acc1, x, row + inCount + offset);
+            acc2 = dot_avx2(acc2, x, row + 2 * inCount + offset);
+            acc3 = dot_avx2(acc3, x, row + 3 * inCount + offset);
+        }
+        out[o] = bias[o] + hsum_avx2(acc0);
+        out[o + 1] = bias[o + 1] + hsum_avx2(acc1);
+        out[o + 2] = bias[o + 2] + hsum_avx2(acc2);
+        out[o + 3] = bias[o + 3] + hsum_avx2(acc3);
+    }
+    for (; o < outCount; o++)
+    {
+        const int8_t *row = weights + o * inCount;
+        __m256i acc = _mm256_setzero_si256();
+        for (size_t b = 0; b < blockCount; b++)
+        {
+            size_t offset = (size_t)blocks[b] * NN_BLOCK;
+            acc = dot_avx2(acc, _mm256_loadu_si256((const __m256i *)(in + offset)), row + offset);
+        }
+        out[o] = bias[o] + hsum_avx2(acc);
+    }
+}
+#endif
+
+static NnKernel activeKernel = NN_KERNEL_SCALAR;
+static NnLinearFn activeLinear = linear_scalar;
+static pthread_once_t kernelOnce = PTHREAD_ONCE_INIT;
+
+static bool kernel_supported(NnKernel kernel)
+{
+#ifdef NN_X86
+    if (kernel == NN_KERNEL_AVX2)
+        return __builtin_cpu_supports("avx2");
+    if (kernel == NN_KERNEL_SSSE3)
+        return __builtin_cpu_supports("ssse3");
+#endif
+    return kernel == NN_KERNEL_SCALAR;
+}
+
+static void select_kernel(NnKernel kernel)
+{
+    while (!kernel_supported(kernel))
+        kernel = (NnKernel)(kernel - 1);
+    activeKernel = kernel;
+    activeLinear = linear_scalar;
+#ifdef NN_X86
+    if (kernel == NN_KERNEL_AVX2)
+        activeLinear = linear_avx2;
+    else if (kernel == NN_KERNEL_SSSE3)
+        activeLinear = linear_ssse3;
+#endif
+}
+
+static void detect_kernel(void)
+{
+    select_kernel(NN_KERNEL_AVX2);
+}
+
+NnKernel nn_get_kernel(void)
+{
+    pthread_once(&kernelOnce, detect_kernel);
+    return activeKernel;
+}
+
+NnKernel nn_set_kernel(NnKernel kernel)
+{
+    pthread_once(&kernelOnce, detect_kernel);
+    select_kernel(kernel);
+    return activeKernel;
+}
+
+const char *nn_kernel_name(NnKernel kernel)
+{
+    static const char *names[] = {"scalar", "ssse3", "avx2"};
+    return names[kernel];
+}
+
+static size_t section_size(size_t bytes)
+{
+    return (bytes + 63) / 64 * 64;
+}
+
+// 配置權重與偏差（各段 64 bytes 對齊），並清為 0
+static bool allocate_model(NnModel *model, uint32_t inputCount, uint32_t hidden1, uint32_t hidden2)
+{
+    if (inputCount == 0 || inputCount > NN_MAX_INPUTS || inputCount % NN_BLOCK != 0 || hidden1 == 0 ||
+        hidden1 > NN_MAX_HIDDEN || hidden1 % NN_BLOCK != 0 || hidden2 == 0 || hidden2 > NN_MAX_HIDDEN ||
+        hidden2 % NN_BLOCK != 0)
+    {
+        ERROR_LOG("Unsupported network shape %u-%u-%u-1", inputCount, hidden1, hidden2);
+        return false;
+    }
+
+    size_t inputs[3] = {inputCount, hidden1, hidden2};
+    size_t outputs[3] = {hidden1, hidden2, 1};
+    size_t total = 0;
+    for (int l = 0; l < 3; l++)
+        total += section_size(inputs[l] * outputs[l]) + section_size(outputs[l] * sizeof(int32_t));
+
+    memset(model, 0, sizeof(NnModel));
+    model->storage = aligned_alloc(64, total);
+    if (model->storage == NULL)
+        return false;
+    memset(model->storage, 0, total);
+
+    uint8_t *cursor = model->storage;
+    for (int l = 0; l < 3; l++)
+    {
+        model->weights[l] = (int8_t *)cursor;
+        cursor += section_size(inputs[l] * outputs[l]);
+        model->biases[l] = (int32_t *)cursor;
+        cursor += section_size(outputs[l] * sizeof(int32_t));
+    }
+    model->inputCount = inputCount;
+    model->hidden[0] = hidden1;
+    model->hidden[1] = hidden2;
+    return true;
+}
+
+static size_t layer_inputs(const NnModel *model, int layer)
+{
+    return layer == 0 ? model->inputCount : model->hidden[layer - 1];
+}
+
+static size_t layer_outputs(const NnModel *model, int layer)
+{
+    return layer == 2 ? 1 : model->hidden[layer];
+}
+
+bool nn_model_init_random(NnModel *model, uint32_t hidden1, uint32_t hidden2, uint64_t seed)
+{
+    if (!allocate_model(model, FEATURE_COUNT, hidden1, hidden2))
+        return false;
+
+    RngState rng;
+    rng_seed(&rng, seed, 0);
+    for (int l = 0; l < 3; l++)
+    {
+        size_t count = layer_inputs(model, l) * layer_outputs(model, l);
+        for (size_t i = 0; i < count; i++)
+            model->weights[l][i] = (int8_t)((int32_t)rng_bounded(&rng, 255) - 127);
+    }
+    model->activationShift = 6;
+    model->outputScale = 1;
+    model->outputShift = 4;
+    return true;
+}
+
+void nn_model_free(NnModel *model)
+{
+    free(model->storage);
+    memset(model, 0, sizeof(NnModel));
+}
+
+bool nn_model_load(NnModel *model, const char *path)
+{
+    memset(model, 0, sizeof(NnModel));
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        ERROR_LOG("Cannot open network file %s", path);
+        return false;
+    }
+
+    NnHeader header;
+    bool ok = fread(&header, sizeof(header), 1, fp) == 1 && memcmp(header.magic, NN_MAGIC, 4) == 0 &&
+              header.version == NN_VERSION && header.activationShift < 32 && header.outputShift < 32 &&
+              allocate_model(model, header.inputCount, header.hidden[0], header.hidden[1]);
+    for (int l = 0; ok && l < 3; l++)
+    {
+        size_t count = layer_inputs(model, l) * layer_outputs(model, l);
+        size_t outputs = layer_outputs(model, l);
+        ok = fread(model->weights[l], 1, count, fp) == count &&
+             fread(model->biases[l], sizeof(int32_t), outputs, fp) == outputs;
+        // -128 會讓 SIMD 的中間值飽和
+        for (size_t i = 0; ok && i < count; i++)
+            ok = model->weights[l][i] != INT8_MIN;
+    }
+    ok = ok && fgetc(fp) == EOF;
+    fclose(fp);
+
+    if (!ok)
+    {
+        ERROR_LOG("Invalid network file %s", path);
+        nn_model_free(model);
+        return false;
+    }
+    model->activationShift = header.activationShift;
+    model->outputScale = header.outputScale;
+    model->outputShift = header.outputShift;
+    return true;
+}
+
+bool nn_model_save(const NnModel *model, const char *path)
+{
+    char tmpPath[1024];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE *fp = fopen(tmpPath, "wb");
+    if (fp == NULL)
+    {
+        ERROR_LOG("Cannot open network file %s", tmpPath);
+        return false;
+    }
+
+    NnHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, NN_MAGIC, 4);
+    header.version = NN_VERSION;
+    header.inputCount = model->inputCount;
+    header.hidden[0] = model->hidden[0];
+    header.hidden[1] = model->hidden[1];
+    header.activationShift = model->activationShift;
+    header.outputScale = model->outputScale;
+    header.outputShift = model->outputShift;
+
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    for (int l = 0; ok && l < 3; l++)
+    {
+        size_t count = layer_inputs(model, l) * layer_outputs(model, l);
+        size_t outputs = layer_outputs(model, l);
+        ok = fwrite(model->weights[l], 1, count, fp) == count &&
+             fwrite(model->biases[l], sizeof(int32_t), outputs, fp) == outputs;
+    }
+    ok = ok && fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmpPath, path) != 0)
+    {
+        ERROR_LOG("Cannot write network file %s", path);
+        remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+// 列出不全為 0 的輸入區段
+static size_t nonzero_blocks(const int8_t *in, size_t count, uint32_t *blocks)
+{
+    size_t found = 0;
+    for (size_t b = 0; b < count / NN_BLOCK; b++)
+    {
+        uint64_t words[NN_BLOCK / 8];
+        memcpy(words, in + b * NN_BLOCK, NN_BLOCK);
+        if ((words[0] | words[1] | words[2] | words[3]) != 0)
+            blocks[found++] = (uint32_t)b;
+    }
+    return found;
+}
+
+static void activate(const int32_t *acc, size_t count, uint32_t shift, int8_t *out)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int32_t value = acc[i] > 0 ? acc[i] >> shift : 0;
+        out[i] = (int8_t)(value > INT8_MAX ? INT8_MAX : value);
+    }
+}
+
+static int32_t forward(const NnModel *model, NnLinearFn linear, const int8_t *features)
+{
+    uint32_t blocks[NN_MAX_INPUTS / NN_BLOCK];
+    int32_t acc[NN_MAX_HIDDEN];
+    int8_t hidden1[NN_MAX_HIDDEN];
+    int8_t hidden2[NN_MAX_HIDDEN];
+
+    size_t blockCount = nonzero_blocks(features, model->inputCount, blocks);
+    linear(features, blocks, blockCount, model->weights[0], model->inputCount, model->biases[0], model->hidden[0],
+           acc);
+    activate(acc, model->hidden[0], model->activationShift, hidden1);
+
+    blockCount = nonzero_blocks(hidden1, model->hidden[0], blocks);
+    linear(hidden1, blocks, blockCount, model->weights[1], model->hidden[0], model->biases[1], model->hidden[1],
+           acc);
+    activate(acc, model->hidden[1], model->activationShift, hidden2);
+
+    blockCount = nonzero_blocks(hidden2, model->hidden[1], blocks);
+    linear(hidden2, blocks, blockCount, model->weights[2], model->hidden[1], model->biases[2], 1, acc);
+    return (int32_t)((int64_t)acc[0] * model->outputScale / ((int64_t)1 << model->outputShift));
+}
+
+void nn_forward_batch(const NnModel *model, const int8_t *features, size_t count, int32_t *out)
+{
+    pthread_once(&kernelOnce, detect_kernel);
+    NnLinearFn linear = activeLinear;
+    for (size_t i = 0; i < count; i++)
+        out[i] = forward(model, linear, features + i * model->inputCount);
+}
+
+// 每次處理的局面數（特徵暫存在堆疊上）
+#define NN_EVAL_CHUNK 16
+
+void nn_evaluate_games(const NnModel *model, game *games, size_t count, const int8_t *perspectives, int32_t *out)
+{
+    int8_t features[NN_EVAL_CHUNK * FEATURE_COUNT];
+    for (size_t first = 0; first < count; first += NN_EVAL_CHUNK)
+    {
+        size_t chunk = count - first < NN_EVAL_CHUNK ? count - first : NN_EVAL_CHUNK;
+        extract_features_batch_int8(games + first, chunk, perspectives + first, features);
+        nn_forward_batch(model, features, chunk, out + first);
+    }
+}
+
+int32_t nn_evaluate_game(void *ctx, game *gs, int8_t playerId)
+{
+    const NnModel *model = ctx;
+    int8_t features[2 * FEATURE_COUNT];
+    int32_t scores[2];
+    extract_features_int8(gs, playerId, features);
+    extract_features_int8(gs, (int8_t)((playerId + 1) % 2), features + FEATURE_COUNT);
+    nn_forward_batch(model, features, 2, scores);
+
+    // 保持在勝負分數之下
+    int64_t score = ((int64_t)scores[0] - scores[1]) / 2;
+    int64_t limit = SEARCH_WIN_SCORE / 2;
+    return (int32_t)(score > limit ? limit : score < -limit ? -limit : score);
+}
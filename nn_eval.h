@@ -0,0 +1,74 @@
+#ifndef _NN_EVAL_H
+#define _NN_EVAL_H
+
+#include "architecture.h"
+#include "game_features.h"
+
+// 小型神經網路評估：game_features 的 int8 特徵 -> 兩層隱藏層 -> 一個分數，全程整數運算
+// 每層：acc = bias + Σ w * x（int8 * int8 累加到 int32）
+// 隱藏層啟動：clamp(acc >> activationShift, 0, 127)
+// 輸出：acc * outputScale / 2^outputShift
+// 權重限制在 [-127, 127]，SIMD 的 16 位元中間值不會飽和
+// 輸入全為 0 的 32 個一組的區段直接跳過（特徵大多為 0）
+
+#define NN_MAGIC "TFNN"
+#define NN_VERSION 1
+#define NN_BLOCK 32             // 輸入數、隱藏層大小都必須是這個數的倍數
+#define NN_MAX_INPUTS 4096
+#define NN_MAX_HIDDEN 256
+#define NN_DEFAULT_HIDDEN 32
+
+// 權重檔：header 之後依序為
+// w1 int8[hidden1][inputCount]、b1 int32[hidden1]、w2 int8[hidden2][hidden1]、b2 int32[hidden2]、
+// w3 int8[hidden2]、b3 int32[1]（以產生檔案的機器的位元組順序保存）
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t inputCount;
+    uint32_t hidden[2];
+    uint32_t activationShift;
+    int32_t outputScale;
+    uint32_t outputShift;
+} NnHeader;
+
+typedef struct NnModel {
+    uint32_t inputCount;
+    uint32_t hidden[2];
+    uint32_t activationShift;
+    int32_t outputScale;
+    uint32_t outputShift;
+    int8_t* weights[3];  // 以輸出為列 [out][in]
+    int32_t* biases[3];
+    void* storage;       // 所有權重與偏差的配置
+} NnModel;
+
+// 推論使用的指令集；預設使用執行中的 CPU 支援的最快版本
+typedef enum {
+    NN_KERNEL_SCALAR = 0,
+    NN_KERNEL_SSSE3,
+    NN_KERNEL_AVX2
+} NnKernel;
+
+// 以亂數初始化（測試與效能量測用），輸入數為 FEATURE_COUNT
+bool nn_model_init_random(NnModel* model, uint32_t hidden1, uint32_t hidden2, uint64_t seed);
+bool nn_model_load(NnModel* model, const char* path);
+// 先寫暫存檔再改名
+bool nn_model_save(const NnModel* model, const char* path);
+void nn_model_free(NnModel* model);
+
+// 目前使用的指令集；設定不支援的指令集時改用支援的最快版本（需在開始評估前設定）
+NnKernel nn_get_kernel(void);
+NnKernel nn_set_kernel(NnKernel kernel);
+const char* nn_kernel_name(NnKernel kernel);
+
+// 批次推論：features 為 [count][inputCount]，out 為 [count]
+void nn_forward_batch(const NnModel* model, const int8_t* features, size_t count, int32_t* out);
+
+// 批次評估局面：perspectives[i] 為第 i 個局面的自己
+void nn_evaluate_games(const NnModel* model, game* games, size_t count, const int8_t* perspectives, int32_t* out);
+
+// 搜尋用評估函數，ctx 為 NnModel*（輸入數需為 FEATURE_COUNT）
+// 以 (f(自己) - f(對手)) / 2 計算，為零和，可與置換表共用
+int32_t nn_evaluate_game(void* ctx, game* gameState, int8_t playerId);
+
+#endif // _NN_EVAL_H
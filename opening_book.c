@@ -0,0 +1,331 @@
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "opening_book.h"
+#include "character_system.h"
+#include "debug_log.h"
+#include "game_action.h"
+#include "game_hash.h"
+#include "game_init.h"
+#include "simulation.h"
+
+// 每局開局最多收錄的局面數
+#define BOOK_MAX_RECORDS 512
+
+// 產生時收集的資料（order 用來在合併後維持與執行緒數無關的順序）
+typedef struct {
+    BookEntry entry;
+    uint64_t order;
+} BookRecord;
+
+typedef struct {
+    const BookConfig *config;
+    BookRecord *records;
+    size_t count;
+    size_t capacity;
+    bool failed;
+    pthread_mutex_t lock;
+} BookBuilder;
+
+void init_book_config(BookConfig *config)
+{
+    config->seed = 1;
+    config->gamesPerMatchup = 8;
+    config->bookTurns = 2;
+    init_search_config(&config->search);
+    config->search.maxDepth = 4;
+    config->search.nodeLimit = 20000;
+    config->threads = 0;
+}
+
+// 以可觀察到的局面為鍵（牌堆順序不同但手牌相同的開局共用），0 保留給空位
+static uint64_t book_key(game *gs)
+{
+    uint64_t key = hash_observation(gs);
+    return key == 0 ? 1 : key;
+}
+
+// 手牌、棄牌堆的選擇以卡牌記錄，順序不同的等價局面（雜湊相同）也能還原成正確的編號
+static int32_t choice_card(game *gs, int32_t choice)
+{
+    player *p = &gs->players[gs->now_turn_player_id];
+    switch (gs->status)
+    {
+    case USE_ATK:
+    case USE_DEF:
+    case USE_MOV:
+    case USE_SKILL:
+    case USEBASIC:
+        return choice > 0 ? p->hand.array[choice - 1] : 0;
+    case REMOVE_HG:
+        if (choice > 0)
+            return p->hand.array[choice - 1];
+        return choice < 0 ? p->graveyard.array[-choice - 1] : 0;
+    default:
+        return 0;
+    }
+}
+
+static int32_t resolve_choice(game *gs, const BookEntry *entry)
+{
+    if (entry->cardId == 0)
+        return entry->choice;
+
+    player *p = &gs->players[gs->now_turn_player_id];
+    if (entry->choice < 0)
+    {
+        int index = findVector(&p->graveyard, entry->cardId);
+        return index >= 0 ? -(index + 1) : entry->choice;
+    }
+    int index = findVector(&p->hand, entry->cardId);
+    return index >= 0 ? index + 1 : entry->choice;
+}
+
+static void add_records(BookBuilder *builder, const BookRecord *records, size_t count)
+{
+    pthread_mutex_lock(&builder->lock);
+    if (builder->count + count > builder->capacity)
+    {
+        size_t capacity = builder->capacity > 0 ? builder->capacity : 1024;
+        while (capacity < builder->count + count)
+            capacity *= 2;
+        BookRecord *grown = realloc(builder->records, capacity * sizeof(BookRecord));
+        if (grown == NULL)
+        {
+            builder->failed = true;
+            pthread_mutex_unlock(&builder->lock);
+            return;
+        }
+        builder->records = grown;
+        builder->capacity = capacity;
+    }
+    memcpy(builder->records + builder->count, records, count * sizeof(BookRecord));
+    builder->count += count;
+    pthread_mutex_unlock(&builder->lock);
+}
+
+// 一個任務：一組角色配對的一局開局，雙方都用搜尋選擇
+static void generate_opening(void *ctx, size_t task)
+{
+    BookBuilder *builder = ctx;
+    const BookConfig *config = builder->config;
+    uint64_t matchup = task % (CHARACTER_COUNT * CHARACTER_COUNT);
+    uint64_t sample = task / (CHARACTER_COUNT * CHARACTER_COUNT);
+
+    RngState rng;
+    rng_seed(&rng, rng_mix64(config->seed + matchup), sample);
+    RngState *previous = rng_get_active();
+    rng_set_active(&rng);
+
+    game gameState;
+    init_duel(&gameState, (uint8_t)(matchup / CHARACTER_COUNT), (uint8_t)(matchup % CHARACTER_COUNT));
+
+    BookRecord records[BOOK_MAX_RECORDS];
+    size_t count = 0;
+    uint32_t turns = 0;
+    int8_t lastMover = gameState.now_turn_player_id;
+    while (turns < config->bookTurns && get_winner(&gameState) < 0 && count < BOOK_MAX_RECORDS)
+    {
+        vector choices;
+        get_legal_choices(&gameState, &choices);
+        if (choices.SIZE == 0)
+            break;
+
+        SearchResult result;
+        int32_t choice = search_choose(&config->search, &gameState, &choices, &rng, &result);
+        BookRecord *record = &records[count++];
+        record->entry.key = book_key(&gameState);
+        record->entry.choice = choice;
+        record->entry.cardId = choice_card(&gameState, choice);
+        record->entry.score = result.score;
+        record->entry.count = 1;
+        record->order = (uint64_t)task * BOOK_MAX_RECORDS + count;
+
+        apply_choice(&gameState, choice);
+        if (gameState.now_turn_player_id != lastMover)
+        {
+            lastMover = gameState.now_turn_player_id;
+            turns++;
+        }
+    }
+    rng_set_active(previous);
+
+    add_records(builder, records, count);
+}
+
+static int compare_record(const void *a, const void *b)
+{
+    const BookRecord *x = a;
+    const BookRecord *y = b;
+    if (x->entry.key != y->entry.key)
+        return x->entry.key < y->entry.key ? -1 : 1;
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+static bool write_book(const char *path, BookEntry *table, uint64_t bucketCount, uint64_t entryCount)
+{
+    char tmpPath[1024];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE *fp = fopen(tmpPath, "wb");
+    if (fp == NULL)
+    {
+        ERROR_LOG("Cannot open opening book file %s", tmpPath);
+        return false;
+    }
+
+    BookHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BOOK_MAGIC, 4);
+    header.version = BOOK_VERSION;
+    header.entryCount = entryCount;
+    header.bucketCount = bucketCount;
+
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+              fwrite(table, sizeof(BookEntry), bucketCount, fp) == bucketCount && fflush(fp) == 0 &&
+              fsync(fileno(fp)) == 0;
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmpPath, path) != 0)
+    {
+        ERROR_LOG("Cannot write opening book file %s", path);
+        remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+bool generate_opening_book(const BookConfig *config, const char *path, uint64_t *entryCount)
+{
+    BookBuilder builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.config = config;
+    pthread_mutex_init(&builder.lock, NULL);
+
+    size_t taskCount = (size_t)CHARACTER_COUNT * CHARACTER_COUNT * config->gamesPerMatchup;
+    sim_parallel_for(taskCount, config->threads, generate_opening, &builder);
+    pthread_mutex_destroy(&builder.lock);
+    if (builder.failed)
+    {
+        free(builder.records);
+        return false;
+    }
+
+    // 同一個局面保留順序最前面的選擇，結果與執行緒數無關
+    qsort(builder.records, builder.count, sizeof(BookRecord), compare_record);
+    uint64_t unique = 0;
+    for (size_t i = 0; i < builder.count; i++)
+    {
+        if (unique > 0 && builder.records[unique - 1].entry.key == builder.records[i].entry.key)
+        {
+            builder.records[unique - 1].entry.count++;
+            continue;
+        }
+        builder.records[unique++] = builder.records[i];
+    }
+
+    // 負載率不超過一半，線性探測的平均探測次數是常數
+    uint64_t bucketCount = 1;
+    while (bucketCount < unique * 2)
+        bucketCount *= 2;
+    BookEntry *table = calloc(bucketCount, sizeof(BookEntry));
+    if (table == NULL)
+    {
+        free(builder.records);
+        return false;
+    }
+    for (uint64_t i = 0; i < unique; i++)
+    {
+        uint64_t slot = builder.records[i].entry.key & (bucketCount - 1);
+        while (table[slot].key != 0)
+            slot = (slot + 1) & (bucketCount - 1);
+        table[slot] = builder.records[i].entry;
+    }
+
+    bool ok = write_book(path, table, bucketCount, unique);
+    free(table);
+    free(builder.records);
+    if (ok && entryCount != NULL)
+        *entryCount = unique;
+    return ok;
+}
+
+bool book_open(OpeningBook *book, const char *path)
+{
+    memset(book, 0, sizeof(OpeningBook));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        ERROR_LOG("Cannot open opening book %s", path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(BookHeader))
+    {
+        ERROR_LOG("Opening book %s is too small", path);
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        ERROR_LOG("Cannot mmap opening book %s", path);
+        return false;
+    }
+
+    const BookHeader *header = map;
+    uint64_t buckets = header->bucketCount;
+    bool valid = memcmp(header->magic, BOOK_MAGIC, 4) == 0 && header->version == BOOK_VERSION &&
+                 buckets > 0 && (buckets & (buckets - 1)) == 0 &&
+                 buckets <= ((size_t)st.st_size - sizeof(BookHeader)) / sizeof(BookEntry) &&
+                 (size_t)st.st_size == sizeof(BookHeader) + buckets * sizeof(BookEntry);
+    if (!valid)
+    {
+        ERROR_LOG("Invalid opening book %s", path);
+        munmap(map, (size_t)st.st_size);
+        return false;
+    }
+
+    book->map = map;
+    book->size = (size_t)st.st_size;
+    book->header = header;
+    book->entries = (const BookEntry *)(header + 1);
+    return true;
+}
+
+void book_close(OpeningBook *book)
+{
+    if (book->map != NULL)
+        munmap(book->map, book->size);
+    memset(book, 0, sizeof(OpeningBook));
+}
+
+bool book_lookup(const OpeningBook *book, game *gs, vector *choices, int32_t *choice)
+{
+    if (book == NULL || book->header == NULL)
+        return false;
+
+    uint64_t key = book_key(gs);
+    uint64_t mask = book->header->bucketCount - 1;
+    for (uint64_t slot = key & mask, probes = 0; probes <= mask; slot = (slot + 1) & mask, probes++)
+    {
+        const BookEntry *entry = &book->entries[slot];
+        if (entry->key == 0)
+            return false;
+        if (entry->key != key)
+            continue;
+
+        int32_t resolved = resolve_choice(gs, entry);
+        if (findVector(choices, resolved) < 0)
+            return false;
+        *choice = resolved;
+        return true;
+    }
+    return false;
+}
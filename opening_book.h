@@ -0,0 +1,57 @@
+#ifndef _OPENING_BOOK_H
+#define _OPENING_BOOK_H
+
+#include "architecture.h"
+#include "search.h"
+
+// 開局庫：離線以搜尋算出前幾回合常見局面的選擇，存成唯讀檔案，執行時 mmap 後 O(1) 查詢
+// 檔案為 header + 開放定址雜湊表（線性探測），以 hash_observation 的值為鍵（0 表示空位）
+// 數值以產生檔案的機器的位元組順序保存
+
+#define BOOK_MAGIC "TFOB"
+#define BOOK_VERSION 1
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint64_t entryCount;
+    uint64_t bucketCount;  // 2 的次方
+} BookHeader;
+
+typedef struct {
+    uint64_t key;    // 局面雜湊
+    int32_t choice;  // 選擇編碼
+    int32_t cardId;  // 選擇對應的卡牌（手牌、棄牌堆選擇使用），0 表示不對應卡牌
+    int32_t score;   // 搜尋分數
+    uint32_t count;  // 產生時遇到這個局面的次數
+} BookEntry;
+
+typedef struct OpeningBook {
+    void* map;
+    size_t size;
+    const BookHeader* header;
+    const BookEntry* entries;
+} OpeningBook;
+
+typedef struct {
+    uint64_t seed;
+    uint32_t gamesPerMatchup;  // 每組角色配對抽樣的開局數
+    uint32_t bookTurns;        // 收錄前幾回合（雙方合計）
+    SearchConfig search;       // 產生時使用的搜尋設定
+    int threads;               // 0 表示使用全部核心
+} BookConfig;
+
+// 預設：每組配對 8 局、前 2 回合、深度 4 / 20000 節點的搜尋
+void init_book_config(BookConfig* config);
+
+// 產生開局庫檔案（先寫暫存檔再改名）
+bool generate_opening_book(const BookConfig* config, const char* path, uint64_t* entryCount);
+
+// 以 mmap 開啟 / 關閉開局庫
+bool book_open(OpeningBook* book, const char* path);
+void book_close(OpeningBook* book);
+
+// 查詢目前局面，找到且選擇在 choices 中時回傳 true
+bool book_lookup(const OpeningBook* book, game* gameState, vector* choices, int32_t* choice);
+
+#endif // _OPENING_BOOK_H
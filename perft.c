@@ -0,0 +1,218 @@
+#include <pthread.h>
+#include "perft.h"
+#include "game_action.h"
+#include "game_hash.h"
+#include "simulation.h"
+
+// 根節點的選擇通常只有幾個，先在目前執行緒展開到至少 PERFT_SPLIT_TASKS 個節點
+// （最多 PERFT_SPLIT_PLIES 層），每個節點為一個平行任務
+#define PERFT_SPLIT_TASKS 256
+#define PERFT_SPLIT_PLIES 4
+
+// 任務只保存從根節點出發的選擇序列，執行時重新套用（局面很大，不逐一保存）
+typedef struct {
+    int32_t path[PERFT_SPLIT_PLIES];
+    uint32_t rootIndex;
+} PerftTask;
+
+typedef struct {
+    const PerftConfig *config;
+    game *root;
+    RngState rootRng;
+    PerftTask *tasks;
+    int splitPly;            // 所有任務的節點都在這一層
+    PerftResult *result;
+    pthread_mutex_t lock;    // 合併到 result（只有整數加總，合併順序不影響結果）
+} PerftRun;
+
+// 產生合法選擇；勝負已分或沒有選擇時回傳 false
+static bool expand_node(game *gs, vector *choices)
+{
+    if (get_winner(gs) >= 0)
+        return false;
+    get_legal_choices(gs, choices);
+    return choices->SIZE > 0;
+}
+
+// 套用一個選擇：子節點的洗牌使用父節點亂數的副本，與展開順序無關
+static bool apply_child(game *child, game *parent, RngState *childRng, const RngState *parentRng, int32_t choice)
+{
+    clone_game(child, parent);
+    *childRng = *parentRng;
+    rng_set_active(childRng);
+    return apply_choice(child, choice);
+}
+
+// frames[ply] 為第 ply 層局面的位置
+static void perft_node(const PerftConfig *config, game *frames, int ply, RngState *rng, PerftCounts *counts)
+{
+    game *gs = &frames[ply];
+    counts->nodes[ply]++;
+    if (ply == config->depth)
+    {
+        if (config->hashLeaves)
+            counts->leafHash += hash_game(gs);
+        return;
+    }
+
+    vector choices;
+    if (!expand_node(gs, &choices))
+    {
+        counts->terminals++;
+        return;
+    }
+
+    for (uint32_t i = 0; i < choices.SIZE; i++)
+    {
+        RngState childRng;
+        if (!apply_child(&frames[ply + 1], gs, &childRng, rng, choices.array[i]))
+        {
+            counts->rejected++;
+            continue;
+        }
+        perft_node(config, frames, ply + 1, &childRng, counts);
+    }
+}
+
+// 由根節點重新套用選擇序列，結果寫入 frames[length]
+static void replay_path(PerftRun *run, const int32_t *path, int length, game *frames, RngState *rng)
+{
+    frames[0] = *run->root;
+    *rng = run->rootRng;
+    for (int ply = 0; ply < length; ply++)
+    {
+        RngState childRng;
+        apply_child(&frames[ply + 1], &frames[ply], &childRng, rng, path[ply]);
+        *rng = childRng;
+    }
+}
+
+static void merge_counts(PerftCounts *total, const PerftCounts *counts, int depth)
+{
+    for (int d = 0; d <= depth; d++)
+        total->nodes[d] += counts->nodes[d];
+    total->terminals += counts->terminals;
+    total->rejected += counts->rejected;
+    total->leafHash += counts->leafHash;
+}
+
+static void run_perft_task(void *ctx, size_t index)
+{
+    PerftRun *run = ctx;
+    const PerftTask *task = &run->tasks[index];
+    game *frames = malloc((size_t)(run->config->depth + 1) * sizeof(game));
+    if (frames == NULL)
+        return;
+
+    RngState *previous = rng_get_active();
+    RngState rng;
+    PerftCounts counts;
+    memset(&counts, 0, sizeof(counts));
+    replay_path(run, task->path, run->splitPly, frames, &rng);
+    perft_node(run->config, frames, run->splitPly, &rng, &counts);
+    rng_set_active(previous);
+    free(frames);
+
+    pthread_mutex_lock(&run->lock);
+    merge_counts(&run->result->total, &counts, run->config->depth);
+    run->result->rootLeaves[task->rootIndex] += counts.nodes[run->config->depth];
+    pthread_mutex_unlock(&run->lock);
+}
+
+// 逐層展開直到任務數足夠；展開過的節點直接計入 total，回傳最後一層的任務
+static PerftTask *split_tasks(PerftRun *run, size_t *taskCount)
+{
+    const PerftConfig *config = run->config;
+    PerftCounts *total = &run->result->total;
+    game *frames = malloc((PERFT_SPLIT_PLIES + 1) * sizeof(game));
+    PerftTask *tasks = calloc(1, sizeof(PerftTask));
+    size_t count = 1;
+    run->splitPly = 0;
+
+    while (frames != NULL && tasks != NULL && count < PERFT_SPLIT_TASKS && run->splitPly < PERFT_SPLIT_PLIES &&
+           run->splitPly < config->depth)
+    {
+        int ply = run->splitPly;
+        PerftTask *next = NULL;
+        size_t nextCount = 0;
+        for (size_t t = 0; t < count; t++)
+        {
+            RngState rng;
+            vector choices;
+            replay_path(run, tasks[t].path, ply, frames, &rng);
+            total->nodes[ply]++;
+            if (!expand_node(&frames[ply], &choices))
+            {
+                total->terminals++;
+                continue;
+            }
+            if (ply == 0)
+            {
+                run->result->rootCount = choices.SIZE;
+                memcpy(run->result->rootChoices, choices.array, choices.SIZE * sizeof(int32_t));
+            }
+
+            PerftTask *grown = realloc(next, (nextCount + choices.SIZE) * sizeof(PerftTask));
+            if (grown == NULL)
+                break;
+            next = grown;
+            for (uint32_t i = 0; i < choices.SIZE; i++)
+            {
+                RngState childRng;
+                if (!apply_child(&frames[ply + 1], &frames[ply], &childRng, &rng, choices.array[i]))
+                {
+                    total->rejected++;
+                    continue;
+                }
+                PerftTask *task = &next[nextCount++];
+                *task = tasks[t];
+                task->path[ply] = choices.array[i];
+                if (ply == 0)
+                    task->rootIndex = i;
+            }
+        }
+        free(tasks);
+        tasks = next;
+        count = nextCount;
+        run->splitPly = ply + 1;
+        if (count == 0)
+            break;
+    }
+    free(frames);
+    *taskCount = count;
+    return tasks;
+}
+
+void init_perft_config(PerftConfig *config)
+{
+    config->depth = 3;
+    config->seed = 1;
+    config->hashLeaves = false;
+    config->threads = 0;
+}
+
+void run_perft(const PerftConfig *config, game *gs, PerftResult *result)
+{
+    memset(result, 0, sizeof(PerftResult));
+    if (config->depth <= 0 || config->depth > PERFT_MAX_DEPTH)
+    {
+        result->total.nodes[0] = 1;
+        return;
+    }
+
+    PerftRun run;
+    run.config = config;
+    run.root = gs;
+    rng_seed(&run.rootRng, config->seed, 0);
+    run.result = result;
+    pthread_mutex_init(&run.lock, NULL);
+
+    RngState *previous = rng_get_active();
+    size_t taskCount;
+    run.tasks = split_tasks(&run, &taskCount);
+    rng_set_active(previous);
+    if (run.tasks != NULL)
+        sim_parallel_for(taskCount, config->threads, run_perft_task, &run);
+    free(run.tasks);
+    pthread_mutex_destroy(&run.lock);
+}
@@ -0,0 +1,40 @@
+#ifndef _PERFT_H
+#define _PERFT_H
+
+#include "architecture.h"
+#include "rng.h"
+
+// 選擇樹的節點計數（仿照西洋棋引擎的 perft）
+// 從局面展開所有合法選擇到指定深度，回報每一層的節點數；回合結束的洗牌使用父節點亂數的副本，
+// 同一個種子的結果固定，可以在最佳化前後比較行動產生與狀態轉換是否改變，也可當作吞吐量基準
+
+#define PERFT_MAX_DEPTH 32
+
+typedef struct {
+    uint64_t nodes[PERFT_MAX_DEPTH + 1];  // 第 d 層的節點數（nodes[0] 為根節點）
+    uint64_t terminals;  // 未達深度就結束的節點（勝負已分或沒有合法選擇）
+    uint64_t rejected;   // apply_choice 拒絕合法選擇的次數（正常應為 0）
+    uint64_t leafHash;   // 最深一層局面 hash_game 的總和（hashLeaves 時），與展開順序無關
+} PerftCounts;
+
+typedef struct {
+    int depth;           // 1 到 PERFT_MAX_DEPTH，超出範圍時只有根節點
+    uint64_t seed;       // 根節點亂數 (seed, 0)
+    bool hashLeaves;     // 是否計算 leafHash（會降低速度）
+    int threads;         // 0 表示使用全部核心；結果與執行緒數無關
+} PerftConfig;
+
+typedef struct {
+    PerftCounts total;
+    uint32_t rootCount;             // 根節點的合法選擇數
+    int32_t rootChoices[256];
+    uint64_t rootLeaves[256];       // 每個根選擇之下最深一層的節點數（divide）
+} PerftResult;
+
+// 預設：深度 3、種子 1、不計算雜湊、使用全部核心
+void init_perft_config(PerftConfig* config);
+
+// 不改變 gameState 與目前執行緒的亂數來源
+void run_perft(const PerftConfig* config, game* gameState, PerftResult* result);
+
+#endif // _PERFT_H
@@ -0,0 +1,153 @@
+#include <dlfcn.h>
+#include "plugin_loader.h"
+#include "debug_log.h"
+#include "game_features.h"
+
+static LoadedPlugin loadedPlugins[PLUGIN_MAX_LOADED];
+static int loadedCount = 0;
+
+static TfCardList card_list(vector *cards)
+{
+    TfCardList list = {cards->array, cards->SIZE};
+    return list;
+}
+
+static void build_player_view(player *p, TfPlayerView *view)
+{
+    view->character = p->character;
+    view->life = p->life;
+    view->maxLife = p->maxlife;
+    view->defense = p->defense;
+    view->maxDefense = p->maxdefense;
+    view->energy = p->energy;
+    view->specialGate = p->specialGate;
+    view->position = p->locate[0];
+    view->hand = card_list(&p->hand);
+    view->deck = card_list(&p->deck);
+    view->graveyard = card_list(&p->graveyard);
+    view->usecards = card_list(&p->usecards);
+    view->metamorphosis = card_list(&p->metamorphosis);
+}
+
+void build_game_view(game *gs, const int8_t *features, TfGameView *view)
+{
+    memset(view, 0, sizeof(TfGameView));
+    view->size = sizeof(TfGameView);
+    view->self = gs->now_turn_player_id;
+    view->status = gs->status;
+    view->nowAtk = gs->nowATK;
+    view->nowDef = gs->nowDEF;
+    view->nowMov = gs->nowMOV;
+    view->nowUsingCardId = gs->nowUsingCardID;
+    view->showingCards = card_list(&gs->nowShowingCards);
+    build_player_view(&gs->players[0], &view->players[0]);
+    build_player_view(&gs->players[1], &view->players[1]);
+    view->features = features;
+    view->featureCount = features != NULL ? FEATURE_COUNT : 0;
+    view->engine = gs;
+}
+
+bool check_bot_plugin(const TfBotPlugin *plugin)
+{
+    // 先確認 size，再讀取其他欄位（舊版外掛的結構可能比較短）
+    return plugin != NULL && plugin->size >= TF_PLUGIN_MIN_SIZE && plugin->abiVersion == TF_PLUGIN_ABI_VERSION &&
+           plugin->name != NULL && plugin->choose != NULL;
+}
+
+static int32_t plugin_choose(void *ctx, game *gs, vector *choices, RngState *rng)
+{
+    LoadedPlugin *loaded = ctx;
+    int8_t features[FEATURE_COUNT];
+    bool wantsFeatures = (loaded->plugin->flags & TF_PLUGIN_WANTS_FEATURES) != 0;
+    if (wantsFeatures)
+        extract_features_int8(gs, gs->now_turn_player_id, features);
+
+    TfGameView view;
+    build_game_view(gs, wantsFeatures ? features : NULL, &view);
+    uint64_t random = (uint64_t)rng_next(rng) << 32;
+    random |= rng_next(rng);
+
+    int32_t choice = loaded->plugin->choose(loaded->instance, &view, choices->array, choices->SIZE, random);
+    if (findVector(choices, choice) < 0)
+    {
+        atomic_fetch_add(&loaded->invalidChoices, 1);
+        choice = choices->array[0];
+    }
+    return choice;
+}
+
+const LoadedPlugin *load_bot_plugin(const char *spec)
+{
+    if (loadedCount == PLUGIN_MAX_LOADED)
+    {
+        ERROR_LOG("Too many plugins (at most %d)", PLUGIN_MAX_LOADED);
+        return NULL;
+    }
+
+    // FILE:ARGS，只在最後一個 '/' 之後找 ':'
+    LoadedPlugin *loaded = &loadedPlugins[loadedCount];
+    memset(loaded, 0, sizeof(LoadedPlugin));
+    const char *base = strrchr(spec, '/');
+    const char *colon = strchr(base != NULL ? base : spec, ':');
+    size_t pathLength = colon != NULL ? (size_t)(colon - spec) : strlen(spec);
+    const char *args = colon != NULL ? colon + 1 : "";
+    snprintf(loaded->path, sizeof(loaded->path), "%s%.*s", base != NULL ? "" : "./", (int)pathLength, spec);
+
+    loaded->handle = dlopen(loaded->path, RTLD_NOW | RTLD_LOCAL);
+    if (loaded->handle == NULL)
+    {
+        ERROR_LOG("Cannot load plugin %s: %s", loaded->path, dlerror());
+        return NULL;
+    }
+
+    TfBotPluginEntry entry = (TfBotPluginEntry)dlsym(loaded->handle, TF_PLUGIN_ENTRY);
+    loaded->plugin = entry != NULL ? entry() : NULL;
+    const TfBotPlugin *plugin = loaded->plugin;
+    if (!check_bot_plugin(plugin))
+    {
+        ERROR_LOG("Plugin %s does not export a version %d %s", loaded->path, TF_PLUGIN_ABI_VERSION, TF_PLUGIN_ENTRY);
+        dlclose(loaded->handle);
+        return NULL;
+    }
+
+    loaded->instance = plugin->create != NULL ? plugin->create(args) : NULL;
+    if (plugin->create != NULL && loaded->instance == NULL)
+    {
+        ERROR_LOG("Plugin %s failed to initialize with \"%s\"", plugin->name, args);
+        dlclose(loaded->handle);
+        return NULL;
+    }
+
+    loaded->policy.name = plugin->name;
+    loaded->policy.description = plugin->description != NULL ? plugin->description : "Plugin bot";
+    loaded->policy.choose = plugin_choose;
+    loaded->policy.ctx = loaded;
+    atomic_init(&loaded->invalidChoices, 0);
+    if (!register_bot_policy(&loaded->policy))
+    {
+        ERROR_LOG("Cannot register plugin bot %s (duplicate name?)", plugin->name);
+        if (plugin->destroy != NULL)
+            plugin->destroy(loaded->instance);
+        dlclose(loaded->handle);
+        return NULL;
+    }
+    loadedCount++;
+    return loaded;
+}
+
+void unload_bot_plugins(void)
+{
+    for (int i = loadedCount - 1; i >= 0; i--)
+    {
+        LoadedPlugin *loaded = &loadedPlugins[i];
+        uint64_t invalid = atomic_load(&loaded->invalidChoices);
+        if (invalid > 0)
+            WARN_LOG("Plugin %s returned %llu illegal choices", loaded->plugin->name, (unsigned long long)invalid);
+        unregister_bot_policy(&loaded->policy);
+        if (loaded->plugin->destroy != NULL)
+            loaded->plugin->destroy(loaded->instance);
+        dlclose(loaded->handle);
+        memset(loaded, 0, sizeof(LoadedPlugin));
+    }
+    loadedCount = 0;
+}
@@ -0,0 +1,35 @@
+#ifndef _PLUGIN_LOADER_H
+#define _PLUGIN_LOADER_H
+
+#include <stdatomic.h>
+#include "architecture.h"
+#include "bot.h"
+#include "bot_plugin.h"
+
+// 以 dlopen 載入電腦玩家外掛（ABI 見 bot_plugin.h），並註冊為一般的策略
+
+#define PLUGIN_MAX_LOADED BOT_MAX_REGISTERED
+
+typedef struct {
+    void* handle;           // dlopen 的結果
+    const TfBotPlugin* plugin;
+    void* instance;         // plugin->create 的結果
+    BotPolicy policy;       // 註冊的策略，ctx 指向這個結構
+    char path[1024];
+    atomic_uint_fast64_t invalidChoices;  // 外掛回傳不合法選擇的次數
+} LoadedPlugin;
+
+// 載入外掛並註冊策略；spec 為 FILE 或 FILE:ARGS（檔名中不含 '/' 時以 ./FILE 開啟）
+// 失敗時回傳 NULL（錯誤寫入日誌）
+const LoadedPlugin* load_bot_plugin(const char* spec);
+
+// 外掛回傳的結構是否可以使用：size 至少為 TF_PLUGIN_MIN_SIZE、ABI 版本相同、有名稱與 choose
+bool check_bot_plugin(const TfBotPlugin* plugin);
+
+// 移除所有外掛的策略並卸載
+void unload_bot_plugins(void);
+
+// 由局面建立外掛看到的唯讀畫面（features 為 NULL 時不提供特徵）
+void build_game_view(game* gameState, const int8_t* features, TfGameView* view);
+
+#endif // _PLUGIN_LOADER_H
@@ -0,0 +1,157 @@
+#include "ponder.h"
+#include "debug_log.h"
+#include "game_action.h"
+#include "game_hash.h"
+
+bool ponder_init(Ponderer *ponder, const SearchConfig *config, int8_t playerId, size_t ttMegabytes)
+{
+    memset(ponder, 0, sizeof(Ponderer));
+    if (!tt_init(&ponder->table, ttMegabytes))
+        return false;
+    ponder->config = *config;
+    ponder->config.table = &ponder->table;
+    ponder->config.stop = NULL;
+    ponder->playerId = playerId;
+    return true;
+}
+
+void ponder_free(Ponderer *ponder)
+{
+    ponder_stop(ponder);
+    tt_free(&ponder->table);
+}
+
+// 套用對手的選擇，回傳之後是否輪到電腦玩家做選擇
+static bool predict_reply(const Ponderer *ponder, int32_t reply, game *next, RngState *rng)
+{
+    *next = ponder->state;
+    *rng = ponder->gameRng;
+    RngState *previous = rng_get_active();
+    rng_set_active(rng);
+    bool applied = apply_choice(next, reply);
+    rng_set_active(previous);
+    return applied && get_winner(next) < 0 && next->now_turn_player_id == ponder->playerId;
+}
+
+static void *ponder_thread(void *arg)
+{
+    Ponderer *ponder = arg;
+    SearchConfig config = ponder->config;
+    game next;
+    RngState gameRng;
+
+    for (uint32_t i = 0; i < ponder->entryCount; i++)
+    {
+        PonderEntry *entry = &ponder->entries[i];
+        if (atomic_load(&entry->abort))
+            continue;
+        predict_reply(ponder, entry->reply, &next, &gameRng);
+
+        vector choices;
+        get_legal_choices(&next, &choices);
+        config.stop = &entry->abort;
+        entry->rngAfter = ponder->searchRng;
+        search_choose(&config, &next, &choices, &entry->rngAfter, &entry->result);
+        entry->done = !atomic_load(&entry->abort);
+    }
+    return NULL;
+}
+
+void ponder_start(Ponderer *ponder, game *gs, const RngState *gameRng, const RngState *searchRng)
+{
+    ponder_stop(ponder);
+    ponder->state = *gs;
+    ponder->gameRng = *gameRng;
+    ponder->searchRng = *searchRng;
+    ponder->entryCount = 0;
+
+    // 依對手套用後的評估值排序，越可能的選擇越先預想
+    int32_t scores[PONDER_MAX_REPLIES];
+    int8_t opponent = gs->now_turn_player_id;
+    vector replies;
+    get_legal_choices(gs, &replies);
+    for (uint32_t i = 0; i < replies.SIZE && ponder->entryCount < PONDER_MAX_REPLIES; i++)
+    {
+        game next;
+        RngState rng;
+        if (!predict_reply(ponder, replies.array[i], &next, &rng))
+            continue;
+
+        int32_t score = ponder->config.eval(ponder->config.evalCtx, &next, opponent);
+        uint32_t slot = ponder->entryCount++;
+        while (slot > 0 && scores[slot - 1] < score)
+        {
+            scores[slot] = scores[slot - 1];
+            ponder->entries[slot].hash = ponder->entries[slot - 1].hash;
+            ponder->entries[slot].reply = ponder->entries[slot - 1].reply;
+            slot--;
+        }
+        scores[slot] = score;
+        ponder->entries[slot].hash = hash_game(&next);
+        ponder->entries[slot].reply = replies.array[i];
+    }
+    for (uint32_t i = 0; i < ponder->entryCount; i++)
+    {
+        atomic_init(&ponder->entries[i].abort, false);
+        ponder->entries[i].done = false;
+    }
+
+    if (ponder->entryCount == 0)
+        return;
+    if (pthread_create(&ponder->thread, NULL, ponder_thread, ponder) != 0)
+    {
+        ERROR_LOG("Cannot start ponder thread");
+        ponder->entryCount = 0;
+        return;
+    }
+    ponder->running = true;
+}
+
+// 中斷 hash 以外的預想（hash 為 0 時全部中斷）並等待執行緒結束
+static void finish_pondering(Ponderer *ponder, uint64_t hash)
+{
+    if (!ponder->running)
+        return;
+    for (uint32_t i = 0; i < ponder->entryCount; i++)
+    {
+        if (hash == 0 || ponder->entries[i].hash != hash)
+            atomic_store(&ponder->entries[i].abort, true);
+    }
+    pthread_join(ponder->thread, NULL);
+    ponder->running = false;
+}
+
+void ponder_stop(Ponderer *ponder)
+{
+    finish_pondering(ponder, 0);
+    ponder->entryCount = 0;
+}
+
+int32_t ponder_choose(Ponderer *ponder, game *gs, vector *choices, RngState *searchRng, SearchResult *result,
+                      bool *hit)
+{
+    uint64_t hash = hash_game(gs);
+    bool pondered = ponder->running;
+    finish_pondering(ponder, hash);
+
+    for (uint32_t i = 0; i < ponder->entryCount; i++)
+    {
+        PonderEntry *entry = &ponder->entries[i];
+        if (entry->hash != hash || !entry->done || findVector(choices, entry->result.bestChoice) < 0)
+            continue;
+        *result = entry->result;
+        *searchRng = entry->rngAfter;
+        ponder->entryCount = 0;
+        ponder->hits++;
+        if (hit != NULL)
+            *hit = true;
+        return result->bestChoice;
+    }
+
+    ponder->entryCount = 0;
+    if (pondered)
+        ponder->misses++;
+    if (hit != NULL)
+        *hit = false;
+    return search_choose(&ponder->config, gs, choices, searchRng, result);
+}
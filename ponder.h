@@ -0,0 +1,55 @@
+#ifndef _PONDER_H
+#define _PONDER_H
+
+#include <pthread.h>
+#include "architecture.h"
+#include "search.h"
+
+// 對手思考時在背景執行緒預先搜尋（pondering）
+// 開始時把對手目前每個合法選擇套用到局面副本上（回合結束的洗牌使用對局亂數的副本，結果與實際相同），
+// 會換到電腦玩家行動的選擇依對手的可能性排序後逐一預先搜尋，結果保存起來；
+// 對手真正選擇後若局面與預想的相同，等那一個搜尋完成（其他的立即中斷）即可回應，
+// 沒有命中時改用一般搜尋，但沿用預想時填好的置換表
+
+#define PONDER_MAX_REPLIES 32
+
+typedef struct {
+    uint64_t hash;        // 套用對手選擇後的局面雜湊
+    int32_t reply;        // 對手的選擇
+    atomic_bool abort;    // 中斷這一個預想
+    bool done;            // 搜尋完整結束
+    SearchResult result;
+    RngState rngAfter;    // 搜尋後電腦亂數的狀態（命中時與實際搜尋後相同）
+} PonderEntry;
+
+typedef struct {
+    SearchConfig config;        // 搜尋設定（table 指向自己的置換表）
+    TranspositionTable table;
+    int8_t playerId;            // 電腦玩家
+    bool running;
+    pthread_t thread;
+    game state;                 // 開始預想時的局面（對手行動中）
+    RngState gameRng;           // 對局亂數的副本
+    RngState searchRng;         // 電腦搜尋亂數的副本
+    PonderEntry entries[PONDER_MAX_REPLIES];
+    uint32_t entryCount;
+    uint64_t hits;
+    uint64_t misses;
+} Ponderer;
+
+// config 為電腦玩家的搜尋設定（table、stop 會被忽略），置換表大小為 ttMegabytes
+bool ponder_init(Ponderer* ponder, const SearchConfig* config, int8_t playerId, size_t ttMegabytes);
+void ponder_free(Ponderer* ponder);
+
+// 對手行動時開始預想（會先停止前一次的預想）
+// gameRng、searchRng 為對局與電腦搜尋目前的亂數，只會複製不會改變
+void ponder_start(Ponderer* ponder, game* gameState, const RngState* gameRng, const RngState* searchRng);
+
+// 停止並等待背景執行緒結束
+void ponder_stop(Ponderer* ponder);
+
+// 輪到電腦時做出選擇：命中預想時直接使用預想的結果，否則搜尋；hit 可為 NULL
+int32_t ponder_choose(Ponderer* ponder, game* gameState, vector* choices, RngState* searchRng,
+                      SearchResult* result, bool* hit);
+
+#endif // _PONDER_H
@@ -0,0 +1,158 @@
+#include <time.h>
+#include "purchase_advisor.h"
+#include "game_action.h"
+#include "search.h"
+#include "simulation.h"
+
+// 未分勝負時的評估分數壓縮：分差等於這個值（約 10 點生命）時為 0.5
+#define ADVISOR_EVAL_SCALE 1000.0
+
+// 模擬中的選擇數上限（避免策略卡在不結束回合的循環）
+#define ADVISOR_MAX_CHOICES 2000
+
+typedef struct {
+    const AdvisorConfig *config;
+    game *start;               // BUY_CARD_TYPE 的局面
+    int8_t buyer;
+    const BotPolicy *bot;
+    PurchaseAdvice *advice;
+    uint32_t firstRollout;     // 這一輪第一次模擬的編號
+    double values[ADVISOR_MAX_OPTIONS][ADVISOR_ROUND_ROLLOUTS];
+} AdvisorRound;
+
+void init_advisor_config(AdvisorConfig *config)
+{
+    config->rolloutsPerOption = 64;
+    config->timeBudgetMs = 0;
+    config->rolloutTurns = 4;
+    config->rolloutBot = find_bot_policy("greedy");
+    config->seed = 1;
+    config->threads = 0;
+}
+
+static double rollout_value(game *gs, int8_t buyer)
+{
+    int winner = get_winner(gs);
+    if (winner >= 0)
+        return winner == buyer ? 1.0 : -1.0;
+    double score = evaluate_game(NULL, gs, buyer);
+    return score / (ADVISOR_EVAL_SCALE + (score < 0 ? -score : score));
+}
+
+static void run_rollout(void *ctx, size_t task)
+{
+    AdvisorRound *round = ctx;
+    const AdvisorConfig *config = round->config;
+    size_t option = task / ADVISOR_ROUND_ROLLOUTS;
+    size_t slot = task % ADVISOR_ROUND_ROLLOUTS;
+
+    game *gs = malloc(sizeof(game));
+    if (gs == NULL)
+    {
+        round->values[option][slot] = 0.0;
+        return;
+    }
+    clone_game(gs, round->start);
+    RngState rng;
+    rng_seed(&rng, config->seed, round->firstRollout + slot);
+    RngState *previous = rng_get_active();
+    rng_set_active(&rng);
+
+    apply_choice(gs, round->advice->options[option].choice);
+    uint32_t turns = 0;
+    vector choices;
+    for (int i = 0; i < ADVISOR_MAX_CHOICES && turns < config->rolloutTurns && get_winner(gs) < 0; i++)
+    {
+        get_legal_choices(gs, &choices);
+        if (choices.SIZE == 0)
+            break;
+        int8_t mover = gs->now_turn_player_id;
+        if (!apply_choice(gs, bot_choose(round->bot, gs, &choices, &rng)))
+            break;
+        if (gs->now_turn_player_id != mover)
+            turns++;
+    }
+    round->values[option][slot] = rollout_value(gs, round->buyer);
+    rng_set_active(previous);
+    free(gs);
+}
+
+static double elapsed_ms(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1000.0 + (double)(now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+bool advise_purchase(const AdvisorConfig *config, game *gs, PurchaseAdvice *advice)
+{
+    memset(advice, 0, sizeof(PurchaseAdvice));
+    vector choices;
+    get_legal_choices(gs, &choices);
+    if (gs->status != BUY_CARD_TYPE && !(gs->status == CHOOSE_MOVE && findVector(&choices, 6) >= 0))
+        return false;
+
+    AdvisorRound *round = malloc(sizeof(AdvisorRound));
+    game *start = malloc(sizeof(game));
+    if (round == NULL || start == NULL)
+    {
+        free(round);
+        free(start);
+        return false;
+    }
+    clone_game(start, gs);
+    if (start->status == CHOOSE_MOVE)
+    {
+        // 選擇購買不會洗牌，不需要設定亂數
+        apply_choice(start, 6);
+        get_legal_choices(start, &choices);
+    }
+
+    for (uint32_t i = 0; i < choices.SIZE && i < ADVISOR_MAX_OPTIONS; i++)
+    {
+        PurchaseOption *option = &advice->options[advice->count++];
+        option->choice = choices.array[i];
+        option->cardId = get_purchase_card(start, option->choice);
+        option->cost = get_purchase_cost(start, option->choice);
+    }
+
+    round->config = config;
+    round->start = start;
+    round->buyer = start->now_turn_player_id;
+    round->bot = config->rolloutBot != NULL ? config->rolloutBot : find_bot_policy("greedy");
+    round->advice = advice;
+    double totals[ADVISOR_MAX_OPTIONS] = {0};
+    struct timespec begin;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+
+    for (uint32_t done = 0; advice->count > 0 && done < config->rolloutsPerOption; done += ADVISOR_ROUND_ROLLOUTS)
+    {
+        if (done > 0 && config->timeBudgetMs > 0 && elapsed_ms(&begin) >= config->timeBudgetMs)
+            break;
+        round->firstRollout = done;
+        sim_parallel_for(advice->count * ADVISOR_ROUND_ROLLOUTS, config->threads, run_rollout, round);
+        for (uint32_t i = 0; i < advice->count; i++)
+        {
+            for (int r = 0; r < ADVISOR_ROUND_ROLLOUTS; r++)
+                totals[i] += round->values[i][r];
+            advice->options[i].rollouts += ADVISOR_ROUND_ROLLOUTS;
+        }
+        advice->rollouts += (uint64_t)advice->count * ADVISOR_ROUND_ROLLOUTS;
+    }
+    for (uint32_t i = 0; i < advice->count; i++)
+        advice->options[i].value = advice->options[i].rollouts > 0 ? totals[i] / advice->options[i].rollouts : 0.0;
+
+    // 插入排序（最多 14 個），同分時保留原本的順序
+    for (uint32_t i = 1; i < advice->count; i++)
+    {
+        PurchaseOption option = advice->options[i];
+        uint32_t j = i;
+        for (; j > 0 && advice->options[j - 1].value < option.value; j--)
+            advice->options[j] = advice->options[j - 1];
+        advice->options[j] = option;
+    }
+
+    free(round);
+    free(start);
+    return advice->count > 0;
+}
@@ -0,0 +1,44 @@
+#ifndef _PURCHASE_ADVISOR_H
+#define _PURCHASE_ADVISOR_H
+
+#include "architecture.h"
+#include "bot.h"
+
+// 購買建議：對每個買得起的選項，從局面副本買下後以策略模擬幾個回合，依平均結果排序
+// 每個選項的第 r 次模擬使用相同的亂數串流 (seed, r)，選項之間只差在買了什麼，比較的雜訊較小
+// 模擬以輪為單位平行進行，每輪每個選項各模擬 ADVISOR_ROUND_ROLLOUTS 次；超過時間預算就停在該輪
+
+#define ADVISOR_ROUND_ROLLOUTS 8
+#define ADVISOR_MAX_OPTIONS 14
+
+typedef struct {
+    uint32_t rolloutsPerOption;  // 每個選項最多模擬次數（進位到 ADVISOR_ROUND_ROLLOUTS 的倍數）
+    uint32_t timeBudgetMs;       // 0 表示不限時間（結果完全可重現）；至少會完成一輪
+    uint32_t rolloutTurns;       // 模擬的回合數，之後以 evaluate_game 評估
+    const BotPolicy* rolloutBot; // 模擬雙方使用的策略（NULL 表示 greedy）
+    uint64_t seed;
+    int threads;                 // 0 表示使用全部核心；在模擬中的電腦玩家裡使用時應為 1
+} AdvisorConfig;
+
+typedef struct {
+    int32_t choice;    // BUY_CARD_TYPE 的選擇
+    int32_t cardId;    // 會買到的卡牌
+    int32_t cost;
+    uint32_t rollouts;
+    double value;      // 以購買方角度的平均結果：勝 1、負 -1，未分勝負時為評估分數壓縮到 (-1, 1)
+} PurchaseOption;
+
+typedef struct {
+    PurchaseOption options[ADVISOR_MAX_OPTIONS];  // 由好到壞排序
+    uint32_t count;
+    uint64_t rollouts;
+} PurchaseAdvice;
+
+// 預設：每個選項 64 次、不限時間、模擬 4 回合、greedy 策略、種子 1、使用全部核心
+void init_advisor_config(AdvisorConfig* config);
+
+// 局面需在 BUY_CARD_TYPE，或在 CHOOSE_MOVE 且可以購買（以選擇購買之後的局面評估）
+// 沒有可買的選項時回傳 false；不改變 gameState 與目前執行緒的亂數來源
+bool advise_purchase(const AdvisorConfig* config, game* gameState, PurchaseAdvice* advice);
+
+#endif // _PURCHASE_ADVISOR_H
@@ -0,0 +1,240 @@
+#include <stdatomic.h>
+#include "rl_env.h"
+#include "character_system.h"
+#include "debug_log.h"
+#include "game_action.h"
+#include "game_init.h"
+#include "simulation.h"
+
+void rl_env_init_config(RlEnvConfig *config)
+{
+    config->batchSize = 64;
+    config->characters[0] = RL_RANDOM_CHARACTER;
+    config->characters[1] = RL_RANDOM_CHARACTER;
+    config->opponent = NULL;
+    config->agentSeat = -1;
+    config->maxChoices = 2000;
+    config->threads = 1;
+}
+
+bool rl_env_create(RlEnv *env, const RlEnvConfig *config)
+{
+    memset(env, 0, sizeof(RlEnv));
+    env->config = *config;
+    size_t batch = config->batchSize;
+    if (batch == 0)
+        return false;
+
+    env->games = malloc(batch * sizeof(game));
+    env->gameRngs = malloc(batch * sizeof(RngState));
+    env->botRngs = malloc(batch * sizeof(RngState));
+    env->episodes = calloc(batch, sizeof(uint64_t));
+    env->steps = calloc(batch, sizeof(uint32_t));
+    env->agentSeats = calloc(batch, sizeof(int8_t));
+    rl_env_record_layout(config->batchSize, &env->layout);
+    env->ownedRecord = aligned_alloc(64, env->layout.size);
+    if (env->games == NULL || env->gameRngs == NULL || env->botRngs == NULL || env->episodes == NULL ||
+        env->steps == NULL || env->agentSeats == NULL || env->ownedRecord == NULL)
+    {
+        ERROR_LOG("Cannot allocate %zu RL environments", batch);
+        rl_env_destroy(env);
+        return false;
+    }
+    memset(env->ownedRecord, 0, env->layout.size);
+    rl_env_bind_record(env, NULL);
+    return true;
+}
+
+void rl_env_destroy(RlEnv *env)
+{
+    free(env->games);
+    free(env->gameRngs);
+    free(env->botRngs);
+    free(env->episodes);
+    free(env->steps);
+    free(env->agentSeats);
+    free(env->ownedRecord);
+    memset(env, 0, sizeof(RlEnv));
+}
+
+static size_t align_record(size_t offset)
+{
+    return (offset + 63) & ~(size_t)63;
+}
+
+void rl_env_record_layout(uint32_t batchSize, RlRecordLayout *layout)
+{
+    size_t offset = 0;
+    layout->actions = offset;
+    offset = align_record(offset + batchSize * sizeof(int32_t));
+    layout->observations = offset;
+    offset = align_record(offset + (size_t)batchSize * RL_OBS_SIZE * sizeof(float));
+    layout->legalMasks = offset;
+    offset = align_record(offset + (size_t)batchSize * RL_ACTION_COUNT);
+    layout->rewards = offset;
+    offset = align_record(offset + batchSize * sizeof(float));
+    layout->dones = offset;
+    offset = align_record(offset + batchSize);
+    layout->toPlay = offset;
+    offset = align_record(offset + batchSize);
+    layout->size = offset;
+}
+
+void rl_env_bind_record(RlEnv *env, void *record)
+{
+    uint8_t *base = record != NULL ? record : env->ownedRecord;
+    env->record = base;
+    env->actions = (int32_t *)(base + env->layout.actions);
+    env->observations = (float *)(base + env->layout.observations);
+    env->legalMasks = base + env->layout.legalMasks;
+    env->rewards = (float *)(base + env->layout.rewards);
+    env->dones = base + env->layout.dones;
+    env->toPlay = (int8_t *)(base + env->layout.toPlay);
+}
+
+// choices 為目前局面的合法選擇
+static void write_outputs(RlEnv *env, size_t index, vector *choices)
+{
+    game *gs = &env->games[index];
+    int8_t self = gs->now_turn_player_id;
+    extract_features(gs, self, env->observations + index * RL_OBS_SIZE);
+
+    uint8_t *mask = env->legalMasks + index * RL_ACTION_COUNT;
+    memset(mask, 0, RL_ACTION_COUNT);
+    for (uint32_t i = 0; i < choices->SIZE; i++)
+    {
+        int32_t action = RL_CHOICE_TO_ACTION(choices->array[i]);
+        if (action >= 0 && action < RL_ACTION_COUNT)
+            mask[action] = 1;
+    }
+    env->toPlay[index] = self;
+}
+
+// 有對手時讓對手行動，直到輪到呼叫端或分出勝負
+static void play_opponent(RlEnv *env, size_t index)
+{
+    game *gs = &env->games[index];
+    const BotPolicy *opponent = env->config.opponent;
+    if (opponent == NULL)
+        return;
+
+    vector choices;
+    while (gs->now_turn_player_id != env->agentSeats[index] && get_winner(gs) < 0 &&
+           env->steps[index] < env->config.maxChoices)
+    {
+        get_legal_choices(gs, &choices);
+        if (choices.SIZE == 0)
+            break;
+        int32_t choice = bot_choose(opponent, gs, &choices, &env->botRngs[index]);
+        if (!apply_choice(gs, choice))
+        {
+            ERROR_LOG("Bot %s made an illegal choice %d", opponent->name, choice);
+            break;
+        }
+        env->steps[index]++;
+    }
+}
+
+// 開始環境 index 的下一局
+static void start_episode(RlEnv *env, size_t index)
+{
+    const RlEnvConfig *config = &env->config;
+    uint64_t episode = env->episodes[index]++;
+    uint64_t stream = ((uint64_t)index << 32) | (episode & 0xFFFFFFFFu);
+    rng_seed(&env->gameRngs[index], env->seed, stream);
+    rng_seed(&env->botRngs[index], rng_mix64(env->seed), stream);
+
+    RngState *rng = &env->gameRngs[index];
+    uint8_t characters[2];
+    for (int seat = 0; seat < 2; seat++)
+    {
+        characters[seat] = config->characters[seat] == RL_RANDOM_CHARACTER
+                               ? (uint8_t)rng_bounded(rng, CHARACTER_COUNT)
+                               : config->characters[seat];
+    }
+    env->agentSeats[index] = config->agentSeat >= 0 ? config->agentSeat : (int8_t)rng_bounded(rng, 2);
+    env->steps[index] = 0;
+
+    init_duel(&env->games[index], characters[0], characters[1]);
+    play_opponent(env, index);
+}
+
+typedef struct {
+    RlEnv *env;
+    const int32_t *actions;  // NULL 表示重新開始
+    atomic_uint invalid;
+} RlBatch;
+
+static void step_env(void *ctx, size_t index)
+{
+    RlBatch *batch = ctx;
+    RlEnv *env = batch->env;
+    game *gs = &env->games[index];
+
+    RngState *previous = rng_get_active();
+    rng_set_active(&env->gameRngs[index]);
+
+    vector choices;
+    env->actions[index] = batch->actions != NULL ? batch->actions[index] : -1;
+    if (batch->actions == NULL)
+    {
+        env->episodes[index] = 0;
+        start_episode(env, index);
+        get_legal_choices(gs, &choices);
+        env->rewards[index] = 0.0f;
+        env->dones[index] = 0;
+        write_outputs(env, index, &choices);
+        rng_set_active(previous);
+        return;
+    }
+
+    get_legal_choices(gs, &choices);
+    int32_t choice = RL_ACTION_TO_CHOICE(batch->actions[index]);
+    if (choices.SIZE > 0 && findVector(&choices, choice) < 0)
+    {
+        atomic_fetch_add_explicit(&batch->invalid, 1, memory_order_relaxed);
+        choice = choices.array[0];
+    }
+
+    int8_t perspective = env->config.opponent != NULL ? env->agentSeats[index] : gs->now_turn_player_id;
+    if (choices.SIZE > 0)
+    {
+        apply_choice(gs, choice);
+        env->steps[index]++;
+        play_opponent(env, index);
+    }
+
+    int winner = get_winner(gs);
+    get_legal_choices(gs, &choices);
+    bool done = winner >= 0 || choices.SIZE == 0 || env->steps[index] >= env->config.maxChoices;
+    env->rewards[index] = winner < 0 ? 0.0f : winner == perspective ? 1.0f : -1.0f;
+    env->dones[index] = done;
+    if (done)
+    {
+        start_episode(env, index);
+        get_legal_choices(gs, &choices);
+    }
+    write_outputs(env, index, &choices);
+    rng_set_active(previous);
+}
+
+static uint32_t run_batch(RlEnv *env, const int32_t *actions)
+{
+    RlBatch batch;
+    batch.env = env;
+    batch.actions = actions;
+    atomic_init(&batch.invalid, 0);
+    sim_parallel_for(env->config.batchSize, env->config.threads, step_env, &batch);
+    return atomic_load(&batch.invalid);
+}
+
+void rl_env_reset(RlEnv *env, uint64_t seed)
+{
+    env->seed = seed;
+    run_batch(env, NULL);
+}
+
+uint32_t rl_env_step(RlEnv *env, const int32_t *actions)
+{
+    return run_batch(env, actions);
+}
@@ -0,0 +1,89 @@
+#ifndef _RL_ENV_H
+#define _RL_ENV_H
+
+#include "architecture.h"
+#include "bot.h"
+#include "game_features.h"
+#include "rng.h"
+
+// 強化學習用的批次環境：B 個獨立的對局，一次呼叫推進全部
+// 所有輸出都寫在 RlEnv 內連續的緩衝區（列優先 [B][...]），訓練端可直接包成張量，不需要逐步呼叫或輸出
+//
+// 動作：architecture.h 的選擇編碼加上 RL_CHOICE_OFFSET，範圍 [0, RL_ACTION_COUNT)
+// 超出 ±RL_CHOICE_OFFSET 的選擇（棄牌堆超過 64 張時的後段）不會出現在合法動作遮罩中
+// 回合結束後自動開始下一局：done 為 1 的那一格，observation 已經是新對局的第一個局面
+
+#define RL_CHOICE_OFFSET 64
+#define RL_ACTION_COUNT (2 * RL_CHOICE_OFFSET + 1)
+#define RL_CHOICE_TO_ACTION(choice) ((choice) + RL_CHOICE_OFFSET)
+#define RL_ACTION_TO_CHOICE(action) ((action) - RL_CHOICE_OFFSET)
+
+// 觀察值為以要行動的玩家為「自己」的局面特徵（game_features.h）
+#define RL_OBS_SIZE FEATURE_COUNT
+
+// 每局隨機挑選角色
+#define RL_RANDOM_CHARACTER 0xFF
+
+typedef struct {
+    uint32_t batchSize;
+    uint8_t characters[2];      // 角色編號，RL_RANDOM_CHARACTER 表示每局隨機
+    const BotPolicy* opponent;  // 對手策略；NULL 表示自我對戰（雙方都由呼叫端選擇）
+    int8_t agentSeat;           // 有對手時呼叫端的座位，-1 表示每局隨機
+    uint32_t maxChoices;        // 一局最多的選擇數，超過視為平手並結束
+    int threads;                // 推進批次使用的執行緒數，1 表示不開執行緒
+} RlEnvConfig;
+
+// 一步輸出的紀錄：所有輸出依序放在一塊連續記憶體（各段以 64 bytes 對齊）
+// 可以直接放進共享記憶體的環形緩衝區，由另一個行程原地讀取
+typedef struct {
+    size_t actions;       // int32_t[B]，產生這筆紀錄所套用的動作（reset 時為 -1）
+    size_t observations;  // float[B][RL_OBS_SIZE]
+    size_t legalMasks;    // uint8_t[B][RL_ACTION_COUNT]
+    size_t rewards;       // float[B]
+    size_t dones;         // uint8_t[B]
+    size_t toPlay;        // int8_t[B]
+    size_t size;          // 整筆紀錄的大小
+} RlRecordLayout;
+
+typedef struct {
+    RlEnvConfig config;
+    RlRecordLayout layout;
+    uint64_t seed;
+    game* games;
+    RngState* gameRngs;   // 洗牌
+    RngState* botRngs;    // 對手策略
+    uint64_t* episodes;   // 每個環境已開始的局數
+    uint32_t* steps;      // 目前這一局的選擇數
+    int8_t* agentSeats;   // 有對手時這一局呼叫端的座位
+
+    // 輸出緩衝區（指向目前綁定的紀錄）
+    void* record;
+    void* ownedRecord;    // rl_env_create 配置的紀錄
+    int32_t* actions;     // [B]
+    float* observations;  // [B][RL_OBS_SIZE]
+    uint8_t* legalMasks;  // [B][RL_ACTION_COUNT]，1 表示合法
+    float* rewards;       // [B]，做出動作的一方（有對手時為呼叫端）勝 +1 負 -1
+    uint8_t* dones;       // [B]
+    int8_t* toPlay;       // [B]，下一個要行動的玩家
+} RlEnv;
+
+// 預設：批次 64、隨機角色、自我對戰、最多 2000 個選擇、單執行緒
+void rl_env_init_config(RlEnvConfig* config);
+
+bool rl_env_create(RlEnv* env, const RlEnvConfig* config);
+void rl_env_destroy(RlEnv* env);
+
+// 計算批次大小為 batchSize 的紀錄配置
+void rl_env_record_layout(uint32_t batchSize, RlRecordLayout* layout);
+
+// 之後的輸出改寫到 record（大小為 env->layout.size、64 bytes 對齊），NULL 表示改回自己的緩衝區
+// 換到新的紀錄後，前一筆紀錄的內容仍然保留，呼叫端可從中讀取上一步的觀察值
+void rl_env_bind_record(RlEnv* env, void* record);
+
+// 以 seed 重新開始所有環境（環境 i 第 e 局的亂數只由 seed、i、e 決定）
+void rl_env_reset(RlEnv* env, uint64_t seed);
+
+// 每個環境套用一個動作，回傳不合法動作的數量（不合法的動作以第一個合法選擇代替）
+uint32_t rl_env_step(RlEnv* env, const int32_t* actions);
+
+#endif // _RL_ENV_H
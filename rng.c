@@ -0,0 +1,78 @@
+#include <stdlib.h>
+#include <time.h>
+#include "rng.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+// 每個執行緒各自的亂數來源，模擬執行緒之間互不干擾
+static _Thread_local RngState* active_rng = NULL;
+
+void rng_seed(RngState* rng, uint64_t seed, uint64_t stream)
+{
+    rng->state = 0;
+    rng->inc = (stream << 1u) | 1u;
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+uint32_t rng_next(RngState* rng)
+{
+    uint64_t old = rng->state;
+    rng->state = old * PCG_MULTIPLIER + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+uint32_t rng_bounded(RngState* rng, uint32_t bound)
+{
+    if (bound <= 1)
+        return 0;
+
+    // 拒絕取樣，避免取餘數造成的偏差
+    uint32_t threshold = (-bound) % bound;
+    for (;;)
+    {
+        uint32_t r = rng_next(rng);
+        if (r >= threshold)
+            return r % bound;
+    }
+}
+
+double rng_uniform(RngState* rng)
+{
+    return rng_next(rng) * (1.0 / 4294967296.0);
+}
+
+uint64_t rng_mix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+void rng_set_active(RngState* rng)
+{
+    active_rng = rng;
+}
+
+RngState* rng_get_active(void)
+{
+    return active_rng;
+}
+
+uint32_t rng_random_below(uint32_t bound)
+{
+    if (active_rng != NULL)
+        return rng_bounded(active_rng, bound);
+
+    static bool seeded = false;
+    if (!seeded)
+    {
+        srand((unsigned int)time(NULL));
+        seeded = true;
+    }
+    return bound <= 1 ? 0 : (uint32_t)rand() % bound;
+}
@@ -0,0 +1,37 @@
+#ifndef _RNG_H
+#define _RNG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// PCG32 亂數產生器
+// 狀態只有兩個 64 位元整數，可以直接保存到檔案並在之後原樣恢復
+typedef struct {
+    uint64_t state;
+    uint64_t inc;
+} RngState;
+
+// 以種子與串流編號初始化（不同串流互不相關）
+void rng_seed(RngState* rng, uint64_t seed, uint64_t stream);
+
+// 取得下一個 32 位元亂數
+uint32_t rng_next(RngState* rng);
+
+// 取得 [0, bound) 的均勻亂數
+uint32_t rng_bounded(RngState* rng, uint32_t bound);
+
+// 取得 [0, 1) 的浮點亂數
+double rng_uniform(RngState* rng);
+
+// splitmix64 混合函數，用來從主種子衍生子種子
+uint64_t rng_mix64(uint64_t x);
+
+// 目前執行緒的亂數來源（洗牌等引擎內部隨機行為使用）
+// 設為 NULL 時退回標準庫 rand()
+void rng_set_active(RngState* rng);
+RngState* rng_get_active(void);
+
+// 從目前執行緒的亂數來源取得 [0, bound) 的亂數
+uint32_t rng_random_below(uint32_t bound);
+
+#endif // _RNG_H
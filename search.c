@@ -0,0 +1,467 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stddef.h>
+#include <time.h>
+#include <unistd.h>
+#include "search.h"
+#include "card_system.h"
+#include "debug_log.h"
+#include "draw_odds.h"
+#include "game_action.h"
+#include "game_hash.h"
+#include "game_state.h"
+
+#define SEARCH_MAX_PLY 64
+#define SEARCH_INFINITY (SEARCH_WIN_SCORE + 1000)
+
+// 走法排序表以 (狀態, 選擇) 為鍵
+#define HISTORY_STATUS_SLOTS 64
+#define HISTORY_CHOICE_SLOTS 512
+#define HISTORY_SIZE (HISTORY_STATUS_SLOTS * HISTORY_CHOICE_SLOTS)
+
+// 每隔多少節點檢查一次時間
+#define SEARCH_TIME_CHECK_NODES 256
+
+typedef struct {
+    const SearchConfig *config;
+    int8_t root;                  // 搜尋方的玩家編號
+    RngState rng;                 // 機會節點的洗牌亂數
+    uint64_t nodes;
+    struct timespec start;
+    bool aborted;
+    int32_t killers[SEARCH_MAX_PLY][2];
+    int32_t history[HISTORY_SIZE];
+} Searcher;
+
+void init_eval_weights(EvalWeights *weights)
+{
+    weights->life = 100;
+    weights->defense = 30;
+    weights->energy = 5;
+    weights->handValue = 8;
+    weights->deckValue = 3;
+    weights->inRange = 40;
+    weights->drawOdds = 0;
+}
+
+static const struct {
+    const char *name;
+    size_t offset;
+} evalWeightFields[EVAL_WEIGHT_COUNT] = {
+    {"life", offsetof(EvalWeights, life)},
+    {"defense", offsetof(EvalWeights, defense)},
+    {"energy", offsetof(EvalWeights, energy)},
+    {"hand_value", offsetof(EvalWeights, handValue)},
+    {"deck_value", offsetof(EvalWeights, deckValue)},
+    {"in_range", offsetof(EvalWeights, inRange)},
+    {"draw_odds", offsetof(EvalWeights, drawOdds)},
+};
+
+const char *eval_weight_name(int index)
+{
+    return evalWeightFields[index].name;
+}
+
+int32_t *eval_weight_at(EvalWeights *weights, int index)
+{
+    return (int32_t *)((uint8_t *)weights + evalWeightFields[index].offset);
+}
+
+bool load_eval_weights(const char *path, EvalWeights *weights)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        ERROR_LOG("Cannot open weights file %s", path);
+        return false;
+    }
+
+    init_eval_weights(weights);
+    char line[256];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), fp) != NULL)
+    {
+        lineNumber++;
+        char name[64];
+        long value;
+        if (line[0] == '#' || sscanf(line, " %63s", name) != 1)
+            continue;
+
+        ok = sscanf(line, " %63s %ld", name, &value) == 2 && value >= INT32_MIN && value <= INT32_MAX;
+        int index = 0;
+        while (ok && index < EVAL_WEIGHT_COUNT && strcmp(name, eval_weight_name(index)) != 0)
+            index++;
+        ok = ok && index < EVAL_WEIGHT_COUNT;
+        if (ok)
+            *eval_weight_at(weights, index) = (int32_t)value;
+        else
+            ERROR_LOG("Invalid weight at %s:%d", path, lineNumber);
+    }
+    fclose(fp);
+    return ok;
+}
+
+bool save_eval_weights(const char *path, const EvalWeights *weights)
+{
+    char tmpPath[1024];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE *fp = fopen(tmpPath, "w");
+    if (fp == NULL)
+    {
+        ERROR_LOG("Cannot open weights file %s", tmpPath);
+        return false;
+    }
+
+    EvalWeights copy = *weights;
+    bool ok = fprintf(fp, "# evaluate_game weights\n") > 0;
+    for (int i = 0; ok && i < EVAL_WEIGHT_COUNT; i++)
+        ok = fprintf(fp, "%s %d\n", eval_weight_name(i), *eval_weight_at(&copy, i)) > 0;
+    ok = ok && fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmpPath, path) != 0)
+    {
+        ERROR_LOG("Cannot write weights file %s", path);
+        remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+void init_search_config(SearchConfig *config)
+{
+    config->maxDepth = 3;
+    config->timeLimitMs = 0;
+    config->nodeLimit = 4000;
+    config->chanceSamples = 2;
+    config->eval = evaluate_game;
+    config->evalCtx = NULL;
+    config->table = NULL;
+    config->stop = NULL;
+}
+
+static int32_t vector_value(vector *cards)
+{
+    int32_t total = 0;
+    for (uint32_t i = 0; i < cards->SIZE; i++)
+        total += get_card_value(cards->array[i]);
+    return total;
+}
+
+static int32_t player_score(const EvalWeights *w, game *gs, int8_t id)
+{
+    player *p = &gs->players[id];
+    int32_t handValue = vector_value(&p->hand);
+    int32_t deckValue = handValue + vector_value(&p->deck) + vector_value(&p->graveyard) + vector_value(&p->usecards);
+    int32_t score = w->life * p->life + w->defense * p->defense + w->energy * p->energy +
+                    w->handValue * handValue + w->deckValue * deckValue;
+
+    if (gs->now_turn_player_id == id && check_attack_range(gs, id, (id + 1) % 2))
+        score += w->inRange;
+    if (w->drawOdds != 0)
+    {
+        PileComposition piles;
+        DrawOdds odds;
+        count_draw_piles(p, true, &piles);
+        get_draw_odds(&piles, DRAW_REFILL_CARDS, &odds);
+        score += w->drawOdds * (int32_t)(odds.atLeast[DRAW_ATTACK][1] * 100.0 + 0.5);
+    }
+    return score;
+}
+
+int32_t evaluate_game(void *ctx, game *gs, int8_t playerId)
+{
+    EvalWeights defaults;
+    const EvalWeights *weights = ctx;
+    if (weights == NULL)
+    {
+        init_eval_weights(&defaults);
+        weights = &defaults;
+    }
+    return player_score(weights, gs, playerId) - player_score(weights, gs, (int8_t)((playerId + 1) % 2));
+}
+
+static uint64_t elapsed_ms(const Searcher *s)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - s->start.tv_sec) * 1000 + (uint64_t)((now.tv_nsec - s->start.tv_nsec) / 1000000);
+}
+
+static bool out_of_budget(Searcher *s)
+{
+    const SearchConfig *config = s->config;
+    if (config->nodeLimit > 0 && s->nodes >= config->nodeLimit)
+        return true;
+    if (config->stop != NULL && atomic_load_explicit(config->stop, memory_order_relaxed))
+        return true;
+    if (config->timeLimitMs > 0 && s->nodes % SEARCH_TIME_CHECK_NODES == 0 && elapsed_ms(s) >= config->timeLimitMs)
+        return true;
+    return false;
+}
+
+static int32_t history_key(game *gs, int32_t choice)
+{
+    int32_t slot = choice + HISTORY_CHOICE_SLOTS / 2;
+    if (slot < 0)
+        slot = 0;
+    if (slot >= HISTORY_CHOICE_SLOTS)
+        slot = HISTORY_CHOICE_SLOTS - 1;
+    return ((int32_t)gs->status % HISTORY_STATUS_SLOTS) * HISTORY_CHOICE_SLOTS + slot;
+}
+
+// 排序：上一輪的最佳選擇、killer、history 分數
+static void order_choices(Searcher *s, game *gs, vector *choices, int ply, int32_t pvChoice)
+{
+    int64_t scores[sizeof(choices->array) / sizeof(choices->array[0])];
+    for (uint32_t i = 0; i < choices->SIZE; i++)
+    {
+        int32_t key = history_key(gs, choices->array[i]);
+        if (choices->array[i] == pvChoice)
+            scores[i] = INT64_MAX;
+        else if (ply < SEARCH_MAX_PLY && key == s->killers[ply][0])
+            scores[i] = INT64_MAX - 1;
+        else if (ply < SEARCH_MAX_PLY && key == s->killers[ply][1])
+            scores[i] = INT64_MAX - 2;
+        else
+            scores[i] = s->history[key];
+    }
+
+    // 選擇數很少，插入排序即可（穩定，保持原本順序）
+    for (uint32_t i = 1; i < choices->SIZE; i++)
+    {
+        int32_t choice = choices->array[i];
+        int64_t score = scores[i];
+        uint32_t j = i;
+        while (j > 0 && scores[j - 1] < score)
+        {
+            choices->array[j] = choices->array[j - 1];
+            scores[j] = scores[j - 1];
+            j--;
+        }
+        choices->array[j] = choice;
+        scores[j] = score;
+    }
+}
+
+static void record_cutoff(Searcher *s, game *gs, int32_t choice, int ply, int depth)
+{
+    int32_t key = history_key(gs, choice);
+    s->history[key] += depth * depth;
+    if (ply < SEARCH_MAX_PLY && s->killers[ply][0] != key)
+    {
+        s->killers[ply][1] = s->killers[ply][0];
+        s->killers[ply][0] = key;
+    }
+}
+
+// 置換表以玩家 0 的角度保存分數，勝負分數改成相對於該節點的距離，
+// 不同搜尋方、不同深度的搜尋才能共用
+static bool is_win_score(int32_t value)
+{
+    return value > SEARCH_WIN_SCORE - SEARCH_MAX_PLY || value < -SEARCH_WIN_SCORE + SEARCH_MAX_PLY;
+}
+
+static TTBound flip_bound(TTBound bound)
+{
+    if (bound == TT_BOUND_LOWER)
+        return TT_BOUND_UPPER;
+    if (bound == TT_BOUND_UPPER)
+        return TT_BOUND_LOWER;
+    return bound;
+}
+
+static void store_entry(Searcher *s, uint64_t hash, int32_t value, int depth, int ply, TTBound bound,
+                        int32_t bestChoice)
+{
+    if (is_win_score(value))
+        value += value > 0 ? ply : -ply;
+    if (s->root != 0)
+    {
+        value = -value;
+        bound = flip_bound(bound);
+    }
+    tt_store(s->config->table, hash, value, depth, bound, bestChoice);
+}
+
+static void load_entry(Searcher *s, TTEntryInfo *info, int ply)
+{
+    if (s->root != 0)
+    {
+        info->value = -info->value;
+        info->bound = flip_bound(info->bound);
+    }
+    if (is_win_score(info->value))
+        info->value -= info->value > 0 ? ply : -ply;
+}
+
+static bool ends_turn(game *gs, int32_t choice)
+{
+    return (gs->status == CHOOSE_MOVE && choice == 10) || gs->status == REMOVE_HG;
+}
+
+static int32_t search_node(Searcher *s, game *gs, int depth, int ply, int32_t alpha, int32_t beta);
+
+static int32_t child_value(Searcher *s, game *gs, int32_t choice, int depth, int ply, int32_t alpha, int32_t beta)
+{
+    game child;
+
+    if (!ends_turn(gs, choice))
+    {
+        clone_game(&child, gs);
+        apply_choice(&child, choice);
+        return search_node(s, &child, depth, ply, alpha, beta);
+    }
+
+    // 機會節點：回合結束後抽到的牌未知，對雙方牌堆重新洗牌後取平均
+    int samples = s->config->chanceSamples > 0 ? s->config->chanceSamples : 1;
+    int64_t total = 0;
+    for (int i = 0; i < samples && !s->aborted; i++)
+    {
+        clone_game(&child, gs);
+        shuffle_deck(&child.players[0].deck);
+        shuffle_deck(&child.players[1].deck);
+        apply_choice(&child, choice);
+        total += search_node(s, &child, depth, ply, -SEARCH_INFINITY, SEARCH_INFINITY);
+    }
+    return (int32_t)(total / samples);
+}
+
+static int32_t search_node(Searcher *s, game *gs, int depth, int ply, int32_t alpha, int32_t beta)
+{
+    s->nodes++;
+    if (out_of_budget(s))
+    {
+        s->aborted = true;
+        return 0;
+    }
+
+    int winner = get_winner(gs);
+    if (winner >= 0)
+        return winner == s->root ? SEARCH_WIN_SCORE - ply : -SEARCH_WIN_SCORE + ply;
+    if (depth <= 0)
+        return s->config->eval(s->config->evalCtx, gs, s->root);
+
+    uint64_t hash = 0;
+    int32_t tableChoice = INT32_MIN;
+    int32_t alphaOrig = alpha;
+    int32_t betaOrig = beta;
+    if (s->config->table != NULL)
+    {
+        TTEntryInfo info;
+        hash = hash_game(gs);
+        if (tt_probe(s->config->table, hash, &info))
+        {
+            load_entry(s, &info, ply);
+            // 手牌順序不同的等價局面共用同一筆資料，最佳選擇只拿來排序
+            tableChoice = info.bestChoice;
+            if (info.depth >= depth)
+            {
+                if (info.bound == TT_BOUND_EXACT ||
+                    (info.bound == TT_BOUND_LOWER && info.value >= beta) ||
+                    (info.bound == TT_BOUND_UPPER && info.value <= alpha))
+                    return info.value;
+            }
+        }
+    }
+
+    vector choices;
+    get_legal_choices(gs, &choices);
+    if (choices.SIZE == 0)
+        return s->config->eval(s->config->evalCtx, gs, s->root);
+    order_choices(s, gs, &choices, ply, tableChoice);
+
+    bool maximizing = gs->now_turn_player_id == s->root;
+    int32_t best = maximizing ? -SEARCH_INFINITY : SEARCH_INFINITY;
+    int32_t bestChoice = choices.array[0];
+    for (uint32_t i = 0; i < choices.SIZE; i++)
+    {
+        int32_t value = child_value(s, gs, choices.array[i], depth - 1, ply + 1, alpha, beta);
+        if (s->aborted)
+            return 0;
+
+        if (maximizing ? value > best : value < best)
+        {
+            best = value;
+            bestChoice = choices.array[i];
+        }
+        if (maximizing && best > alpha)
+            alpha = best;
+        if (!maximizing && best < beta)
+            beta = best;
+        if (alpha >= beta)
+        {
+            record_cutoff(s, gs, choices.array[i], ply, depth);
+            break;
+        }
+    }
+
+    if (s->config->table != NULL)
+    {
+        TTBound bound = best <= alphaOrig ? TT_BOUND_UPPER : best >= betaOrig ? TT_BOUND_LOWER : TT_BOUND_EXACT;
+        store_entry(s, hash, best, depth, ply, bound, bestChoice);
+    }
+    return best;
+}
+
+int32_t search_choose(const SearchConfig *config, game *gs, vector *choices, RngState *rng, SearchResult *result)
+{
+    result->bestChoice = choices->SIZE > 0 ? choices->array[0] : 0;
+    result->score = 0;
+    result->depth = 0;
+    result->nodes = 0;
+    if (choices->SIZE <= 1)
+        return result->bestChoice;
+
+    Searcher *s = calloc(1, sizeof(Searcher));
+    if (s == NULL)
+        return result->bestChoice;
+    s->config = config;
+    s->root = gs->now_turn_player_id;
+    uint64_t seed = rng_next(rng);
+    seed = (seed << 32) | rng_next(rng);
+    rng_seed(&s->rng, seed, 0);
+    clock_gettime(CLOCK_MONOTONIC, &s->start);
+    if (config->table != NULL)
+        tt_new_search(config->table);
+    for (int i = 0; i < SEARCH_MAX_PLY; i++)
+        s->killers[i][0] = s->killers[i][1] = -1;
+
+    // 搜尋中的洗牌不能用到對局本身的亂數串流
+    RngState *previous = rng_get_active();
+    rng_set_active(&s->rng);
+
+    vector rootChoices = *choices;
+    for (int depth = 1; depth <= config->maxDepth; depth++)
+    {
+        order_choices(s, gs, &rootChoices, 0, result->bestChoice);
+
+        int32_t alpha = -SEARCH_INFINITY;
+        int32_t bestChoice = rootChoices.array[0];
+        for (uint32_t i = 0; i < rootChoices.SIZE; i++)
+        {
+            int32_t value = child_value(s, gs, rootChoices.array[i], depth - 1, 1, alpha, SEARCH_INFINITY);
+            if (s->aborted)
+                break;
+            if (value > alpha)
+            {
+                alpha = value;
+                bestChoice = rootChoices.array[i];
+            }
+        }
+
+        // 中斷的那一輪結果不完整，沿用上一輪
+        if (s->aborted)
+            break;
+        result->bestChoice = bestChoice;
+        result->score = alpha;
+        result->depth = depth;
+        if (alpha >= SEARCH_WIN_SCORE - SEARCH_MAX_PLY)
+            break;
+    }
+    result->nodes = s->nodes;
+
+    rng_set_active(previous);
+    free(s);
+    return result->bestChoice;
+}
@@ -0,0 +1,69 @@
+#ifndef _SEARCH_H
+#define _SEARCH_H
+
+#include "architecture.h"
+#include "rng.h"
+#include "transposition.h"
+
+// 勝負分數，比任何評估值都大；越早分出勝負分數越極端
+#define SEARCH_WIN_SCORE 1000000
+
+// 局面評估：回傳以 playerId 角度的分數（越大越好），不得修改 gameState
+typedef int32_t (*SearchEvalFn)(void* ctx, game* gameState, int8_t playerId);
+
+// 預設評估函數的權重（雙方差值）
+typedef struct EvalWeights {
+    int32_t life;       // 每點生命
+    int32_t defense;    // 每點防禦
+    int32_t energy;     // 每點能量
+    int32_t handValue;  // 手牌數值總和
+    int32_t deckValue;  // 擁有的所有卡牌數值總和（牌堆、手牌、棄牌堆、出牌區）
+    int32_t inRange;    // 輪到自己且對手在攻擊範圍內
+    int32_t drawOdds;   // 下次補牌至少抽到一張基本攻擊牌的機率（百分比），預設 0 不計算
+} EvalWeights;
+
+// 以編號存取各項權重（調整工具與權重檔使用）
+#define EVAL_WEIGHT_COUNT 7
+
+typedef struct {
+    int maxDepth;           // 最大搜尋深度（以選擇數計）
+    uint32_t timeLimitMs;   // 0 表示不限時間
+    uint64_t nodeLimit;     // 0 表示不限節點數；只用節點限制時結果完全可重現
+    int chanceSamples;      // 每個機會節點（回合結束抽牌）抽樣的洗牌次數
+    SearchEvalFn eval;
+    void* evalCtx;
+    // 置換表（NULL 表示不使用），可由多個執行緒的搜尋共用
+    // 共用時評估函數必須相同且為零和（evaluate(p) == -evaluate(對手)）；
+    // 多執行緒共用會讓結果依執行順序而不同
+    TranspositionTable* table;
+    // 外部中斷旗標（NULL 表示不使用），設為 true 後搜尋盡快結束並回傳最後完成那一輪的結果
+    const atomic_bool* stop;
+} SearchConfig;
+
+typedef struct {
+    int32_t bestChoice;
+    int32_t score;     // 以搜尋方角度的分數
+    int depth;         // 最後完成的深度
+    uint64_t nodes;
+} SearchResult;
+
+// 預設設定：深度 3、4000 節點、每個機會節點 2 次抽樣、預設評估函數、不使用置換表與中斷旗標
+void init_search_config(SearchConfig* config);
+void init_eval_weights(EvalWeights* weights);
+const char* eval_weight_name(int index);
+int32_t* eval_weight_at(EvalWeights* weights, int index);
+
+// 權重檔：每行「名稱 數值」，# 開頭為註解；沒有列出的項目使用預設值
+bool load_eval_weights(const char* path, EvalWeights* weights);
+bool save_eval_weights(const char* path, const EvalWeights* weights);
+
+// 預設評估函數，ctx 為 EvalWeights*（NULL 時使用預設權重）
+int32_t evaluate_game(void* ctx, game* gameState, int8_t playerId);
+
+// 迭代加深的 expectimax / alpha-beta 搜尋
+// 只在 choices 中挑選（通常由 get_legal_choices 產生）；機會節點的洗牌使用由 rng 衍生的亂數，
+// 搜尋過程不會改變 gameState 以及目前執行緒的亂數來源
+int32_t search_choose(const SearchConfig* config, game* gameState, vector* choices, RngState* rng,
+                      SearchResult* result);
+
+#endif // _SEARCH_H
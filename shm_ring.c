@@ -0,0 +1,197 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "shm_ring.h"
+#include "debug_log.h"
+
+// 跨行程只能使用不依賴行程內鎖的原子操作
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared ring needs lock-free 64-bit atomics");
+
+static bool map_ring(ShmRing *ring, size_t size, bool create)
+{
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, 0);
+    if (map == MAP_FAILED)
+    {
+        ERROR_LOG("Cannot mmap shared ring %s", ring->name);
+        return false;
+    }
+    ring->header = map;
+    ring->slots = (uint8_t *)map + sizeof(ShmRingHeader);
+    ring->mapSize = size;
+    if (create)
+        memset(map, 0, sizeof(ShmRingHeader));
+    return true;
+}
+
+bool shm_ring_create(ShmRing *ring, const char *name, uint32_t slotCount, size_t slotSize)
+{
+    memset(ring, 0, sizeof(ShmRing));
+    ring->fd = -1;
+    uint32_t slots = 2;
+    while (slots < slotCount)
+        slots *= 2;
+    slotSize = (slotSize + SHM_RING_ALIGN - 1) / SHM_RING_ALIGN * SHM_RING_ALIGN;
+    size_t size = sizeof(ShmRingHeader) + (size_t)slots * slotSize;
+
+    if (name != NULL)
+    {
+        snprintf(ring->name, sizeof(ring->name), "%s", name);
+        ring->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    else
+        ring->fd = memfd_create("twisted_ring", MFD_CLOEXEC);
+    if (ring->fd < 0)
+    {
+        ERROR_LOG("Cannot create shared ring %s", name != NULL ? name : "(memfd)");
+        return false;
+    }
+    ring->owner = true;
+    if (ftruncate(ring->fd, (off_t)size) != 0 || !map_ring(ring, size, true))
+    {
+        ERROR_LOG("Cannot size shared ring to %zu bytes", size);
+        shm_ring_close(ring);
+        return false;
+    }
+
+    ShmRingHeader *header = ring->header;
+    header->magic = SHM_RING_MAGIC;
+    header->version = SHM_RING_VERSION;
+    header->slotCount = slots;
+    header->slotSize = slotSize;
+    atomic_init(&header->finished, 0);
+    atomic_init(&header->head, 0);
+    atomic_init(&header->tail, 0);
+    return true;
+}
+
+bool shm_ring_open(ShmRing *ring, const char *name)
+{
+    memset(ring, 0, sizeof(ShmRing));
+    snprintf(ring->name, sizeof(ring->name), "%s", name);
+    ring->fd = shm_open(name, O_RDWR, 0600);
+    if (ring->fd < 0)
+    {
+        ERROR_LOG("Cannot open shared ring %s", name);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(ring->fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmRingHeader) ||
+        !map_ring(ring, (size_t)st.st_size, false))
+    {
+        shm_ring_close(ring);
+        return false;
+    }
+
+    const ShmRingHeader *header = ring->header;
+    uint32_t slots = header->slotCount;
+    bool valid = header->magic == SHM_RING_MAGIC && header->version == SHM_RING_VERSION && slots > 0 &&
+                 (slots & (slots - 1)) == 0 && header->slotSize % SHM_RING_ALIGN == 0 &&
+                 sizeof(ShmRingHeader) + (size_t)slots * header->slotSize == ring->mapSize;
+    if (!valid)
+    {
+        ERROR_LOG("Invalid shared ring %s", name);
+        shm_ring_close(ring);
+        return false;
+    }
+    ring->cachedHead = atomic_load(&ring->header->head);
+    ring->cachedTail = atomic_load(&ring->header->tail);
+    return true;
+}
+
+void shm_ring_close(ShmRing *ring)
+{
+    if (ring->header != NULL)
+        munmap(ring->header, ring->mapSize);
+    if (ring->fd >= 0)
+        close(ring->fd);
+    if (ring->owner && ring->name[0] != '\0')
+        shm_unlink(ring->name);
+    memset(ring, 0, sizeof(ShmRing));
+    ring->fd = -1;
+}
+
+static uint8_t *slot_at(ShmRing *ring, uint64_t index)
+{
+    ShmRingHeader *header = ring->header;
+    return ring->slots + (index & (header->slotCount - 1)) * header->slotSize;
+}
+
+// 生產者只寫 head，消費者只寫 tail；acquire/release 保證格子內容在索引更新前後可見
+void *shm_ring_reserve(ShmRing *ring)
+{
+    ShmRingHeader *header = ring->header;
+    uint64_t head = atomic_load_explicit(&header->head, memory_order_relaxed);
+    if (head - ring->cachedTail >= header->slotCount)
+    {
+        ring->cachedTail = atomic_load_explicit(&header->tail, memory_order_acquire);
+        if (head - ring->cachedTail >= header->slotCount)
+            return NULL;
+    }
+    return slot_at(ring, head);
+}
+
+void shm_ring_commit(ShmRing *ring)
+{
+    ShmRingHeader *header = ring->header;
+    uint64_t head = atomic_load_explicit(&header->head, memory_order_relaxed);
+    atomic_store_explicit(&header->head, head + 1, memory_order_release);
+}
+
+void shm_ring_finish(ShmRing *ring)
+{
+    atomic_store_explicit(&ring->header->finished, 1, memory_order_release);
+}
+
+const void *shm_ring_peek(ShmRing *ring)
+{
+    ShmRingHeader *header = ring->header;
+    uint64_t tail = atomic_load_explicit(&header->tail, memory_order_relaxed);
+    if (tail == ring->cachedHead)
+    {
+        ring->cachedHead = atomic_load_explicit(&header->head, memory_order_acquire);
+        if (tail == ring->cachedHead)
+            return NULL;
+    }
+    return slot_at(ring, tail);
+}
+
+void shm_ring_release(ShmRing *ring)
+{
+    ShmRingHeader *header = ring->header;
+    uint64_t tail = atomic_load_explicit(&header->tail, memory_order_relaxed);
+    atomic_store_explicit(&header->tail, tail + 1, memory_order_release);
+}
+
+bool shm_ring_drained(ShmRing *ring)
+{
+    ShmRingHeader *header = ring->header;
+    // 先確認結束再讀 head，結束前提交的格子一定看得到
+    if (!atomic_load_explicit(&header->finished, memory_order_acquire))
+        return false;
+    return atomic_load_explicit(&header->tail, memory_order_relaxed) ==
+           atomic_load_explicit(&header->head, memory_order_acquire);
+}
+
+void *shm_ring_reserve_wait(ShmRing *ring)
+{
+    void *slot;
+    while ((slot = shm_ring_reserve(ring)) == NULL)
+        sched_yield();
+    return slot;
+}
+
+const void *shm_ring_peek_wait(ShmRing *ring)
+{
+    const void *slot;
+    while ((slot = shm_ring_peek(ring)) == NULL)
+    {
+        if (shm_ring_drained(ring))
+            return NULL;
+        sched_yield();
+    }
+    return slot;
+}
@@ -0,0 +1,62 @@
+#ifndef _SHM_RING_H
+#define _SHM_RING_H
+
+#include <stdatomic.h>
+#include "architecture.h"
+
+// 跨行程的共享記憶體環形緩衝區（單一生產者、單一消費者，無鎖）
+// 固定數量、固定大小的格子：生產者在格子內原地寫好後提交，消費者原地讀完後釋放，資料不經過複製
+// 名稱以 '/' 開頭時使用 shm_open（其他行程以名稱開啟）；名稱為 NULL 時使用 memfd_create，
+// 只能經由 fork 繼承或傳遞檔案描述子共用
+// 多個模擬行程時每個生產者各用一個環形緩衝區
+
+#define SHM_RING_MAGIC 0x474E495246524D54ULL  // "TMRFRING"
+#define SHM_RING_VERSION 1
+#define SHM_RING_ALIGN 64
+
+typedef struct {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slotCount;  // 2 的次方
+    uint64_t slotSize;   // SHM_RING_ALIGN 的倍數
+    _Atomic uint32_t finished;  // 生產者不會再提交
+    uint8_t pad0[SHM_RING_ALIGN - 28];
+    _Atomic uint64_t head;  // 已提交的格子數（生產者寫入）
+    uint8_t pad1[SHM_RING_ALIGN - 8];
+    _Atomic uint64_t tail;  // 已釋放的格子數（消費者寫入）
+    uint8_t pad2[SHM_RING_ALIGN - 8];
+} ShmRingHeader;
+
+typedef struct {
+    ShmRingHeader* header;
+    uint8_t* slots;
+    size_t mapSize;
+    int fd;
+    char name[64];       // 建立者關閉時 shm_unlink（memfd 時為空字串）
+    bool owner;
+    uint64_t cachedHead; // 本行程看到的對方進度，減少讀取共用的 cache line
+    uint64_t cachedTail;
+} ShmRing;
+
+// 建立（slotCount 會補到 2 的次方、slotSize 補到 SHM_RING_ALIGN 的倍數）
+bool shm_ring_create(ShmRing* ring, const char* name, uint32_t slotCount, size_t slotSize);
+// 以名稱開啟已建立的緩衝區
+bool shm_ring_open(ShmRing* ring, const char* name);
+void shm_ring_close(ShmRing* ring);
+
+// 生產者：取得下一個可寫的格子（滿了回傳 NULL）、寫完後提交、全部寫完後標記結束
+void* shm_ring_reserve(ShmRing* ring);
+void shm_ring_commit(ShmRing* ring);
+void shm_ring_finish(ShmRing* ring);
+
+// 消費者：取得最舊的已提交格子（空的回傳 NULL）、讀完後釋放
+const void* shm_ring_peek(ShmRing* ring);
+void shm_ring_release(ShmRing* ring);
+// 生產者已結束且所有格子都已讀完
+bool shm_ring_drained(ShmRing* ring);
+
+// 等待版本：沒有空間或資料時讓出 CPU 再試；shm_ring_peek_wait 在緩衝區讀完時回傳 NULL
+void* shm_ring_reserve_wait(ShmRing* ring);
+const void* shm_ring_peek_wait(ShmRing* ring);
+
+#endif // _SHM_RING_H
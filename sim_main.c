@@ -0,0 +1,1615 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "simulation.h"
+#include "character_system.h"
+#include "matchup.h"
+#include "card_impact.h"
+#include "tournament.h"
+#include "opening_book.h"
+#include "ponder.h"
+#include "game_action.h"
+#include "game_init.h"
+#include "rl_env.h"
+#include "shm_ring.h"
+#include "dataset.h"
+#include "nn_eval.h"
+#include "eval_tuner.h"
+#include "plugin_loader.h"
+#include "engine_protocol.h"
+#include "game_codec.h"
+#include "perft.h"
+#include "purchase_advisor.h"
+#include "draw_odds.h"
+#include "combo_solver.h"
+#include "action_preview.h"
+#include "card_db.h"
+
+// 模擬工具的子命令
+typedef struct {
+    const char *name;
+    int (*run)(int argc, char **argv);
+    const char *usage;
+} SimCommand;
+
+static bool parse_character(const char *text, uint8_t *charId)
+{
+    int value = atoi(text);
+    if (value < 1 || value > 10)
+    {
+        fprintf(stderr, "Invalid character %s (1-10)\n", text);
+        return false;
+    }
+    *charId = (uint8_t)(value - 1);
+    return true;
+}
+
+static bool parse_bot(const char *text, const BotPolicy **bot)
+{
+    *bot = find_bot_policy(text);
+    if (*bot == NULL)
+    {
+        fprintf(stderr, "Unknown bot policy %s\n", text);
+        return false;
+    }
+    return true;
+}
+
+static void print_bot_policies(void)
+{
+    fprintf(stderr, "Bot policies:\n");
+    for (int i = 0; i < get_bot_policy_count(); i++)
+    {
+        const BotPolicy *bot = get_bot_policy(i);
+        fprintf(stderr, "  %-10s %s\n", bot->name, bot->description);
+    }
+}
+
+// --plugin 與 --card-db 的指紋（checkpoint 比對用），見 load_plugin_options
+static uint64_t globalOptionFingerprint;
+
+// 以選項名稱、值與檔案內容更新設定指紋
+static void fingerprint_option(uint64_t *h, const char *option, const char *path)
+{
+    *h = sim_fingerprint_bytes(*h, option, strlen(option));
+    *h = sim_fingerprint_bytes(*h, path, strlen(path));
+    if (!sim_fingerprint_file(h, path))
+        *h = rng_mix64(*h ^ 1);
+}
+
+static OpeningBook openingBook;
+
+// 搜尋類策略使用的開局庫（--book）
+static bool open_book(const char *path)
+{
+    if (!book_open(&openingBook, path))
+    {
+        fprintf(stderr, "Cannot load opening book %s\n", path);
+        return false;
+    }
+    set_bot_opening_book(&openingBook);
+    return true;
+}
+
+static void close_book(void)
+{
+    set_bot_opening_book(NULL);
+    book_close(&openingBook);
+}
+
+static NnModel nnModel;
+
+// search-nn 策略使用的神經網路（--nn）
+static bool open_nn(const char *path)
+{
+    if (!nn_model_load(&nnModel, path))
+    {
+        fprintf(stderr, "Cannot load network %s\n", path);
+        return false;
+    }
+    set_bot_nn_model(&nnModel);
+    return true;
+}
+
+static void close_nn(void)
+{
+    set_bot_nn_model(NULL);
+    nn_model_free(&nnModel);
+}
+
+static EvalWeights evalWeights;
+
+// 搜尋類策略使用的評估權重（--weights，tune 的輸出）
+static bool open_weights(const char *path)
+{
+    if (!load_eval_weights(path, &evalWeights))
+    {
+        fprintf(stderr, "Cannot load weights %s\n", path);
+        return false;
+    }
+    set_bot_eval_weights(&evalWeights);
+    return true;
+}
+
+static int cmd_run(int argc, char **argv)
+{
+    SimConfig config;
+    sim_init_config(&config);
+    uint64_t games = 1000;
+    uint64_t first = 0;
+    const char *checkpointPath = NULL;
+    uint64_t checkpointEvery = 1000;
+    int threads = 0;
+    uint64_t fingerprint = globalOptionFingerprint;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--games") == 0 && hasValue)
+            games = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--first") == 0 && hasValue)
+            first = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            config.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--max-turns") == 0 && hasValue)
+            config.maxTurns = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--chars") == 0 && i + 2 < argc)
+        {
+            if (!parse_character(argv[i + 1], &config.characters[0]) ||
+                !parse_character(argv[i + 2], &config.characters[1]))
+                return 1;
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--bots") == 0 && i + 2 < argc)
+        {
+            if (!parse_bot(argv[i + 1], &config.bots[0]) || !parse_bot(argv[i + 2], &config.bots[1]))
+                return 1;
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--checkpoint") == 0 && hasValue)
+            checkpointPath = argv[++i];
+        else if (strcmp(argv[i], "--checkpoint-every") == 0 && hasValue)
+            checkpointEvery = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--book") == 0 && hasValue)
+        {
+            if (!open_book(argv[++i]))
+                return 1;
+            fingerprint_option(&fingerprint, argv[i - 1], argv[i]);
+        }
+        else if (strcmp(argv[i], "--nn") == 0 && hasValue)
+        {
+            if (!open_nn(argv[++i]))
+                return 1;
+            fingerprint_option(&fingerprint, argv[i - 1], argv[i]);
+        }
+        else if (strcmp(argv[i], "--weights") == 0 && hasValue)
+        {
+            if (!open_weights(argv[++i]))
+                return 1;
+            fingerprint_option(&fingerprint, argv[i - 1], argv[i]);
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // checkpoint 只能由相同設定接續：選項、載入的檔案、目前的卡牌數值與內建策略的搜尋設定
+    // card_db_get(0) 是整個資料表的開頭
+    fingerprint = sim_fingerprint_bytes(fingerprint, card_db_get(0), CARD_ID_COUNT * sizeof(CardStats));
+    config.fingerprint = rng_mix64(fingerprint ^ bot_settings_fingerprint());
+
+    SimStats stats;
+    sim_stats_init(&stats);
+    bool ok = sim_run(&config, first, first + games, checkpointPath, checkpointEvery, threads, &stats);
+    close_book();
+    close_nn();
+    if (!ok)
+    {
+        fprintf(stderr, "Simulation failed (see log for details)\n");
+        return 1;
+    }
+
+    const CharacterBase *c0 = get_character_info(config.characters[0]);
+    const CharacterBase *c1 = get_character_info(config.characters[1]);
+    printf("%s (%s) vs %s (%s)\n", c0->name, config.bots[0]->name, c1->name, config.bots[1]->name);
+    printf("Games: %llu\n", (unsigned long long)stats.games);
+    printf("Player 1 wins: %llu\n", (unsigned long long)stats.wins[0]);
+    printf("Player 2 wins: %llu\n", (unsigned long long)stats.wins[1]);
+    printf("Draws: %llu\n", (unsigned long long)stats.draws);
+    if (stats.games > 0)
+    {
+        printf("Average turns: %.2f\n", (double)stats.totalTurns / (double)stats.games);
+        printf("Average choices: %.2f\n", (double)stats.totalChoices / (double)stats.games);
+    }
+    return 0;
+}
+
+static int cmd_matrix(int argc, char **argv)
+{
+    const BotPolicy *bots[2] = {find_bot_policy("greedy"), find_bot_policy("greedy")};
+    uint64_t games = 200;
+    uint64_t seed = 1;
+    uint32_t maxTurns = SIM_DEFAULT_MAX_TURNS;
+    int threads = 0;
+    const char *csvPath = NULL;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--games") == 0 && hasValue)
+            games = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--max-turns") == 0 && hasValue)
+            maxTurns = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0 && hasValue)
+            csvPath = argv[++i];
+        else if (strcmp(argv[i], "--bots") == 0 && i + 2 < argc)
+        {
+            if (!parse_bot(argv[i + 1], &bots[0]) || !parse_bot(argv[i + 2], &bots[1]))
+                return 1;
+            i += 2;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    MatchupMatrix *matrix = malloc(sizeof(MatchupMatrix));
+    if (matrix == NULL)
+        return 1;
+    run_matchup_matrix(bots, seed, maxTurns, games, threads, matrix);
+    printf("Row character (%s) win rate against column character (%s), %llu games per seat order\n\n",
+           bots[0]->name, bots[1]->name, (unsigned long long)games);
+    print_matchup_matrix(stdout, matrix);
+
+    if (csvPath != NULL)
+    {
+        FILE *fp = fopen(csvPath, "w");
+        if (fp == NULL)
+        {
+            fprintf(stderr, "Cannot open %s\n", csvPath);
+            free(matrix);
+            return 1;
+        }
+        write_matchup_csv(fp, matrix);
+        fclose(fp);
+    }
+    free(matrix);
+    return 0;
+}
+
+static int cmd_cards(int argc, char **argv)
+{
+    CardImpactConfig config;
+    init_card_impact_config(&config);
+    const char *csvPath = NULL;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--games") == 0 && hasValue)
+            config.gamesPerCard = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            config.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--max-turns") == 0 && hasValue)
+            config.maxTurns = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            config.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0 && hasValue)
+            csvPath = argv[++i];
+        else if (strcmp(argv[i], "--bots") == 0 && i + 2 < argc)
+        {
+            if (!parse_bot(argv[i + 1], &config.bots[0]) || !parse_bot(argv[i + 2], &config.bots[1]))
+                return 1;
+            i += 2;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    CardImpact *results = malloc(CARD_ID_MAX * sizeof(CardImpact));
+    if (results == NULL)
+        return 1;
+    run_card_impact(&config, results);
+    rank_card_impacts(results, CARD_ID_MAX);
+    printf("Card impact for %s against %s, %llu paired games per card\n\n", config.bots[0]->name,
+           config.bots[1]->name, (unsigned long long)config.gamesPerCard);
+    print_card_impacts(stdout, results, CARD_ID_MAX);
+
+    if (csvPath != NULL)
+    {
+        FILE *fp = fopen(csvPath, "w");
+        if (fp == NULL)
+        {
+            fprintf(stderr, "Cannot open %s\n", csvPath);
+            free(results);
+            return 1;
+        }
+        write_card_impact_csv(fp, results, CARD_ID_MAX);
+        fclose(fp);
+    }
+    free(results);
+    return 0;
+}
+
+static int cmd_tournament(int argc, char **argv)
+{
+    TournamentConfig config;
+    init_tournament_config(&config);
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--bots") == 0)
+        {
+            // 接在後面直到下一個選項的都是策略名稱
+            config.botCount = 0;
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
+            {
+                if (config.botCount == TOURNAMENT_MAX_BOTS)
+                {
+                    fprintf(stderr, "Too many bots (max %d)\n", TOURNAMENT_MAX_BOTS);
+                    return 1;
+                }
+                if (!parse_bot(argv[++i], &config.bots[config.botCount]))
+                    return 1;
+                config.botCount++;
+            }
+        }
+        else if (strcmp(argv[i], "--gauntlet") == 0)
+            config.mode = TOURNAMENT_GAUNTLET;
+        else if (strcmp(argv[i], "--no-sprt") == 0)
+            config.useSprt = false;
+        else if (strcmp(argv[i], "--games") == 0 && hasValue)
+            config.maxGames = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--batch") == 0 && hasValue)
+            config.batchGames = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--elo0") == 0 && hasValue)
+            config.sprt.elo0 = atof(argv[++i]);
+        else if (strcmp(argv[i], "--elo1") == 0 && hasValue)
+            config.sprt.elo1 = atof(argv[++i]);
+        else if (strcmp(argv[i], "--alpha") == 0 && hasValue)
+            config.sprt.alpha = atof(argv[++i]);
+        else if (strcmp(argv[i], "--beta") == 0 && hasValue)
+            config.sprt.beta = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            config.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--max-turns") == 0 && hasValue)
+            config.maxTurns = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            config.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--book") == 0 && hasValue)
+        {
+            if (!open_book(argv[++i]))
+                return 1;
+        }
+        else if (strcmp(argv[i], "--nn") == 0 && hasValue)
+        {
+            if (!open_nn(argv[++i]))
+                return 1;
+        }
+        else if (strcmp(argv[i], "--weights") == 0 && hasValue)
+        {
+            if (!open_weights(argv[++i]))
+                return 1;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (config.botCount < 2)
+    {
+        fprintf(stderr, "A tournament needs at least two bots\n");
+        return 1;
+    }
+
+    TournamentResult *result = malloc(sizeof(TournamentResult));
+    if (result == NULL)
+        return 1;
+    run_tournament(&config, result);
+    close_book();
+    close_nn();
+    print_tournament(stdout, &config, result);
+    free(result);
+    return 0;
+}
+
+static int cmd_book(int argc, char **argv)
+{
+    BookConfig config;
+    init_book_config(&config);
+    const char *outPath = NULL;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--out") == 0 && hasValue)
+            outPath = argv[++i];
+        else if (strcmp(argv[i], "--games") == 0 && hasValue)
+            config.gamesPerMatchup = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--turns") == 0 && hasValue)
+            config.bookTurns = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--depth") == 0 && hasValue)
+            config.search.maxDepth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--nodes") == 0 && hasValue)
+            config.search.nodeLimit = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            config.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            config.threads = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (outPath == NULL)
+    {
+        fprintf(stderr, "Missing --out FILE\n");
+        return 1;
+    }
+
+    uint64_t entries = 0;
+    if (!generate_opening_book(&config, outPath, &entries))
+    {
+        fprintf(stderr, "Opening book generation failed (see log for details)\n");
+        return 1;
+    }
+    printf("Wrote %llu positions to %s\n", (unsigned long long)entries, outPath);
+    return 0;
+}
+
+static void print_vector(const char *label, vector *vec)
+{
+    printf("%s:", label);
+    for (uint32_t i = 0; i < vec->SIZE; i++)
+        printf(" %d", vec->array[i]);
+    printf("\n");
+}
+
+// 回合結束補牌時各類至少一張的機率
+static void print_refill_odds(player *p)
+{
+    static const char *names[DRAW_CATEGORY_COUNT] = {"attack", "defense", "move", "general", "skill", "other"};
+    PileComposition piles;
+    DrawOdds odds;
+    count_draw_piles(p, true, &piles);
+    get_draw_odds(&piles, DRAW_REFILL_CARDS, &odds);
+    printf("Next draw (%u cards), at least one:", odds.draws);
+    for (int c = 0; c < DRAW_CATEGORY_COUNT; c++)
+    {
+        if (odds.atLeast[c][1] > 0)
+            printf(" %s %.0f%%", names[c], odds.atLeast[c][1] * 100.0);
+    }
+    printf("\n");
+}
+
+static void print_position(game *gs, vector *choices)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        player *p = &gs->players[i];
+        printf("P%d %s%s life %d defense %d energy %d position %d\n", i + 1,
+               get_character_info(p->character)->name, gs->now_turn_player_id == i ? " (to move)" : "", p->life,
+               p->defense, p->energy, p->locate[0]);
+    }
+    print_vector("Hand", &gs->players[gs->now_turn_player_id].hand);
+    print_refill_odds(&gs->players[gs->now_turn_player_id]);
+    printf("Status %d, ", gs->status);
+    print_vector("choices", choices);
+}
+
+static double elapsed_seconds(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// 購買時顯示 rollout 建議（最多 200 ms）
+static void print_purchase_hints(game *gs)
+{
+    AdvisorConfig config;
+    init_advisor_config(&config);
+    config.timeBudgetMs = 200;
+    config.seed = (uint64_t)time(NULL);
+    PurchaseAdvice advice;
+    if (!advise_purchase(&config, gs, &advice))
+        return;
+    printf("Purchase hints (%llu rollouts):", (unsigned long long)advice.rollouts);
+    for (uint32_t i = 0; i < advice.count && i < 3; i++)
+        printf("  %d %s (%+.2f)", advice.options[i].choice, get_card_name(advice.options[i].cardId),
+               advice.options[i].value);
+    printf("\n");
+}
+
+// 行動選擇時顯示各行動的最佳出牌組合（手牌位置從 1 開始，技能卡+基本牌）
+static void print_combo_hints(game *gs)
+{
+    static const char *names[COMBO_GOAL_COUNT] = {"attack", "defense", "move"};
+    for (int goal = 0; goal < COMBO_GOAL_COUNT; goal++)
+    {
+        ComboPlan plan;
+        plan_combo(gs, (ComboGoal)goal, &plan);
+        if (plan.count == 0)
+            continue;
+        printf("Best %s: %d (+%d energy), cards", names[goal], plan.effect, plan.energy);
+        for (uint32_t i = 0; i < plan.count; i++)
+        {
+            if (plan.plays[i].skill >= 0)
+                printf(" %d+%d", plan.plays[i].skill + 1, plan.plays[i].basic + 1);
+            else
+                printf(" %d", plan.plays[i].basic + 1);
+        }
+        printf("\n");
+    }
+}
+
+// 每個選擇確認前的結果（只列出有效果的選擇）
+static void print_choice_previews(game *gs, vector *choices)
+{
+    for (uint32_t i = 0; i < choices->SIZE; i++)
+    {
+        ActionPreview preview;
+        if (!preview_choice(gs, choices->array[i], &preview) || !preview_has_effect(&preview))
+            continue;
+        printf("  %d", preview.choice);
+        if (preview.partnerChoice != 0)
+            printf("+%d", preview.partnerChoice);
+        printf(":");
+        if (preview.damage > 0)
+            printf(" damage %d (life -%d)", preview.damage, preview.lifeDamage);
+        for (int p = 0; p < 2; p++)
+        {
+            if (preview.after[p].defense > preview.before[p].defense)
+                printf(" P%d defense +%d", p + 1, preview.after[p].defense - preview.before[p].defense);
+            if (preview.after[p].position != preview.before[p].position)
+                printf(" P%d position %d->%d", p + 1, preview.before[p].position, preview.after[p].position);
+        }
+        if (preview.energyGained != 0)
+            printf(" energy %+d", preview.energyGained);
+        if (preview.winner >= 0)
+            printf(" P%d wins", preview.winner + 1);
+        printf("\n");
+    }
+}
+
+// 人類對電腦（搜尋），電腦在人類思考時預先搜尋
+static int cmd_play(int argc, char **argv)
+{
+    uint8_t characters[2] = {0, 1};
+    int8_t humanSeat = 0;
+    uint64_t seed = (uint64_t)time(NULL);
+    bool usePonder = true;
+    bool showHints = true;
+    SearchConfig search;
+    init_search_config(&search);
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--chars") == 0 && i + 2 < argc)
+        {
+            if (!parse_character(argv[i + 1], &characters[0]) || !parse_character(argv[i + 2], &characters[1]))
+                return 1;
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--seat") == 0 && hasValue)
+            humanSeat = atoi(argv[++i]) == 2 ? 1 : 0;
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--depth") == 0 && hasValue)
+            search.maxDepth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--nodes") == 0 && hasValue)
+            search.nodeLimit = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--time-ms") == 0 && hasValue)
+            search.timeLimitMs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--no-ponder") == 0)
+            usePonder = false;
+        else if (strcmp(argv[i], "--no-hints") == 0)
+            showHints = false;
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    int8_t botSeat = (int8_t)(1 - humanSeat);
+    Ponderer *ponder = malloc(sizeof(Ponderer));
+    if (ponder == NULL || !ponder_init(ponder, &search, botSeat, TT_DEFAULT_MEGABYTES))
+    {
+        fprintf(stderr, "Cannot allocate the search table\n");
+        free(ponder);
+        return 1;
+    }
+
+    RngState gameRng;
+    RngState botRng;
+    rng_seed(&gameRng, seed, 0);
+    rng_seed(&botRng, seed, 1);
+    rng_set_active(&gameRng);
+    game gameState;
+    init_duel(&gameState, characters[0], characters[1]);
+
+    while (get_winner(&gameState) < 0)
+    {
+        vector choices;
+        get_legal_choices(&gameState, &choices);
+        if (choices.SIZE == 0)
+            break;
+
+        int32_t choice;
+        if (gameState.now_turn_player_id == humanSeat)
+        {
+            if (usePonder)
+                ponder_start(ponder, &gameState, &gameRng, &botRng);
+            printf("\n");
+            print_position(&gameState, &choices);
+            if (showHints && gameState.status == BUY_CARD_TYPE)
+                print_purchase_hints(&gameState);
+            if (showHints && gameState.status == CHOOSE_MOVE)
+                print_combo_hints(&gameState);
+            if (showHints)
+                print_choice_previews(&gameState, &choices);
+            printf("Your choice: ");
+            fflush(stdout);
+            if (scanf("%d", &choice) != 1)
+                break;
+            if (findVector(&choices, choice) < 0)
+            {
+                printf("Illegal choice %d\n", choice);
+                continue;
+            }
+        }
+        else
+        {
+            struct timespec start;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            SearchResult result;
+            bool hit = false;
+            choice = ponder_choose(ponder, &gameState, &choices, &botRng, &result, &hit);
+            printf("Bot chooses %d (depth %d, %llu nodes, %.1f ms%s)\n", choice, result.depth,
+                   (unsigned long long)result.nodes, elapsed_seconds(&start) * 1000.0, hit ? ", ponder hit" : "");
+        }
+        apply_choice(&gameState, choice);
+    }
+
+    int winner = get_winner(&gameState);
+    if (winner >= 0)
+        printf("\n%s wins\n", winner == humanSeat ? "You" : "The bot");
+    if (usePonder)
+        printf("Ponder hits: %llu, misses: %llu\n", (unsigned long long)ponder->hits,
+               (unsigned long long)ponder->misses);
+    rng_set_active(NULL);
+    ponder_free(ponder);
+    free(ponder);
+    return 0;
+}
+
+// 依遮罩從合法動作中隨機挑選
+static void random_actions(const RlEnv *env, RngState *rng, int32_t *actions)
+{
+    for (uint32_t b = 0; b < env->config.batchSize; b++)
+    {
+        const uint8_t *mask = env->legalMasks + (size_t)b * RL_ACTION_COUNT;
+        int32_t legal[RL_ACTION_COUNT];
+        uint32_t count = 0;
+        for (int32_t a = 0; a < RL_ACTION_COUNT; a++)
+        {
+            if (mask[a])
+                legal[count++] = a;
+        }
+        actions[b] = count > 0 ? legal[rng_bounded(rng, count)] : 0;
+    }
+}
+
+// 批次環境的吞吐量：每一步從合法動作中隨機挑選
+static int cmd_rlbench(int argc, char **argv)
+{
+    RlEnvConfig config;
+    rl_env_init_config(&config);
+    uint64_t steps = 1000;
+    uint64_t seed = 1;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--batch") == 0 && hasValue)
+            config.batchSize = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--steps") == 0 && hasValue)
+            steps = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            config.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--opponent") == 0 && hasValue)
+        {
+            if (!parse_bot(argv[++i], &config.opponent))
+                return 1;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    RlEnv env;
+    int32_t *actions = malloc(config.batchSize * sizeof(int32_t));
+    if (actions == NULL || !rl_env_create(&env, &config))
+    {
+        fprintf(stderr, "Cannot create %u environments\n", config.batchSize);
+        free(actions);
+        return 1;
+    }
+
+    RngState rng;
+    rng_seed(&rng, seed, 0);
+    rl_env_reset(&env, seed);
+    uint64_t episodes = 0;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint64_t step = 0; step < steps; step++)
+    {
+        random_actions(&env, &rng, actions);
+        rl_env_step(&env, actions);
+        for (uint32_t b = 0; b < config.batchSize; b++)
+            episodes += env.dones[b];
+    }
+    double seconds = elapsed_seconds(&start);
+
+    uint64_t total = steps * config.batchSize;
+    printf("%llu steps (%u environments), %llu episodes finished, %.3f s, %.0f steps/s\n",
+           (unsigned long long)total, config.batchSize, (unsigned long long)episodes, seconds,
+           seconds > 0 ? (double)total / seconds : 0.0);
+    rl_env_destroy(&env);
+    free(actions);
+    return 0;
+}
+
+// 生產者行程：每一步的輸出直接寫在環形緩衝區的格子裡
+static int produce_steps(ShmRing *ring, const RlEnvConfig *config, uint64_t seed, uint64_t steps)
+{
+    RlEnv env;
+    int32_t *actions = malloc(config->batchSize * sizeof(int32_t));
+    if (actions == NULL || !rl_env_create(&env, config))
+        return 1;
+
+    RngState rng;
+    rng_seed(&rng, seed, 0);
+    rl_env_bind_record(&env, shm_ring_reserve_wait(ring));
+    rl_env_reset(&env, seed);
+    shm_ring_commit(ring);
+    for (uint64_t step = 0; step < steps; step++)
+    {
+        // 上一筆紀錄已提交但還在原處，從中讀取遮罩
+        random_actions(&env, &rng, actions);
+        rl_env_bind_record(&env, shm_ring_reserve_wait(ring));
+        rl_env_step(&env, actions);
+        shm_ring_commit(ring);
+    }
+    shm_ring_finish(ring);
+    rl_env_destroy(&env);
+    free(actions);
+    return 0;
+}
+
+// 多個模擬行程經由共享記憶體把每一步的資料交給這個行程
+static int cmd_shmbench(int argc, char **argv)
+{
+    RlEnvConfig config;
+    rl_env_init_config(&config);
+    int producers = 2;
+    uint64_t steps = 1000;
+    uint32_t slots = 16;
+    uint64_t seed = 1;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--producers") == 0 && hasValue)
+            producers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--batch") == 0 && hasValue)
+            config.batchSize = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--steps") == 0 && hasValue)
+            steps = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--slots") == 0 && hasValue)
+            slots = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            seed = strtoull(argv[++i], NULL, 10);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (producers < 1 || config.batchSize == 0)
+    {
+        fprintf(stderr, "Need at least one producer and a non-empty batch\n");
+        return 1;
+    }
+
+    RlRecordLayout layout;
+    rl_env_record_layout(config.batchSize, &layout);
+    ShmRing *rings = calloc((size_t)producers, sizeof(ShmRing));
+    pid_t *children = calloc((size_t)producers, sizeof(pid_t));
+    if (rings == NULL || children == NULL)
+        return 1;
+    for (int p = 0; p < producers; p++)
+    {
+        if (!shm_ring_create(&rings[p], NULL, slots, layout.size))
+        {
+            fprintf(stderr, "Cannot create shared ring (see log for details)\n");
+            return 1;
+        }
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int p = 0; p < producers; p++)
+    {
+        children[p] = fork();
+        if (children[p] == 0)
+            _exit(produce_steps(&rings[p], &config, rng_mix64(seed + (uint64_t)p), steps));
+        if (children[p] < 0)
+        {
+            fprintf(stderr, "Cannot fork producer %d\n", p);
+            return 1;
+        }
+    }
+
+    // 依序輪詢每個環形緩衝區，原地讀取後釋放
+    uint64_t records = 0;
+    uint64_t transitions = 0;
+    uint64_t episodes = 0;
+    double rewardSum = 0.0;
+    int active = producers;
+    while (active > 0)
+    {
+        active = 0;
+        bool progressed = false;
+        for (int p = 0; p < producers; p++)
+        {
+            const uint8_t *record = shm_ring_peek(&rings[p]);
+            if (record == NULL)
+            {
+                active += !shm_ring_drained(&rings[p]);
+                continue;
+            }
+            const float *rewards = (const float *)(record + layout.rewards);
+            const uint8_t *dones = record + layout.dones;
+            for (uint32_t b = 0; b < config.batchSize; b++)
+            {
+                rewardSum += rewards[b];
+                episodes += dones[b];
+            }
+            records++;
+            transitions += config.batchSize;
+            shm_ring_release(&rings[p]);
+            progressed = true;
+            active++;
+        }
+        if (!progressed)
+            sched_yield();
+    }
+    double seconds = elapsed_seconds(&start);
+
+    int failed = 0;
+    for (int p = 0; p < producers; p++)
+    {
+        int status = 0;
+        waitpid(children[p], &status, 0);
+        failed += !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+        shm_ring_close(&rings[p]);
+    }
+    printf("%d producers, %llu records (%zu bytes each), %llu transitions, %llu episodes, reward sum %.0f\n",
+           producers, (unsigned long long)records, layout.size, (unsigned long long)transitions,
+           (unsigned long long)episodes, rewardSum);
+    printf("%.3f s, %.0f transitions/s, %.1f MB/s\n", seconds, seconds > 0 ? (double)transitions / seconds : 0.0,
+           seconds > 0 ? (double)records * (double)layout.size / seconds / 1e6 : 0.0);
+    free(rings);
+    free(children);
+    return failed == 0 && records == (uint64_t)producers * (steps + 1) ? 0 : 1;
+}
+
+static int cmd_dataset(int argc, char **argv)
+{
+    DatasetConfig config;
+    init_dataset_config(&config);
+    const char *outPath = NULL;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--out") == 0 && hasValue)
+            outPath = argv[++i];
+        else if (strcmp(argv[i], "--games") == 0 && hasValue)
+            config.games = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            config.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--max-turns") == 0 && hasValue)
+            config.maxTurns = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--chunk-rows") == 0 && hasValue)
+            config.chunkRows = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            config.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bots") == 0 && i + 2 < argc)
+        {
+            if (!parse_bot(argv[i + 1], &config.bots[0]) || !parse_bot(argv[i + 2], &config.bots[1]))
+                return 1;
+            i += 2;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (outPath == NULL)
+    {
+        fprintf(stderr, "Missing --out FILE\n");
+        return 1;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t rows = 0;
+    if (!generate_dataset(&config, outPath, &rows))
+    {
+        fprintf(stderr, "Dataset generation failed (see log for details)\n");
+        return 1;
+    }
+    double seconds = elapsed_seconds(&start);
+    printf("Wrote %llu rows from %llu games to %s in %.3f s (%.0f rows/s)\n", (unsigned long long)rows,
+           (unsigned long long)config.games, outPath, seconds, seconds > 0 ? (double)rows / seconds : 0.0);
+    return 0;
+}
+
+static int cmd_datainfo(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fprintf(stderr, "Usage: datainfo FILE\n");
+        return 1;
+    }
+
+    DatasetReader reader;
+    if (!dataset_open(&reader, argv[0]))
+        return 1;
+
+    // 逐欄解壓縮一次，確認整個檔案可讀並統計壓縮率
+    static const char *columnNames[DATASET_COLUMN_COUNT] = {"features", "masks", "actions", "players",
+                                                            "outcomes", "plies", "games"};
+    uint64_t stored[DATASET_COLUMN_COUNT] = {0};
+    uint64_t raw[DATASET_COLUMN_COUNT] = {0};
+    uint8_t *buffer = malloc((size_t)reader.header->chunkRows * FEATURE_COUNT);
+    bool ok = buffer != NULL;
+    for (uint64_t chunk = 0; ok && chunk < reader.header->chunkCount; chunk++)
+    {
+        for (int c = 0; ok && c < DATASET_COLUMN_COUNT; c++)
+        {
+            const DatasetColumnInfo *info = &reader.chunks[chunk].columns[c];
+            stored[c] += info->size;
+            raw[c] += info->rawSize;
+            ok = dataset_read_column(&reader, chunk, (DatasetColumn)c, buffer);
+        }
+    }
+
+    printf("%llu rows in %llu chunks of up to %u rows, %zu bytes\n", (unsigned long long)reader.header->rowCount,
+           (unsigned long long)reader.header->chunkCount, reader.header->chunkRows, reader.size);
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++)
+        printf("  %-9s %12llu -> %12llu bytes (%.1f%%)\n", columnNames[c], (unsigned long long)raw[c],
+               (unsigned long long)stored[c], raw[c] > 0 ? 100.0 * (double)stored[c] / (double)raw[c] : 0.0);
+    free(buffer);
+    dataset_close(&reader);
+    if (!ok)
+    {
+        fprintf(stderr, "Corrupt column data\n");
+        return 1;
+    }
+    return 0;
+}
+
+// 以隨機對局取樣 count 個局面的特徵（以行動者為自己）
+static void sample_positions(uint64_t seed, size_t count, int8_t *features)
+{
+    RngState rng;
+    rng_seed(&rng, seed, 0);
+    rng_set_active(&rng);
+    game gs;
+    vector choices;
+    init_duel(&gs, (uint8_t)rng_bounded(&rng, CHARACTER_COUNT), (uint8_t)rng_bounded(&rng, CHARACTER_COUNT));
+    for (size_t i = 0; i < count; i++)
+    {
+        get_legal_choices(&gs, &choices);
+        if (get_winner(&gs) >= 0 || choices.SIZE == 0)
+        {
+            init_duel(&gs, (uint8_t)rng_bounded(&rng, CHARACTER_COUNT), (uint8_t)rng_bounded(&rng, CHARACTER_COUNT));
+            get_legal_choices(&gs, &choices);
+        }
+        extract_features_int8(&gs, gs.now_turn_player_id, features + i * FEATURE_COUNT);
+        apply_choice(&gs, choices.array[rng_bounded(&rng, choices.SIZE)]);
+    }
+    rng_set_active(NULL);
+}
+
+static int cmd_nnbench(int argc, char **argv)
+{
+    const char *nnPath = NULL;
+    size_t positions = 4096;
+    uint32_t repeat = 100;
+    uint64_t seed = 1;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--nn") == 0 && hasValue)
+            nnPath = argv[++i];
+        else if (strcmp(argv[i], "--positions") == 0 && hasValue)
+            positions = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--repeat") == 0 && hasValue)
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            seed = strtoull(argv[++i], NULL, 10);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    NnModel model;
+    bool loaded = nnPath != NULL ? nn_model_load(&model, nnPath)
+                                 : nn_model_init_random(&model, NN_DEFAULT_HIDDEN, NN_DEFAULT_HIDDEN, seed);
+    if (!loaded || model.inputCount != FEATURE_COUNT || positions == 0)
+    {
+        fprintf(stderr, "Cannot set up network (see log for details)\n");
+        if (loaded)
+            nn_model_free(&model);
+        return 1;
+    }
+
+    int8_t *features = malloc(positions * FEATURE_COUNT);
+    int32_t *reference = malloc(positions * sizeof(int32_t));
+    int32_t *scores = malloc(positions * sizeof(int32_t));
+    if (features == NULL || reference == NULL || scores == NULL)
+        return 1;
+    sample_positions(seed, positions, features);
+    printf("Network %u-%u-%u-1, %zu positions x %u\n", model.inputCount, model.hidden[0], model.hidden[1],
+           positions, repeat);
+
+    // 每個支援的指令集各跑一次，結果必須與純量版本完全相同
+    NnKernel best = nn_get_kernel();
+    bool mismatch = false;
+    for (int k = NN_KERNEL_SCALAR; k <= (int)best; k++)
+    {
+        NnKernel kernel = nn_set_kernel((NnKernel)k);
+        if (kernel != (NnKernel)k)
+            continue;
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t r = 0; r < repeat; r++)
+            nn_forward_batch(&model, features, positions, scores);
+        double seconds = elapsed_seconds(&start);
+        if (k == NN_KERNEL_SCALAR)
+            memcpy(reference, scores, positions * sizeof(int32_t));
+        bool same = memcmp(reference, scores, positions * sizeof(int32_t)) == 0;
+        mismatch = mismatch || !same;
+        double evaluations = (double)positions * repeat;
+        printf("  %-6s %.3f s, %.0f evaluations/s%s\n", nn_kernel_name(kernel), seconds,
+               seconds > 0 ? evaluations / seconds : 0.0, same ? "" : " (MISMATCH)");
+    }
+    nn_set_kernel(best);
+
+    free(features);
+    free(reference);
+    free(scores);
+    nn_model_free(&model);
+    return mismatch ? 1 : 0;
+}
+
+static void print_tuner_progress(void *ctx, uint32_t iteration, double score, const EvalWeights *weights)
+{
+    EvalWeights copy = *weights;
+    printf("iteration %4u  score %+.3f ", iteration + 1, score);
+    for (int i = 0; i < EVAL_WEIGHT_COUNT; i++)
+        printf(" %s=%d", eval_weight_name(i), *eval_weight_at(&copy, i));
+    printf("\n");
+    fflush(stdout);
+}
+
+static int cmd_tune(int argc, char **argv)
+{
+    TunerConfig config;
+    init_tuner_config(&config);
+    const char *outPath = NULL;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--out") == 0 && hasValue)
+            outPath = argv[++i];
+        else if (strcmp(argv[i], "--start") == 0 && hasValue)
+        {
+            if (!load_eval_weights(argv[++i], &config.start))
+                return 1;
+        }
+        else if (strcmp(argv[i], "--iterations") == 0 && hasValue)
+            config.iterations = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--games") == 0 && hasValue)
+            config.gamesPerIteration = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--a") == 0 && hasValue)
+            config.a = atof(argv[++i]);
+        else if (strcmp(argv[i], "--c") == 0 && hasValue)
+            config.c = atof(argv[++i]);
+        else if (strcmp(argv[i], "--depth") == 0 && hasValue)
+            config.search.maxDepth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--nodes") == 0 && hasValue)
+            config.search.nodeLimit = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            config.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--max-turns") == 0 && hasValue)
+            config.maxTurns = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            config.threads = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (outPath == NULL)
+    {
+        fprintf(stderr, "Missing --out FILE\n");
+        return 1;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    EvalWeights tuned;
+    run_eval_tuner(&config, print_tuner_progress, NULL, &tuned);
+    double seconds = elapsed_seconds(&start);
+    if (!save_eval_weights(outPath, &tuned))
+    {
+        fprintf(stderr, "Cannot write %s (see log for details)\n", outPath);
+        return 1;
+    }
+    uint64_t games = (uint64_t)config.iterations * ((config.gamesPerIteration + 1) / 2 * 2);
+    printf("Wrote %s after %llu games in %.1f s (%.0f games/s)\n", outPath, (unsigned long long)games, seconds,
+           seconds > 0 ? (double)games / seconds : 0.0);
+    return 0;
+}
+
+static int cmd_engine(int argc, char **argv)
+{
+    EngineOptions options;
+    init_engine_options(&options);
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--bot") == 0 && hasValue)
+        {
+            if (!parse_bot(argv[++i], &options.bot))
+                return 1;
+        }
+        else if (strcmp(argv[i], "--depth") == 0 && hasValue)
+            options.search.maxDepth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--nodes") == 0 && hasValue)
+            options.search.nodeLimit = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            options.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--weights") == 0 && hasValue)
+        {
+            if (!open_weights(argv[++i]))
+                return 1;
+            options.search.evalCtx = &evalWeights;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (options.bot != NULL)
+        options.name = options.bot->name;
+    run_engine_loop(&options, stdin, stdout);
+    return 0;
+}
+
+static int cmd_match(int argc, char **argv)
+{
+    const char *commandLines[2] = {NULL, NULL};
+    uint8_t characters[2] = {0, 1};
+    uint64_t games = 10;
+    uint64_t seed = 1;
+    uint32_t maxTurns = SIM_DEFAULT_MAX_TURNS;
+    uint32_t timeoutMs = 0;
+    EngineLimits limits = {0, 0, 0};
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--engines") == 0 && i + 2 < argc)
+        {
+            commandLines[0] = argv[i + 1];
+            commandLines[1] = argv[i + 2];
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--chars") == 0 && i + 2 < argc)
+        {
+            if (!parse_character(argv[i + 1], &characters[0]) || !parse_character(argv[i + 2], &characters[1]))
+                return 1;
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--games") == 0 && hasValue)
+            games = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--max-turns") == 0 && hasValue)
+            maxTurns = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--movetime") == 0 && hasValue)
+            limits.moveTimeMs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--nodes") == 0 && hasValue)
+            limits.nodeLimit = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--depth") == 0 && hasValue)
+            limits.maxDepth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--timeout-ms") == 0 && hasValue)
+            timeoutMs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (commandLines[0] == NULL)
+    {
+        fprintf(stderr, "Missing --engines CMD1 CMD2\n");
+        return 1;
+    }
+    // 預設等待時間：每步時間的兩倍再加五秒
+    if (timeoutMs == 0)
+        timeoutMs = limits.moveTimeMs * 2 + 5000;
+
+    ExternalEngine engines[2];
+    for (int e = 0; e < 2; e++)
+    {
+        if (!engine_start(&engines[e], commandLines[e], timeoutMs))
+        {
+            fprintf(stderr, "Cannot start engine \"%s\" (see log for details)\n", commandLines[e]);
+            if (e == 1)
+                engine_stop(&engines[0]);
+            return 1;
+        }
+    }
+
+    // 每兩場使用同一條亂數串流並交換座位
+    uint64_t wins[2] = {0, 0};
+    uint64_t forfeits[2] = {0, 0};
+    uint64_t draws = 0;
+    uint64_t choices = 0;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint64_t g = 0; g < games; g++)
+    {
+        int first = (int)(g % 2);
+        ExternalEngine *seats[2] = {&engines[first], &engines[1 - first]};
+        EngineGameResult result;
+        play_engine_game(seats, characters, seed, g / 2, &limits, timeoutMs, maxTurns, &result);
+        choices += result.choices;
+        if (result.forfeit >= 0)
+            forfeits[result.forfeit == 0 ? first : 1 - first]++;
+        if (result.winner >= 0)
+            wins[result.winner == 0 ? first : 1 - first]++;
+        else
+            draws++;
+    }
+    double seconds = elapsed_seconds(&start);
+
+    for (int e = 0; e < 2; e++)
+        printf("Engine %d: %s  wins %llu  forfeits %llu\n", e + 1, engines[e].name, (unsigned long long)wins[e],
+               (unsigned long long)forfeits[e]);
+    printf("Games: %llu  Draws: %llu\n", (unsigned long long)games, (unsigned long long)draws);
+    printf("Choices: %llu in %.2f s (%.3f ms per choice)\n", (unsigned long long)choices, seconds,
+           choices > 0 ? seconds * 1000.0 / (double)choices : 0.0);
+    engine_stop(&engines[0]);
+    engine_stop(&engines[1]);
+    return 0;
+}
+
+static int cmd_perft(int argc, char **argv)
+{
+    PerftConfig config;
+    init_perft_config(&config);
+    uint8_t characters[2] = {0, 1};
+    const char *position = NULL;
+    bool divide = false;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--depth") == 0 && hasValue)
+            config.depth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            config.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--chars") == 0 && i + 2 < argc)
+        {
+            if (!parse_character(argv[i + 1], &characters[0]) || !parse_character(argv[i + 2], &characters[1]))
+                return 1;
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--position") == 0 && hasValue)
+            position = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            config.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hash") == 0)
+            config.hashLeaves = true;
+        else if (strcmp(argv[i], "--divide") == 0)
+            divide = true;
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (config.depth < 1 || config.depth > PERFT_MAX_DEPTH)
+    {
+        fprintf(stderr, "Depth must be between 1 and %d\n", PERFT_MAX_DEPTH);
+        return 1;
+    }
+
+    // 起始局面的洗牌使用 (seed, 1)，展開時使用 (seed, 0)
+    static game root;
+    if (position != NULL)
+    {
+        if (!decode_game_text(position, strlen(position), &root))
+        {
+            fprintf(stderr, "Invalid position\n");
+            return 1;
+        }
+    }
+    else
+    {
+        RngState initRng;
+        rng_seed(&initRng, config.seed, 1);
+        rng_set_active(&initRng);
+        init_duel(&root, characters[0], characters[1]);
+        rng_set_active(NULL);
+    }
+
+    PerftResult *result = malloc(sizeof(PerftResult));
+    if (result == NULL)
+        return 1;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    run_perft(&config, &root, result);
+    double seconds = elapsed_seconds(&start);
+
+    uint64_t totalNodes = 0;
+    for (int d = 0; d <= config.depth; d++)
+    {
+        printf("depth %2d  nodes %llu\n", d, (unsigned long long)result->total.nodes[d]);
+        totalNodes += result->total.nodes[d];
+    }
+    if (divide)
+    {
+        for (uint32_t i = 0; i < result->rootCount; i++)
+            printf("choice %d: %llu\n", result->rootChoices[i], (unsigned long long)result->rootLeaves[i]);
+    }
+    printf("Terminals: %llu  Rejected: %llu\n", (unsigned long long)result->total.terminals,
+           (unsigned long long)result->total.rejected);
+    if (config.hashLeaves)
+        printf("Leaf hash: %016llx\n", (unsigned long long)result->total.leafHash);
+    printf("%llu nodes in %.3f s (%.0f nodes/s)\n", (unsigned long long)totalNodes, seconds,
+           seconds > 0 ? (double)totalNodes / seconds : 0.0);
+    int status = result->total.rejected > 0 ? 1 : 0;
+    free(result);
+    return status;
+}
+
+// 產生卡牌數值檔：從預設值（或 --from 的檔案）開始，依序套用每個 --card 之後的修改
+static int cmd_carddb(int argc, char **argv)
+{
+    const char *outPath = NULL;
+    CardStats stats[CARD_ID_COUNT];
+    memcpy(stats, card_db_defaults(), sizeof(stats));
+    CardStats *card = NULL;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--out") == 0 && hasValue)
+            outPath = argv[++i];
+        else if (strcmp(argv[i], "--from") == 0 && hasValue)
+        {
+            if (!card_db_load(argv[++i]))
+            {
+                fprintf(stderr, "Cannot load card database %s (see log for details)\n", argv[i]);
+                return 1;
+            }
+            // card_db_get(0) 是整個資料表的開頭
+            memcpy(stats, card_db_get(0), sizeof(stats));
+            card_db_reset();
+        }
+        else if (strcmp(argv[i], "--card") == 0 && hasValue)
+        {
+            int id = atoi(argv[++i]);
+            if (id < 1 || id > CARD_ID_MAX)
+            {
+                fprintf(stderr, "Invalid card %s (1-%d)\n", argv[i], CARD_ID_MAX);
+                return 1;
+            }
+            card = &stats[id];
+        }
+        else if (card != NULL && strcmp(argv[i], "--value") == 0 && hasValue)
+            card->value = atoi(argv[++i]);
+        else if (card != NULL && strcmp(argv[i], "--cost") == 0 && hasValue)
+            card->cost = atoi(argv[++i]);
+        else if (card != NULL && strcmp(argv[i], "--range") == 0 && hasValue)
+            card->range = atoi(argv[++i]);
+        else if (card != NULL && strcmp(argv[i], "--requirement") == 0 && hasValue)
+            card->requirement = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (outPath == NULL)
+    {
+        fprintf(stderr, "Missing --out FILE\n");
+        return 1;
+    }
+    if (!card_db_write(outPath, stats))
+    {
+        fprintf(stderr, "Cannot write card database %s (see log for details)\n", outPath);
+        return 1;
+    }
+
+    const CardStats *defaults = card_db_defaults();
+    for (int id = 1; id <= CARD_ID_MAX; id++)
+    {
+        if (memcmp(&stats[id], &defaults[id], sizeof(CardStats)) != 0)
+            printf("%3d %-12s value %d cost %d range %d requirement %d\n", id, get_card_name(id), stats[id].value,
+                   stats[id].cost, stats[id].range, stats[id].requirement);
+    }
+    printf("Wrote card database %s\n", outPath);
+    return 0;
+}
+
+static const SimCommand commands[] = {
+    {"run", cmd_run,
+     "run [--games N] [--first I] [--seed S] [--chars A B] [--bots P1 P2] [--max-turns T]\n"
+     "      [--threads N] [--checkpoint FILE] [--checkpoint-every N] [--book FILE]\n"
+     "      [--nn FILE] [--weights FILE]"},
+    {"matrix", cmd_matrix,
+     "matrix [--games N] [--seed S] [--bots ROW COL] [--max-turns T] [--threads N] [--csv FILE]"},
+    {"cards", cmd_cards,
+     "cards [--games N] [--seed S] [--bots FOCAL OPPONENT] [--max-turns T] [--threads N] [--csv FILE]"},
+    {"tournament", cmd_tournament,
+     "tournament [--bots B1 B2 ...] [--gauntlet] [--games MAX] [--batch N] [--no-sprt]\n"
+     "      [--elo0 E] [--elo1 E] [--alpha A] [--beta B] [--seed S] [--max-turns T] [--threads N]\n"
+     "      [--book FILE] [--nn FILE] [--weights FILE]"},
+    {"book", cmd_book,
+     "book --out FILE [--games N] [--turns T] [--depth D] [--nodes N] [--seed S] [--threads N]"},
+    {"play", cmd_play,
+     "play [--chars A B] [--seat 1|2] [--seed S] [--depth D] [--nodes N] [--time-ms T] [--no-ponder]\n"
+     "      [--no-hints]"},
+    {"rlbench", cmd_rlbench, "rlbench [--batch B] [--steps N] [--seed S] [--threads N] [--opponent BOT]"},
+    {"shmbench", cmd_shmbench, "shmbench [--producers P] [--batch B] [--steps N] [--slots S] [--seed S]"},
+    {"dataset", cmd_dataset,
+     "dataset --out FILE [--games N] [--bots P1 P2] [--seed S] [--max-turns T] [--chunk-rows R] [--threads N]"},
+    {"datainfo", cmd_datainfo, "datainfo FILE"},
+    {"tune", cmd_tune,
+     "tune --out FILE [--start FILE] [--iterations N] [--games G] [--a A] [--c C] [--depth D]\n"
+     "      [--nodes N] [--seed S] [--max-turns T] [--threads N]"},
+    {"nnbench", cmd_nnbench, "nnbench [--nn FILE] [--positions N] [--repeat R] [--seed S]"},
+    {"engine", cmd_engine, "engine [--bot NAME] [--depth D] [--nodes N] [--seed S] [--weights FILE]"},
+    {"match", cmd_match,
+     "match --engines CMD1 CMD2 [--games N] [--chars A B] [--seed S] [--max-turns T]\n"
+     "      [--movetime MS] [--nodes N] [--depth D] [--timeout-ms T]"},
+    {"perft", cmd_perft,
+     "perft [--depth D] [--seed S] [--chars A B] [--position STATE] [--threads N] [--hash] [--divide]"},
+    {"carddb", cmd_carddb,
+     "carddb --out FILE [--from FILE] [--card ID [--value V] [--cost C] [--range R] [--requirement Q]]..."},
+};
+
+static void print_usage(const char *program)
+{
+    fprintf(stderr, "Usage:\n");
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+        fprintf(stderr, "  %s %s\n", program, commands[i].usage);
+    fprintf(stderr, "Every command also accepts --plugin FILE[:ARGS] to load a bot plugin (see bot_plugin.h)\n");
+    fprintf(stderr, "and --card-db FILE to use card numbers from a carddb file (reloaded when it changes)\n");
+    print_bot_policies();
+}
+
+// --plugin 與 --card-db 可出現在任何子命令：先載入外掛與卡牌數值檔並從參數中移除，其餘交給子命令
+static bool load_plugin_options(int *argc, char **argv)
+{
+    int kept = 0;
+    for (int i = 0; i < *argc; i++)
+    {
+        if (strcmp(argv[i], "--plugin") == 0 && i + 1 < *argc)
+        {
+            if (load_bot_plugin(argv[++i]) == NULL)
+            {
+                fprintf(stderr, "Cannot load plugin %s (see log for details)\n", argv[i]);
+                return false;
+            }
+            // 外掛參數也會影響結果；檔案路徑是 ':' 之前的部分
+            char pluginPath[1024];
+            snprintf(pluginPath, sizeof(pluginPath), "%.*s", (int)strcspn(argv[i], ":"), argv[i]);
+            fingerprint_option(&globalOptionFingerprint, argv[i], pluginPath);
+        }
+        else if (strcmp(argv[i], "--card-db") == 0 && i + 1 < *argc)
+        {
+            if (!card_db_load(argv[++i]))
+            {
+                fprintf(stderr, "Cannot load card database %s (see log for details)\n", argv[i]);
+                return false;
+            }
+        }
+        else
+            argv[kept++] = argv[i];
+    }
+    *argc = kept;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+    {
+        if (strcmp(argv[1], commands[i].name) == 0)
+        {
+            int commandArgc = argc - 2;
+            if (!load_plugin_options(&commandArgc, argv + 2))
+            {
+                unload_bot_plugins();
+                card_db_reset();
+                return 1;
+            }
+            int status = commands[i].run(commandArgc, argv + 2);
+            unload_bot_plugins();
+            card_db_reset();
+            return status;
+        }
+    }
+
+    print_usage(argv[0]);
+    return 1;
+}
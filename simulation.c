@@ -0,0 +1,443 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "simulation.h"
+#include "card_db.h"
+#include "debug_log.h"
+#include "game_action.h"
+#include "game_init.h"
+
+#define CHECKPOINT_MAGIC "TFCK"
+#define CHECKPOINT_VERSION 2
+
+void sim_init_config(SimConfig *config)
+{
+    config->characters[0] = 0;
+    config->characters[1] = 1;
+    config->bots[0] = find_bot_policy("random");
+    config->bots[1] = find_bot_policy("random");
+    config->seed = 1;
+    config->maxTurns = SIM_DEFAULT_MAX_TURNS;
+    config->bannedCard[0] = 0;
+    config->bannedCard[1] = 0;
+    config->trackCardUses = false;
+    config->onChoice = NULL;
+    config->onChoiceCtx = NULL;
+    config->fingerprint = 0;
+}
+
+// 從起始牌堆移除禁用的卡牌，並重新抽起始手牌
+static void remove_banned_card(player *p, int32_t cardId)
+{
+    uint32_t handSize = p->hand.SIZE;
+
+    // 起始手牌是從牌堆尾端抽出的，反向放回即可還原牌堆順序
+    while (p->hand.SIZE > 0)
+    {
+        vector_pushback(&p->deck, p->hand.array[p->hand.SIZE - 1]);
+        vector_popback(&p->hand);
+    }
+    for (int i = (int)p->deck.SIZE - 1; i >= 0; i--)
+    {
+        if (p->deck.array[i] == cardId)
+            eraseVector(&p->deck, i);
+    }
+    for (uint32_t i = 0; i < handSize && p->deck.SIZE > 0; i++)
+    {
+        vector_pushback(&p->hand, p->deck.array[p->deck.SIZE - 1]);
+        vector_popback(&p->deck);
+    }
+}
+
+// 移除會買到禁用卡牌的購買選項
+static void filter_banned_choices(game *gs, int32_t bannedCard, vector *choices)
+{
+    bool canBuy = false;
+    for (int32_t c = -3; c <= 10; c++)
+    {
+        if (c != 0 && get_purchase_cost(gs, c) >= 0 && get_purchase_card(gs, c) != bannedCard)
+            canBuy = true;
+    }
+
+    for (int i = (int)choices->SIZE - 1; i >= 0; i--)
+    {
+        int32_t choice = choices->array[i];
+        bool banned = gs->status == BUY_CARD_TYPE ? get_purchase_card(gs, choice) == bannedCard
+                                                  : gs->status == CHOOSE_MOVE && choice == 6 && !canBuy;
+        if (banned)
+            eraseVector(choices, i);
+    }
+}
+
+void sim_play_game(const SimConfig *config, uint64_t gameIndex, SimGameResult *result)
+{
+    game gameState;
+    vector choices;
+    RngState rng;
+
+    // 平衡實驗可在模擬途中更新卡牌數值檔，每局開始前檢查（有間隔限制，成本很低），整局使用同一份數值
+    card_db_poll();
+    card_db_acquire();
+
+    // 洗牌與電腦玩家共用同一條亂數串流
+    rng_seed(&rng, config->seed, gameIndex);
+    RngState *previous = rng_get_active();
+    rng_set_active(&rng);
+
+    init_duel(&gameState, config->characters[0], config->characters[1]);
+    for (int seat = 0; seat < 2; seat++)
+    {
+        if (config->bannedCard[seat] != 0)
+            remove_banned_card(&gameState.players[seat], config->bannedCard[seat]);
+    }
+
+    result->winner = -1;
+    result->turns = 0;
+    result->choices = 0;
+    if (config->trackCardUses)
+        memset(result->cardUses, 0, sizeof(result->cardUses));
+
+    while (result->turns < config->maxTurns)
+    {
+        get_legal_choices(&gameState, &choices);
+        if (choices.SIZE == 0)
+            break;
+
+        int8_t mover = gameState.now_turn_player_id;
+        if (config->bannedCard[mover] != 0)
+            filter_banned_choices(&gameState, config->bannedCard[mover], &choices);
+
+        player *current = &gameState.players[mover];
+        uint32_t usedBefore = current->usecards.SIZE;
+        int32_t choice = bot_choose(config->bots[mover], &gameState, &choices, &rng);
+        if (config->onChoice != NULL)
+            config->onChoice(config->onChoiceCtx, &gameState, &choices, choice);
+        if (!apply_choice(&gameState, choice))
+        {
+            ERROR_LOG("Bot %s made an illegal choice %d", config->bots[mover]->name, choice);
+            break;
+        }
+        result->choices++;
+
+        // 新進入出牌區的牌就是這次打出的牌
+        if (config->trackCardUses && current->usecards.SIZE > usedBefore)
+        {
+            for (uint32_t i = usedBefore; i < current->usecards.SIZE; i++)
+            {
+                int32_t cardId = current->usecards.array[i];
+                if (cardId > 0 && cardId < CARD_ID_COUNT)
+                    result->cardUses[mover][cardId]++;
+            }
+        }
+        if (gameState.now_turn_player_id != mover)
+            result->turns++;
+    }
+
+    result->winner = (int8_t)get_winner(&gameState);
+    rng_set_active(previous);
+    card_db_release();
+}
+
+void sim_stats_init(SimStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+void sim_stats_add(SimStats *stats, const SimGameResult *result)
+{
+    stats->games++;
+    if (result->winner >= 0)
+        stats->wins[result->winner]++;
+    else
+        stats->draws++;
+    stats->totalTurns += result->turns;
+    stats->totalChoices += result->choices;
+}
+
+void sim_stats_merge(SimStats *stats, const SimStats *other)
+{
+    stats->games += other->games;
+    stats->wins[0] += other->wins[0];
+    stats->wins[1] += other->wins[1];
+    stats->draws += other->draws;
+    stats->totalTurns += other->totalTurns;
+    stats->totalChoices += other->totalChoices;
+}
+
+int sim_default_threads(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+typedef struct {
+    SimTaskFn task;
+    void *ctx;
+    size_t taskCount;
+    atomic_size_t nextTask;
+} SimTaskQueue;
+
+static void *sim_worker(void *arg)
+{
+    SimTaskQueue *queue = arg;
+    for (;;)
+    {
+        size_t index = atomic_fetch_add(&queue->nextTask, 1);
+        if (index >= queue->taskCount)
+            break;
+        queue->task(queue->ctx, index);
+    }
+    return NULL;
+}
+
+void sim_parallel_for(size_t taskCount, int threads, SimTaskFn task, void *ctx)
+{
+    SimTaskQueue queue;
+    queue.task = task;
+    queue.ctx = ctx;
+    queue.taskCount = taskCount;
+    atomic_init(&queue.nextTask, 0);
+
+    if (threads <= 0)
+        threads = sim_default_threads();
+    if ((size_t)threads > taskCount)
+        threads = taskCount > 0 ? (int)taskCount : 1;
+
+    if (threads == 1)
+    {
+        sim_worker(&queue);
+        return;
+    }
+
+    pthread_t *workers = malloc((size_t)threads * sizeof(pthread_t));
+    int started = 0;
+    for (int i = 0; workers != NULL && i < threads - 1; i++)
+    {
+        if (pthread_create(&workers[i], NULL, sim_worker, &queue) != 0)
+            break;
+        started++;
+    }
+    // 目前執行緒也一起工作；執行緒建立失敗時由它完成剩下的工作
+    sim_worker(&queue);
+    for (int i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+    free(workers);
+}
+
+typedef struct {
+    SimJob *jobs;
+    size_t jobCount;
+    size_t *chunkStart;  // 每個工作第一個區塊的全域編號（前綴和）
+    pthread_mutex_t lock;
+} SimJobBatch;
+
+static void run_job_chunk(void *ctx, size_t chunk)
+{
+    SimJobBatch *batch = ctx;
+
+    // 二分搜尋區塊所屬的工作
+    size_t lo = 0, hi = batch->jobCount;
+    while (hi - lo > 1)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (batch->chunkStart[mid] <= chunk)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    SimJob *job = &batch->jobs[lo];
+    uint64_t first = job->firstGame + (chunk - batch->chunkStart[lo]) * SIM_CHUNK_GAMES;
+    uint64_t last = first + SIM_CHUNK_GAMES;
+    if (last > job->lastGame)
+        last = job->lastGame;
+
+    SimStats local;
+    sim_stats_init(&local);
+    for (uint64_t i = first; i < last; i++)
+    {
+        SimGameResult result;
+        sim_play_game(&job->config, i, &result);
+        sim_stats_add(&local, &result);
+    }
+
+    pthread_mutex_lock(&batch->lock);
+    sim_stats_merge(&job->stats, &local);
+    pthread_mutex_unlock(&batch->lock);
+}
+
+void sim_run_jobs(SimJob *jobs, size_t jobCount, int threads)
+{
+    SimJobBatch batch;
+    batch.jobs = jobs;
+    batch.jobCount = jobCount;
+    batch.chunkStart = malloc((jobCount + 1) * sizeof(size_t));
+    if (batch.chunkStart == NULL)
+    {
+        ERROR_LOG("Out of memory for %zu simulation jobs", jobCount);
+        return;
+    }
+
+    batch.chunkStart[0] = 0;
+    for (size_t i = 0; i < jobCount; i++)
+    {
+        uint64_t games = jobs[i].lastGame > jobs[i].firstGame ? jobs[i].lastGame - jobs[i].firstGame : 0;
+        batch.chunkStart[i + 1] = batch.chunkStart[i] + (size_t)((games + SIM_CHUNK_GAMES - 1) / SIM_CHUNK_GAMES);
+    }
+    pthread_mutex_init(&batch.lock, NULL);
+
+    sim_parallel_for(batch.chunkStart[jobCount], threads, run_job_chunk, &batch);
+
+    pthread_mutex_destroy(&batch.lock);
+    free(batch.chunkStart);
+}
+
+bool sim_save_checkpoint(const char *path, const SimCheckpoint *checkpoint)
+{
+    char tmpPath[1024];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE *fp = fopen(tmpPath, "wb");
+    if (fp == NULL)
+    {
+        ERROR_LOG("Cannot open checkpoint file %s", tmpPath);
+        return false;
+    }
+
+    bool ok = fwrite(checkpoint, sizeof(*checkpoint), 1, fp) == 1;
+    ok = fflush(fp) == 0 && ok;
+    ok = fsync(fileno(fp)) == 0 && ok;
+    ok = fclose(fp) == 0 && ok;
+
+    if (!ok || rename(tmpPath, path) != 0)
+    {
+        ERROR_LOG("Failed to write checkpoint %s", path);
+        remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+bool sim_load_checkpoint(const char *path, SimCheckpoint *checkpoint)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+        return false;
+
+    bool ok = fread(checkpoint, sizeof(*checkpoint), 1, fp) == 1;
+    fclose(fp);
+
+    if (!ok || memcmp(checkpoint->magic, CHECKPOINT_MAGIC, 4) != 0 ||
+        checkpoint->version != CHECKPOINT_VERSION)
+    {
+        ERROR_LOG("Invalid checkpoint file %s", path);
+        return false;
+    }
+    return true;
+}
+
+void sim_init_checkpoint(SimCheckpoint *checkpoint, const SimConfig *config,
+                         uint64_t firstGame, uint64_t lastGame)
+{
+    memset(checkpoint, 0, sizeof(*checkpoint));
+    memcpy(checkpoint->magic, CHECKPOINT_MAGIC, 4);
+    checkpoint->version = CHECKPOINT_VERSION;
+    checkpoint->seed = config->seed;
+    checkpoint->maxTurns = config->maxTurns;
+    checkpoint->fingerprint = config->fingerprint;
+    checkpoint->firstGame = firstGame;
+    checkpoint->lastGame = lastGame;
+    checkpoint->nextGame = firstGame;
+    for (int i = 0; i < 2; i++)
+    {
+        checkpoint->characters[i] = config->characters[i];
+        snprintf(checkpoint->botNames[i], sizeof(checkpoint->botNames[i]), "%s", config->bots[i]->name);
+    }
+    sim_stats_init(&checkpoint->stats);
+}
+
+uint64_t sim_fingerprint_bytes(uint64_t h, const void *data, size_t size)
+{
+    const uint8_t *bytes = data;
+    for (size_t i = 0; i < size; i += 8)
+    {
+        uint64_t word = 0;
+        memcpy(&word, bytes + i, size - i < 8 ? size - i : 8);
+        h = rng_mix64(h ^ word);
+    }
+    return rng_mix64(h ^ size);
+}
+
+bool sim_fingerprint_file(uint64_t *h, const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+        return false;
+
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        *h = sim_fingerprint_bytes(*h, buffer, read);
+    bool ok = !ferror(fp);
+    fclose(fp);
+    return ok;
+}
+
+// 比對除了進度以外的欄位，確認 checkpoint 屬於同一個工作
+static bool same_job(const SimCheckpoint *a, const SimCheckpoint *b)
+{
+    return a->seed == b->seed && a->maxTurns == b->maxTurns && a->fingerprint == b->fingerprint &&
+           a->firstGame == b->firstGame && a->lastGame == b->lastGame &&
+           memcmp(a->characters, b->characters, sizeof(a->characters)) == 0 &&
+           memcmp(a->botNames, b->botNames, sizeof(a->botNames)) == 0;
+}
+
+bool sim_run(const SimConfig *config, uint64_t firstGame, uint64_t lastGame,
+             const char *checkpointPath, uint64_t checkpointEvery, int threads, SimStats *stats)
+{
+    SimCheckpoint progress;
+    sim_init_checkpoint(&progress, config, firstGame, lastGame);
+
+    if (checkpointPath != NULL)
+    {
+        SimCheckpoint saved;
+        if (access(checkpointPath, F_OK) == 0)
+        {
+            if (!sim_load_checkpoint(checkpointPath, &saved) || !same_job(&saved, &progress))
+            {
+                ERROR_LOG("Checkpoint %s does not match this job", checkpointPath);
+                return false;
+            }
+            progress = saved;
+            INFO_LOG("Resuming from game %llu", (unsigned long long)progress.nextGame);
+        }
+    }
+
+    if (checkpointEvery == 0)
+        checkpointEvery = lastGame - firstGame;
+
+    while (progress.nextGame < lastGame)
+    {
+        uint64_t end = progress.nextGame + checkpointEvery;
+        if (end > lastGame)
+            end = lastGame;
+
+        SimJob job;
+        job.config = *config;
+        job.firstGame = progress.nextGame;
+        job.lastGame = end;
+        sim_stats_init(&job.stats);
+        sim_run_jobs(&job, 1, threads);
+
+        sim_stats_merge(&progress.stats, &job.stats);
+        progress.nextGame = end;
+
+        if (checkpointPath != NULL && !sim_save_checkpoint(checkpointPath, &progress))
+            return false;
+    }
+
+    sim_stats_merge(stats, &progress.stats);
+    return true;
+}
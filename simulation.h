@@ -0,0 +1,114 @@
+#ifndef _SIMULATION_H
+#define _SIMULATION_H
+
+#include "architecture.h"
+#include "bot.h"
+#include "card_system.h"
+#include "rng.h"
+
+// 每個選擇套用前呼叫的觀察函數（輸出訓練資料等），choices 為這次的合法選擇
+typedef void (*SimChoiceFn)(void* ctx, game* gameState, vector* choices, int32_t choice);
+
+// 模擬設定
+typedef struct {
+    uint8_t characters[2];      // 先手、後手角色（CharacterID）
+    const BotPolicy* bots[2];   // 先手、後手策略
+    uint64_t seed;              // 主種子，第 i 場使用 (seed, i) 的亂數串流
+    uint32_t maxTurns;          // 超過回合數視為平手
+    int32_t bannedCard[2];      // 各座位禁用的卡牌（不在起始牌堆、不能購買），0 為不禁用
+    bool trackCardUses;         // 是否統計每張卡牌的使用次數
+    SimChoiceFn onChoice;       // NULL 表示不使用；多執行緒模擬時每場遊戲應使用各自的 ctx
+    void* onChoiceCtx;
+    // 不在本結構中但影響結果的設定（評估權重、神經網路、開局庫、卡牌數值、搜尋設定、外掛）的指紋
+    // 由呼叫端以 sim_fingerprint_* 計算，記錄在 checkpoint 中，不同時拒絕接續
+    uint64_t fingerprint;
+} SimConfig;
+
+// 單場結果
+typedef struct {
+    int8_t winner;     // 0/1，平手為 -1
+    uint32_t turns;    // 回合數
+    uint32_t choices;  // 做出的選擇總數
+    uint16_t cardUses[2][CARD_ID_COUNT];  // 各座位打出每張卡牌的次數（trackCardUses 時有效）
+} SimGameResult;
+
+// 累計統計（只含整數，合併順序不影響結果）
+typedef struct {
+    uint64_t games;
+    uint64_t wins[2];
+    uint64_t draws;
+    uint64_t totalTurns;
+    uint64_t totalChoices;
+} SimStats;
+
+// Checkpoint 檔案內容
+// 每場遊戲的亂數串流只由 (seed, 遊戲編號) 決定，因此 nextGame 就是亂數串流的位置
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint64_t seed;
+    uint8_t characters[2];
+    char botNames[2][32];
+    uint32_t maxTurns;
+    uint64_t fingerprint;  // SimConfig.fingerprint
+    uint64_t firstGame;
+    uint64_t lastGame;
+    uint64_t nextGame;  // 已完成範圍為 [firstGame, nextGame)
+    SimStats stats;
+} SimCheckpoint;
+
+// 一批模擬工作：以 config 執行遊戲編號 [firstGame, lastGame)，結果累計到 stats
+typedef struct {
+    SimConfig config;
+    uint64_t firstGame;
+    uint64_t lastGame;
+    SimStats stats;
+} SimJob;
+
+#define SIM_DEFAULT_MAX_TURNS 200
+
+// 每個執行緒一次領取的遊戲數
+#define SIM_CHUNK_GAMES 64
+
+// 初始化模擬設定（預設小紅帽對白雪公主、random 對 random）
+void sim_init_config(SimConfig* config);
+
+// 以第 gameIndex 個亂數串流進行一場完整對戰
+void sim_play_game(const SimConfig* config, uint64_t gameIndex, SimGameResult* result);
+
+// 統計
+void sim_stats_init(SimStats* stats);
+void sim_stats_add(SimStats* stats, const SimGameResult* result);
+void sim_stats_merge(SimStats* stats, const SimStats* other);
+
+// 建立一份尚未開始的 checkpoint（已完成範圍為空）
+void sim_init_checkpoint(SimCheckpoint* checkpoint, const SimConfig* config,
+                         uint64_t firstGame, uint64_t lastGame);
+
+// 設定指紋：把一段資料或整個檔案的內容混入 h；檔案無法讀取時回傳 false
+uint64_t sim_fingerprint_bytes(uint64_t h, const void* data, size_t size);
+bool sim_fingerprint_file(uint64_t* h, const char* path);
+
+// 取得可用的CPU核心數
+int sim_default_threads(void);
+
+// 平行執行 taskCount 個互相獨立的任務（threads 為 0 時使用全部核心）
+// 任務編號依序分配，task 需自行處理結果合併的同步
+typedef void (*SimTaskFn)(void* ctx, size_t taskIndex);
+void sim_parallel_for(size_t taskCount, int threads, SimTaskFn task, void* ctx);
+
+// 以多個執行緒執行一批工作（threads 為 0 時使用全部核心）
+// 每個執行緒只保留目前區塊的統計，記憶體用量與遊戲數無關
+void sim_run_jobs(SimJob* jobs, size_t jobCount, int threads);
+
+// Checkpoint 讀寫（寫入時先寫暫存檔再改名，中斷也不會留下損壞的檔案）
+bool sim_save_checkpoint(const char* path, const SimCheckpoint* checkpoint);
+bool sim_load_checkpoint(const char* path, SimCheckpoint* checkpoint);
+
+// 執行遊戲編號 [firstGame, lastGame) 的模擬並累計到 stats
+// checkpointPath 不為 NULL 時每 checkpointEvery 場保存一次進度；
+// 若檔案已存在且設定相符，則從上次中斷的地方繼續，結果與不中斷執行完全相同
+bool sim_run(const SimConfig* config, uint64_t firstGame, uint64_t lastGame,
+             const char* checkpointPath, uint64_t checkpointEvery, int threads, SimStats* stats);
+
+#endif // _SIMULATION_H
@@ -1,5 +1,8 @@
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include "test_system.h"
 #include "debug_log.h"
 
@@ -119,6 +122,22 @@ void test_card_system(void)
     assert_true("攻擊牌組初始化",
                 gameState.basicBuyDeck[0][0].SIZE > 0);
 
+    // 供應牌庫只含卡牌ID 1~10，數值來自 card_spec.tsv（LV3 攻擊牌為 3）
+    bool supplyIds = true;
+    for (int type = 0; type < 4; type++)
+    {
+        for (int level = 0; level < 3; level++)
+        {
+            vector *supply = &gameState.basicBuyDeck[type][level];
+            for (uint32_t i = 0; i < supply->SIZE; i++)
+                supplyIds = supplyIds && supply->array[i] >= 1 && supply->array[i] <= 10 &&
+                            get_card_kind(supply->array[i]) == CARD_KIND_BASIC &&
+                            (int)get_card_level(supply->array[i]) == level;
+        }
+    }
+    assert_true("供應牌庫使用卡牌資料表", supplyIds && gameState.basicBuyDeck[0][2].SIZE == 18 &&
+                                              get_card_value(gameState.basicBuyDeck[0][2].array[0]) == 3);
+
     // 初始化角色來設置牌組
     init_character(&gameState, 0, CHAR_RED_HOOD);
 
@@ -133,6 +152,19 @@ void test_card_system(void)
     use_card(&gameState, card_id);
     assert_true("使用卡牌後進入出牌區",
                 findVector(&p->usecards, card_id) != -1);
+
+    // 卡牌資料表與 card_num_spec.md 一致：技能依攻/防/移各3張，數值等於等級
+    assert_true("技能牌類型", get_card_type(11) == CARD_TYPE_SKILL_ATK && get_card_type(13) == CARD_TYPE_SKILL_ATK &&
+                                  get_card_type(14) == CARD_TYPE_SKILL_DEF && get_card_type(19) == CARD_TYPE_SKILL_MOV &&
+                                  get_card_kind(20) == CARD_KIND_ULTIMATE && get_card_kind(0) == CARD_KIND_NONE);
+    assert_true("卡牌等級與數值", get_card_level(13) == CARD_LEVEL_3 && get_card_value(13) == 3 &&
+                                      get_card_value(3) == 3 && get_card_value(10) == 1 &&
+                                      get_card_level(115) == CARD_LEVEL_3 && get_card_value(131) == 0);
+    assert_true("中毒與火柴所屬角色", get_card_kind(131) == CARD_KIND_TOKEN && get_card_character(133) == 1 &&
+                                          get_card_character(134) == 7 && get_card_character(168) == 7 &&
+                                          get_card_kind(176) == CARD_KIND_METAMORPHOSIS);
+    assert_true("卡牌名稱", strcmp(get_card_name(24), "水晶漩渦") == 0 &&
+                                strcmp(get_card_name(CARD_ID_MAX + 1), "Card_177") == 0);
 }
 
 void test_character_system(void)
@@ -197,6 +229,1258 @@ void test_battle_system(void)
                 is_in_range(&gameState, 0, 1, 2));
 }
 
+void test_simulation(void)
+{
+    printf("\n=== 測試模擬系統 ===\n");
+
+    game gameState;
+    vector choices;
+    init_duel(&gameState, CHAR_RED_HOOD, CHAR_SNOW_WHITE);
+    get_legal_choices(&gameState, &choices);
+    assert_true("開局可以結束回合", findVector(&choices, 10) != -1);
+    assert_true("非法選擇被拒絕", !apply_choice(&gameState, 7));
+    assert_true("結束回合", apply_choice(&gameState, 10));
+    assert_equal_int("結束回合後換人", 1, gameState.now_turn_player_id);
+    assert_equal_int("結束回合抽六張", 6, gameState.players[0].hand.SIZE);
+
+    SimConfig config;
+    sim_init_config(&config);
+    config.bots[0] = find_bot_policy("greedy");
+
+    // 同一個種子的結果可以重現
+    SimGameResult first, second;
+    sim_play_game(&config, 7, &first);
+    sim_play_game(&config, 7, &second);
+    assert_true("同種子結果相同", first.winner == second.winner && first.choices == second.choices);
+
+    // 不中斷執行 [0,20)
+    SimStats full;
+    sim_stats_init(&full);
+    sim_run(&config, 0, 20, NULL, 0, 1, &full);
+
+    // 模擬在第10場中斷後留下的 checkpoint，再從檔案繼續
+    const char *path = "test_sim.ckpt";
+    SimCheckpoint checkpoint;
+    sim_init_checkpoint(&checkpoint, &config, 0, 20);
+    sim_run(&config, 0, 10, NULL, 0, 1, &checkpoint.stats);
+    checkpoint.nextGame = 10;
+    sim_save_checkpoint(path, &checkpoint);
+
+    SimStats resumed;
+    sim_stats_init(&resumed);
+    assert_true("從checkpoint繼續", sim_run(&config, 0, 20, path, 5, 4, &resumed));
+    assert_true("中斷後結果與不中斷相同", memcmp(&full, &resumed, sizeof(SimStats)) == 0);
+
+    // 多執行緒與單執行緒結果相同
+    SimJob jobs[2];
+    for (int t = 0; t < 2; t++)
+    {
+        jobs[t].config = config;
+        jobs[t].firstGame = 0;
+        jobs[t].lastGame = 150;
+        sim_stats_init(&jobs[t].stats);
+        sim_run_jobs(&jobs[t], 1, t == 0 ? 1 : 3);
+    }
+    assert_true("多執行緒結果相同", memcmp(&jobs[0].stats, &jobs[1].stats, sizeof(SimStats)) == 0);
+
+    double low, high;
+    wilson_interval(50, 100, &low, &high);
+    assert_true("Wilson信賴區間", low < 0.5 && high > 0.5 && low > 0.39 && high < 0.61);
+
+    // 設定不同的工作不能使用同一個 checkpoint（包含權重、卡牌數值等只記錄在指紋中的設定）
+    config.fingerprint = sim_fingerprint_bytes(0, "weights", 7);
+    bool fingerprintRejected = !sim_run(&config, 0, 20, path, 5, 1, &resumed);
+    config.fingerprint = 0;
+    config.seed++;
+    assert_true("拒絕不相符的checkpoint", fingerprintRejected && !sim_run(&config, 0, 20, path, 5, 1, &resumed));
+    EvalWeights fingerprintWeights;
+    init_eval_weights(&fingerprintWeights);
+    uint64_t defaultSettings = bot_settings_fingerprint();
+    fingerprintWeights.life++;
+    set_bot_eval_weights(&fingerprintWeights);
+    uint64_t changedSettings = bot_settings_fingerprint();
+    set_bot_eval_weights(NULL);
+    assert_true("策略設定指紋", changedSettings != defaultSettings && bot_settings_fingerprint() == defaultSettings);
+    remove(path);
+
+    // 禁用卡牌：統計使用次數時不會出現被禁用的牌
+    sim_init_config(&config);
+    config.bots[0] = find_bot_policy("greedy");
+    config.bannedCard[0] = 1;
+    config.trackCardUses = true;
+    bool bannedUnused = true;
+    for (uint64_t i = 0; i < 10; i++)
+    {
+        sim_play_game(&config, i, &first);
+        bannedUnused = bannedUnused && first.cardUses[0][1] == 0;
+    }
+    assert_true("禁用的卡牌不會被打出", bannedUnused);
+
+    // 卡牌影響力分析與執行緒數無關
+    CardImpactConfig impactConfig;
+    init_card_impact_config(&impactConfig);
+    impactConfig.gamesPerCard = 4;
+    CardImpact *impacts[2];
+    for (int t = 0; t < 2; t++)
+    {
+        impactConfig.threads = t == 0 ? 1 : 3;
+        impacts[t] = calloc(CARD_ID_MAX, sizeof(CardImpact));
+        run_card_impact(&impactConfig, impacts[t]);
+    }
+    assert_true("卡牌影響力結果相同", memcmp(impacts[0], impacts[1], CARD_ID_MAX * sizeof(CardImpact)) == 0);
+    assert_equal_int("卡牌影響力的卡牌ID", 41, impacts[0][40].cardId);
+    assert_equal_int("卡牌所屬角色", CHAR_SLEEPING, impacts[0][40].character);
+    assert_true("必殺牌與蛻變牌不分析", impacts[0][40].applicable && impacts[0][0].applicable &&
+                                            !impacts[0][19].applicable && impacts[0][19].games == 0 &&
+                                            !impacts[0][CARD_ID_MAX - 1].applicable);
+    rank_card_impacts(impacts[0], CARD_ID_MAX);
+    size_t applicableCount = 0;
+    while (applicableCount < CARD_ID_MAX && impacts[0][applicableCount].applicable)
+        applicableCount++;
+    bool notApplicableLast = true;
+    for (size_t i = applicableCount; i < CARD_ID_MAX; i++)
+        notApplicableLast = notApplicableLast && !impacts[0][i].applicable;
+    assert_true("依影響力排序", applicableCount > 0 && notApplicableLast &&
+                                    impacts[0][0].impact >= impacts[0][applicableCount - 1].impact);
+    free(impacts[0]);
+    free(impacts[1]);
+}
+
+void test_tournament(void)
+{
+    printf("\n=== 測試錦標賽 ===\n");
+
+    // SPRT：明顯的勝負差會接受對應的假設
+    TournamentConfig tourConfig;
+    init_tournament_config(&tourConfig);
+    assert_true("SPRT接受H1", sprt_status(&tourConfig.sprt, sprt_llr(&tourConfig.sprt, 700, 0, 300)) == SPRT_ACCEPT_H1);
+    assert_true("SPRT接受H0", sprt_status(&tourConfig.sprt, sprt_llr(&tourConfig.sprt, 300, 0, 700)) == SPRT_ACCEPT_H0);
+    assert_true("SPRT尚未決定", sprt_status(&tourConfig.sprt, sprt_llr(&tourConfig.sprt, 5, 0, 5)) == SPRT_CONTINUE);
+
+    // 勝負明顯的配對在第一批後就停止，且結果與執行緒數無關
+    tourConfig.bots[0] = find_bot_policy("greedy");
+    tourConfig.bots[1] = find_bot_policy("random");
+    tourConfig.botCount = 2;
+    TournamentResult *tours[2];
+    for (int t = 0; t < 2; t++)
+    {
+        tourConfig.threads = t == 0 ? 1 : 3;
+        tours[t] = malloc(sizeof(TournamentResult));
+        run_tournament(&tourConfig, tours[t]);
+    }
+    assert_equal_int("SPRT提早停止", (int)tourConfig.batchGames, (int)tours[0]->totalGames);
+    assert_true("錦標賽結果與執行緒數無關", tours[0]->pairings[0].wins == tours[1]->pairings[0].wins &&
+                                                   tours[0]->totalGames == tours[1]->totalGames);
+    assert_true("Elo排名", tours[0]->ratings[0] > tours[0]->ratings[1]);
+    free(tours[0]);
+    free(tours[1]);
+}
+
+// 對手只剩一點生命且在射程內，目前玩家手上有一張攻擊牌
+static void setup_winning_attack(game *gs)
+{
+    init_duel(gs, CHAR_RED_HOOD, CHAR_SNOW_WHITE);
+    gs->players[1].life = 1;
+    gs->players[1].defense = 0;
+    gs->players[1].locate[0] = gs->players[0].locate[0] + 1;
+    vector_pushback(&gs->players[0].hand, 1);
+}
+
+// 以固定亂數隨機進行至多 80 個選擇，得到對局中途的局面
+static void play_random_choices(game *gs, uint64_t seed)
+{
+    RngState rng;
+    vector choices;
+    rng_seed(&rng, seed, 0);
+    rng_set_active(&rng);
+    init_duel(gs, 2, 5);
+    for (int i = 0; i < 80 && get_winner(gs) < 0; i++)
+    {
+        get_legal_choices(gs, &choices);
+        if (choices.SIZE == 0)
+            break;
+        apply_choice(gs, choices.array[rng_bounded(&rng, choices.SIZE)]);
+    }
+    rng_set_active(NULL);
+}
+
+void test_search(void)
+{
+    printf("\n=== 測試搜尋 ===\n");
+
+    // 對手只剩一點生命時會找到致勝的攻擊，且不改變局面
+    game gameState;
+    vector choices;
+    setup_winning_attack(&gameState);
+    game before = gameState;
+
+    SearchConfig searchConfig;
+    init_search_config(&searchConfig);
+    SearchResult searchResult;
+    RngState searchRng;
+    rng_seed(&searchRng, 5, 0);
+    get_legal_choices(&gameState, &choices);
+    search_choose(&searchConfig, &gameState, &choices, &searchRng, &searchResult);
+    assert_equal_int("搜尋找到致勝攻擊", 1, searchResult.bestChoice);
+    assert_true("搜尋判斷為勝局", searchResult.score > SEARCH_WIN_SCORE - 10);
+    assert_true("搜尋不改變局面", memcmp(&before, &gameState, sizeof(game)) == 0);
+}
+
+void test_game_hash(void)
+{
+    printf("\n=== 測試局面雜湊 ===\n");
+
+    game gameState;
+    setup_winning_attack(&gameState);
+    game moved = gameState;
+    assert_true("相同局面雜湊相同", hash_game(&moved) == hash_game(&gameState));
+    apply_choice(&moved, 1);
+    assert_true("不同局面雜湊不同", hash_game(&moved) != hash_game(&gameState));
+
+    // 雜湊與編碼只依賴初始化過的欄位：記憶體內容不同的 game 以同一個種子開局，結果相同
+    game *initGames = malloc(2 * sizeof(game));
+    uint8_t *initBytes = malloc(2 * GAME_CODEC_MAX_BYTES);
+    if (initGames != NULL && initBytes != NULL)
+    {
+        RngState hashRng;
+        RngState *previousRng = rng_get_active();
+        rng_set_active(&hashRng);
+        for (int i = 0; i < 2; i++)
+        {
+            memset(&initGames[i], i == 0 ? 0x00 : 0x55, sizeof(game));
+            rng_seed(&hashRng, 7, 0);
+            init_duel(&initGames[i], 0, 0);
+        }
+        rng_set_active(previousRng);
+        size_t initSize = encode_game(&initGames[0], initBytes, GAME_CODEC_MAX_BYTES);
+        assert_true("未清除的記憶體不影響開局雜湊",
+                    hash_game(&initGames[0]) == hash_game(&initGames[1]) && initSize > 0 &&
+                        encode_game(&initGames[1], initBytes + GAME_CODEC_MAX_BYTES, GAME_CODEC_MAX_BYTES) == initSize &&
+                        memcmp(initBytes, initBytes + GAME_CODEC_MAX_BYTES, initSize) == 0);
+    }
+    free(initGames);
+    free(initBytes);
+
+    // 標準形式：手牌、棄牌堆順序不同的局面雜湊相同，牌堆順序不同則不同
+    moved = gameState;
+    vector_pushback(&moved.players[0].graveyard, 2);
+    vector_pushback(&moved.players[0].graveyard, 7);
+    game reordered = moved;
+    reordered.players[0].graveyard.array[reordered.players[0].graveyard.SIZE - 1] = 2;
+    reordered.players[0].graveyard.array[reordered.players[0].graveyard.SIZE - 2] = 7;
+    assert_true("順序不同的棄牌堆雜湊相同", hash_game(&moved) == hash_game(&reordered));
+    moved = gameState;
+    vector_pushback(&moved.players[0].hand, 3);
+    vector_pushback(&moved.players[0].hand, 5);
+    reordered = gameState;
+    vector_pushback(&reordered.players[0].hand, 5);
+    vector_pushback(&reordered.players[0].hand, 3);
+    assert_true("順序不同的手牌雜湊相同", hash_game(&moved) == hash_game(&reordered));
+    uint64_t beforeCanonical = hash_game(&reordered);
+    canonicalize_game(&reordered);
+    assert_true("標準形式雜湊不變", hash_game(&reordered) == beforeCanonical);
+    canonicalize_game(&moved);
+    assert_true("標準形式相同", memcmp(moved.players[0].hand.array, reordered.players[0].hand.array,
+                                      moved.players[0].hand.SIZE * sizeof(int32_t)) == 0);
+    moved = gameState;
+    vector *deck = &moved.players[0].deck;
+    int32_t topCard = deck->array[deck->SIZE - 1];
+    deck->array[deck->SIZE - 1] = 1000;
+    deck->array[0] = topCard;
+    assert_true("牌堆順序不同雜湊不同", hash_game(&moved) != hash_game(&gameState));
+    deck->array[0] = deck->array[deck->SIZE - 1];
+    deck->array[deck->SIZE - 1] = topCard;
+    moved.players[0].deck.array[1] = gameState.players[0].deck.array[0];
+    moved.players[0].deck.array[0] = gameState.players[0].deck.array[1];
+    assert_true("可觀察局面不計牌堆順序", hash_observation(&moved) == hash_observation(&gameState));
+}
+
+// 多執行緒同時讀寫同一個很小的置換表，命中的資料必須和雜湊一致
+typedef struct {
+    TranspositionTable *table;
+    atomic_int corrupted;
+} TableStressContext;
+
+static void table_stress_task(void *ctx, size_t taskIndex)
+{
+    TableStressContext *stress = ctx;
+    for (uint64_t i = 0; i < 20000; i++)
+    {
+        uint64_t hash = rng_mix64(taskIndex * 20000 + i % 64);
+        tt_store(stress->table, hash, (int32_t)(hash >> 40), (int)(hash & 0x3F), TT_BOUND_EXACT, (int32_t)(hash & 0xFF));
+        TTEntryInfo info;
+        if (tt_probe(stress->table, hash, &info) &&
+            (info.value != (int32_t)(hash >> 40) || info.bestChoice != (int32_t)(hash & 0xFF)))
+            atomic_fetch_add(&stress->corrupted, 1);
+    }
+}
+
+void test_transposition(void)
+{
+    printf("\n=== 測試置換表 ===\n");
+
+    TranspositionTable table;
+    TTEntryInfo info;
+    tt_init(&table, 1);
+    tt_store(&table, 12345, -777, 5, TT_BOUND_LOWER, -3);
+    assert_true("置換表讀回", tt_probe(&table, 12345, &info) && info.value == -777 && info.depth == 5 &&
+                                  info.bound == TT_BOUND_LOWER && info.bestChoice == -3);
+    tt_store(&table, 12345, 10, 2, TT_BOUND_UPPER, 1);
+    tt_probe(&table, 12345, &info);
+    assert_equal_int("保留較深的資料", 5, info.depth);
+    tt_new_search(&table);
+    tt_store(&table, 12345, 10, 2, TT_BOUND_UPPER, 1);
+    tt_probe(&table, 12345, &info);
+    assert_equal_int("舊世代的資料被取代", 2, info.depth);
+    assert_true("未存入的局面不命中", !tt_probe(&table, 54321, &info));
+
+    game gameState;
+    vector choices;
+    SearchConfig searchConfig;
+    SearchResult searchResult;
+    RngState searchRng;
+    setup_winning_attack(&gameState);
+    get_legal_choices(&gameState, &choices);
+    init_search_config(&searchConfig);
+    searchConfig.table = &table;
+    rng_seed(&searchRng, 5, 0);
+    search_choose(&searchConfig, &gameState, &choices, &searchRng, &searchResult);
+    assert_equal_int("使用置換表的搜尋找到致勝攻擊", 1, searchResult.bestChoice);
+    tt_free(&table);
+
+    // 只有一個 bucket，所有執行緒都寫同一條 cache line
+    tt_init(&table, 0);
+    TableStressContext stress;
+    stress.table = &table;
+    atomic_init(&stress.corrupted, 0);
+    sim_parallel_for(4, 4, table_stress_task, &stress);
+    assert_equal_int("多執行緒寫入置換表沒有損壞的資料", 0, atomic_load(&stress.corrupted));
+    tt_free(&table);
+}
+
+void test_opening_book(void)
+{
+    printf("\n=== 測試開局庫 ===\n");
+
+    // 產生極小的庫，再以相同亂數重現第一個配對的開局查詢
+    game gameState;
+    vector choices;
+    BookConfig bookConfig;
+    init_book_config(&bookConfig);
+    bookConfig.gamesPerMatchup = 1;
+    bookConfig.bookTurns = 1;
+    bookConfig.search.maxDepth = 1;
+    bookConfig.search.nodeLimit = 50;
+    uint64_t bookEntries = 0;
+    // 任務也會在呼叫端的執行緒執行，結束後要還原呼叫端的亂數
+    RngState callerRng;
+    rng_seed(&callerRng, 1, 0);
+    RngState *previousRng = rng_get_active();
+    rng_set_active(&callerRng);
+    bool generated = generate_opening_book(&bookConfig, "test_book.bin", &bookEntries);
+    assert_true("產生開局庫", generated && bookEntries > 0 && rng_get_active() == &callerRng);
+    OpeningBook book;
+    assert_true("開啟開局庫", book_open(&book, "test_book.bin"));
+    // 以清除過的記憶體開局，命中不能依賴未初始化的欄位
+    RngState bookRng;
+    rng_seed(&bookRng, rng_mix64(bookConfig.seed), 0);
+    rng_set_active(&bookRng);
+    memset(&gameState, 0, sizeof(gameState));
+    init_duel(&gameState, 0, 0);
+    rng_set_active(previousRng);
+    get_legal_choices(&gameState, &choices);
+    int32_t bookChoice = 0;
+    assert_true("開局庫命中且選擇合法",
+                book_lookup(&book, &gameState, &choices, &bookChoice) && findVector(&choices, bookChoice) >= 0);
+    gameState.players[0].life = 1;
+    assert_true("未收錄的局面不命中", !book_lookup(&book, &gameState, &choices, &bookChoice));
+    book_close(&book);
+    remove("test_book.bin");
+}
+
+void test_ponder(void)
+{
+    printf("\n=== 測試預先搜尋 ===\n");
+
+    // 對手結束回合後命中預想，亂數狀態與直接搜尋相同
+    game gameState;
+    vector choices;
+    SearchConfig searchConfig;
+    SearchResult searchResult;
+    RngState gameRng;
+    RngState botRng;
+    rng_seed(&gameRng, 11, 0);
+    rng_seed(&botRng, 11, 1);
+    rng_set_active(&gameRng);
+    init_duel(&gameState, CHAR_RED_HOOD, CHAR_SNOW_WHITE);
+    rng_set_active(NULL);
+    init_search_config(&searchConfig);
+    Ponderer *ponder = malloc(sizeof(Ponderer));
+    assert_true("建立預先搜尋", ponder != NULL && ponder_init(ponder, &searchConfig, 1, 1));
+    ponder_start(ponder, &gameState, &gameRng, &botRng);
+    assert_true("預想會換到電腦的對手選擇", ponder->entryCount > 0);
+    int32_t reply = ponder->entries[0].reply;
+    game afterReply = gameState;
+    rng_set_active(&gameRng);
+    apply_choice(&afterReply, reply);
+    rng_set_active(NULL);
+    get_legal_choices(&afterReply, &choices);
+    RngState freshRng = botRng;
+    search_choose(&searchConfig, &afterReply, &choices, &freshRng, &searchResult);
+    bool ponderHit = false;
+    int32_t ponderChoice = ponder_choose(ponder, &afterReply, &choices, &botRng, &searchResult, &ponderHit);
+    assert_true("命中預想", ponderHit && findVector(&choices, ponderChoice) >= 0);
+    assert_true("命中後亂數與直接搜尋相同", botRng.state == freshRng.state && botRng.inc == freshRng.inc);
+    ponder_start(ponder, &gameState, &gameRng, &botRng);
+    afterReply.players[0].life--;
+    ponder_choose(ponder, &afterReply, &choices, &botRng, &searchResult, &ponderHit);
+    assert_true("局面不同時不命中", !ponderHit && ponder->misses == 1);
+    ponder_free(ponder);
+    free(ponder);
+}
+
+void test_game_features(void)
+{
+    printf("\n=== 測試局面特徵 ===\n");
+
+    game gameState;
+    RngState gameRng;
+    rng_seed(&gameRng, 11, 0);
+    rng_set_active(&gameRng);
+    init_duel(&gameState, CHAR_MULAN, CHAR_DOROTHY);
+    rng_set_active(NULL);
+    gameState.players[0].mulan.KI_TOKEN = 3;
+    static int8_t packedFeatures[2][FEATURE_COUNT];
+    static float floatFeatures[2][FEATURE_COUNT];
+    extract_features_int8(&gameState, 0, packedFeatures[0]);
+    extract_features(&gameState, 0, floatFeatures[0]);
+    int handCount = 0;
+    for (int32_t cardId = 0; cardId < CARD_ID_COUNT; cardId++)
+        handCount += packedFeatures[0][FEATURE_PILE_INDEX(0, FEAT_PILE_HAND, cardId)];
+    assert_equal_int("手牌張數特徵", (int)gameState.players[0].hand.SIZE, handCount);
+    assert_equal_int("生命特徵", gameState.players[0].life, packedFeatures[0][FEAT_LIFE]);
+    assert_equal_int("氣特徵", 3, packedFeatures[0][FEAT_KI_TOKEN]);
+    assert_equal_int("角色特徵", 1, packedFeatures[0][FEATURE_PLAYER_SIZE + FEATURE_CHARACTER_OFFSET + CHAR_DOROTHY]);
+    bool sameFeatures = true;
+    for (int i = 0; i < FEATURE_COUNT; i++)
+        sameFeatures = sameFeatures && floatFeatures[0][i] == (float)packedFeatures[0][i];
+    assert_true("float 與 int8 特徵一致", sameFeatures);
+    extract_features_int8(&gameState, 1, packedFeatures[1]);
+    assert_true("視角交換玩家區塊", memcmp(packedFeatures[0], packedFeatures[1] + FEATURE_PLAYER_SIZE,
+                                          FEATURE_PLAYER_SIZE) == 0);
+    game *featureGames = malloc(2 * sizeof(game));
+    featureGames[0] = gameState;
+    featureGames[1] = gameState;
+    int8_t perspectives[2] = {0, 1};
+    extract_features_batch(featureGames, 2, perspectives, floatFeatures[0]);
+    assert_true("批次擷取與單一擷取相同", floatFeatures[1][FEAT_KI_TOKEN] == 0.0f &&
+                                              floatFeatures[1][FEATURE_PLAYER_SIZE + FEAT_KI_TOKEN] == 3.0f &&
+                                              floatFeatures[0][FEAT_KI_TOKEN] == 3.0f);
+    free(featureGames);
+}
+
+void test_rl_env(void)
+{
+    printf("\n=== 測試強化學習環境 ===\n");
+
+    // 批次強化學習環境
+    RlEnvConfig envConfig;
+    rl_env_init_config(&envConfig);
+    envConfig.batchSize = 4;
+    envConfig.opponent = find_bot_policy("greedy");
+    envConfig.agentSeat = 0;
+    RlEnv envs[2];
+    assert_true("建立批次環境", rl_env_create(&envs[0], &envConfig) && rl_env_create(&envs[1], &envConfig));
+    rl_env_reset(&envs[0], 7);
+    rl_env_reset(&envs[1], 7);
+    bool agentToPlay = true;
+    for (uint32_t b = 0; b < envConfig.batchSize; b++)
+        agentToPlay = agentToPlay && envs[0].toPlay[b] == 0;
+    assert_true("重新開始後輪到呼叫端", agentToPlay);
+    int32_t envActions[4];
+    uint32_t invalidActions = 0;
+    uint32_t finished = 0;
+    bool rewardsValid = true;
+    for (int step = 0; step < 2000 && finished == 0; step++)
+    {
+        // 選第一個合法動作
+        for (uint32_t b = 0; b < envConfig.batchSize; b++)
+        {
+            const uint8_t *mask = envs[0].legalMasks + b * RL_ACTION_COUNT;
+            envActions[b] = 0;
+            while (envActions[b] < RL_ACTION_COUNT - 1 && !mask[envActions[b]])
+                envActions[b]++;
+        }
+        invalidActions += rl_env_step(&envs[0], envActions);
+        rl_env_step(&envs[1], envActions);
+        for (uint32_t b = 0; b < envConfig.batchSize; b++)
+        {
+            finished += envs[0].dones[b];
+            rewardsValid = rewardsValid && (envs[0].dones[b] || envs[0].rewards[b] == 0.0f);
+        }
+    }
+    assert_true("依遮罩選擇的動作都合法", invalidActions == 0);
+    assert_true("環境會結束對局並給予獎勵", finished > 0 && rewardsValid);
+    assert_true("相同種子的環境結果相同",
+                memcmp(envs[0].observations, envs[1].observations,
+                       envConfig.batchSize * RL_OBS_SIZE * sizeof(float)) == 0);
+    for (uint32_t b = 0; b < envConfig.batchSize; b++)
+        envActions[b] = 0;
+    assert_equal_int("不合法的動作被計數", (int)envConfig.batchSize, (int)rl_env_step(&envs[0], envActions));
+    rl_env_destroy(&envs[0]);
+    rl_env_destroy(&envs[1]);
+}
+
+void test_shm_ring(void)
+{
+    printf("\n=== 測試共享記憶體緩衝區 ===\n");
+
+    // 共享記憶體環形緩衝區：以名稱開啟的另一端看到同一份資料
+    char ringName[64];
+    snprintf(ringName, sizeof(ringName), "/twisted_test_ring_%ld", (long)getpid());
+    ShmRing producer;
+    ShmRing consumer;
+    assert_true("建立共享記憶體緩衝區", shm_ring_create(&producer, ringName, 2, 8));
+    assert_true("以名稱開啟緩衝區", shm_ring_open(&consumer, ringName));
+    assert_true("空的緩衝區沒有資料", shm_ring_peek(&consumer) == NULL);
+    for (uint64_t i = 0; i < 2; i++)
+    {
+        uint64_t *slot = shm_ring_reserve(&producer);
+        *slot = 100 + i;
+        shm_ring_commit(&producer);
+    }
+    assert_true("滿了無法寫入", shm_ring_reserve(&producer) == NULL);
+    const uint64_t *readSlot = shm_ring_peek(&consumer);
+    assert_true("依序讀到資料", readSlot != NULL && *readSlot == 100);
+    shm_ring_release(&consumer);
+    assert_true("釋放後可以再寫入", shm_ring_reserve(&producer) != NULL);
+    shm_ring_finish(&producer);
+    assert_true("還有資料時未讀完", !shm_ring_drained(&consumer));
+    readSlot = shm_ring_peek_wait(&consumer);
+    assert_true("讀到第二筆", readSlot != NULL && *readSlot == 101);
+    shm_ring_release(&consumer);
+    assert_true("結束後讀完", shm_ring_peek_wait(&consumer) == NULL && shm_ring_drained(&consumer));
+    shm_ring_close(&consumer);
+    shm_ring_close(&producer);
+    assert_true("建立者關閉後名稱移除", !shm_ring_open(&consumer, ringName));
+}
+
+void test_dataset(void)
+{
+    printf("\n=== 測試資料集 ===\n");
+
+    // 欄式資料集：寫入後讀回，壓縮過的欄解壓縮後與原始資料相同
+    DatasetConfig dataConfig;
+    init_dataset_config(&dataConfig);
+    dataConfig.games = 3;
+    dataConfig.chunkRows = 64;
+    dataConfig.threads = 1;
+    uint64_t dataRows = 0;
+    assert_true("產生資料集", generate_dataset(&dataConfig, "test_dataset.bin", &dataRows) && dataRows > 0);
+    DatasetReader dataReader;
+    assert_true("開啟資料集", dataset_open(&dataReader, "test_dataset.bin"));
+    assert_true("資料集列數一致", dataReader.header->rowCount == dataRows &&
+                                      dataReader.header->chunkCount == (dataRows + 63) / 64);
+    int8_t *dataFeatures = malloc(64 * FEATURE_COUNT);
+    uint8_t dataMasks[64 * DATASET_MASK_BYTES];
+    int16_t dataActions[64];
+    int8_t dataOutcomes[64];
+    uint64_t dataGames[64];
+    bool columnsRead = dataFeatures != NULL;
+    bool actionsLegal = true;
+    bool outcomesValid = true;
+    uint64_t lastGame = 0;
+    for (uint64_t chunk = 0; columnsRead && chunk < dataReader.header->chunkCount; chunk++)
+    {
+        columnsRead = dataset_read_column(&dataReader, chunk, DATASET_COL_FEATURES, dataFeatures) &&
+                      dataset_read_column(&dataReader, chunk, DATASET_COL_MASKS, dataMasks) &&
+                      dataset_read_column(&dataReader, chunk, DATASET_COL_ACTIONS, dataActions) &&
+                      dataset_read_column(&dataReader, chunk, DATASET_COL_OUTCOMES, dataOutcomes) &&
+                      dataset_read_column(&dataReader, chunk, DATASET_COL_GAMES, dataGames);
+        for (uint64_t r = 0; columnsRead && r < dataReader.chunks[chunk].rowCount; r++)
+        {
+            int16_t action = dataActions[r];
+            actionsLegal = actionsLegal && action >= 0 && action < RL_ACTION_COUNT &&
+                           (dataMasks[r * DATASET_MASK_BYTES + action / 8] & (1u << (action % 8)));
+            outcomesValid = outcomesValid && dataOutcomes[r] >= -1 && dataOutcomes[r] <= 1 &&
+                            dataGames[r] >= lastGame && dataGames[r] < dataConfig.games;
+            lastGame = dataGames[r];
+        }
+    }
+    assert_true("讀回所有欄", columnsRead);
+    assert_true("選擇的動作在合法遮罩內", actionsLegal);
+    assert_true("結果與遊戲編號有效", outcomesValid);
+    assert_true("特徵欄有壓縮", dataReader.chunks[0].columns[DATASET_COL_FEATURES].codec == DATASET_CODEC_ZERO_RUN);
+    free(dataFeatures);
+    dataset_close(&dataReader);
+
+    DatasetWriter dataWriter;
+    DatasetRow dataRow;
+    memset(&dataRow, 0, sizeof(dataRow));
+    dataRow.features[1] = 5;
+    dataRow.features[FEATURE_COUNT - 1] = -3;
+    dataRow.action = 7;
+    dataRow.game = 42;
+    assert_true("手動寫入資料集", dataset_writer_open(&dataWriter, "test_dataset.bin", 0) &&
+                                        dataset_writer_add(&dataWriter, &dataRow) && dataset_writer_close(&dataWriter));
+    int8_t rowFeatures[FEATURE_COUNT];
+    assert_true("讀回手動寫入的列",
+                dataset_open(&dataReader, "test_dataset.bin") && dataReader.header->rowCount == 1 &&
+                    dataset_read_column(&dataReader, 0, DATASET_COL_FEATURES, rowFeatures) &&
+                    memcmp(rowFeatures, dataRow.features, FEATURE_COUNT) == 0);
+    const int16_t *actionView = dataset_column_view(&dataReader, 0, DATASET_COL_ACTIONS);
+    assert_true("原始資料的欄可直接讀取", actionView != NULL && *actionView == 7);
+    dataset_close(&dataReader);
+    remove("test_dataset.bin");
+}
+
+void test_nn_eval(void)
+{
+    printf("\n=== 測試神經網路評估 ===\n");
+
+    // 各指令集結果相同、存檔後讀回相同、評估為零和
+    vector choices;
+    SearchConfig searchConfig;
+    RngState nnRng;
+    RngState botRng;
+    NnModel nnModel;
+    NnModel nnLoaded;
+    assert_true("建立神經網路", nn_model_init_random(&nnModel, NN_DEFAULT_HIDDEN, NN_DEFAULT_HIDDEN, 3));
+    game nnGames[4];
+    int8_t nnPerspectives[4] = {0, 1, 0, 1};
+    rng_seed(&nnRng, 5, 0);
+    rng_set_active(&nnRng);
+    for (int i = 0; i < 4; i++)
+        init_duel(&nnGames[i], (uint8_t)i, (uint8_t)(i + 3));
+    rng_set_active(NULL);
+    int32_t nnScores[4];
+    int32_t nnReference[4];
+    NnKernel nnBest = nn_get_kernel();
+    nn_set_kernel(NN_KERNEL_SCALAR);
+    nn_evaluate_games(&nnModel, nnGames, 4, nnPerspectives, nnReference);
+    bool kernelsAgree = true;
+    for (int k = NN_KERNEL_SSSE3; k <= (int)nnBest; k++)
+    {
+        nn_set_kernel((NnKernel)k);
+        nn_evaluate_games(&nnModel, nnGames, 4, nnPerspectives, nnScores);
+        kernelsAgree = kernelsAgree && memcmp(nnScores, nnReference, sizeof(nnScores)) == 0;
+    }
+    nn_set_kernel(nnBest);
+    assert_true("SIMD 與純量結果相同", kernelsAgree);
+    assert_true("儲存與讀取神經網路",
+                nn_model_save(&nnModel, "test_nn.bin") && nn_model_load(&nnLoaded, "test_nn.bin"));
+    nn_evaluate_games(&nnLoaded, nnGames, 4, nnPerspectives, nnScores);
+    assert_true("讀回的神經網路結果相同", memcmp(nnScores, nnReference, sizeof(nnScores)) == 0);
+    assert_equal_int("神經網路評估為零和", -nn_evaluate_game(&nnModel, &nnGames[0], 0),
+                     nn_evaluate_game(&nnModel, &nnGames[0], 1));
+    init_search_config(&searchConfig);
+    searchConfig.maxDepth = 2;
+    searchConfig.nodeLimit = 200;
+    searchConfig.eval = nn_evaluate_game;
+    searchConfig.evalCtx = &nnLoaded;
+    get_legal_choices(&nnGames[0], &choices);
+    rng_seed(&botRng, 5, 1);
+    SearchResult nnResult;
+    assert_true("神經網路評估的搜尋選擇合法",
+                findVector(&choices, search_choose(&searchConfig, &nnGames[0], &choices, &botRng, &nnResult)) >= 0);
+    nn_model_free(&nnLoaded);
+    nn_model_free(&nnModel);
+    remove("test_nn.bin");
+}
+
+// 累加每一輪得分差的絕對值
+static void record_tuner_score(void *ctx, uint32_t iteration, double score, const EvalWeights *weights)
+{
+    *(double *)ctx += fabs(score);
+}
+
+void test_eval_tuner(void)
+{
+    printf("\n=== 測試評估權重調整 ===\n");
+
+    // SPSA 調整：結果與執行緒數無關，權重檔讀回相同
+    TunerConfig tunerConfig;
+    init_tuner_config(&tunerConfig);
+    tunerConfig.iterations = 2;
+    tunerConfig.gamesPerIteration = 4;
+    tunerConfig.search.maxDepth = 1;
+    tunerConfig.search.nodeLimit = 30;
+    tunerConfig.threads = 1;
+    EvalWeights tuned[2];
+    run_eval_tuner(&tunerConfig, NULL, NULL, &tuned[0]);
+    tunerConfig.threads = 2;
+    run_eval_tuner(&tunerConfig, NULL, NULL, &tuned[1]);
+    assert_true("調整結果與執行緒數無關", memcmp(&tuned[0], &tuned[1], sizeof(EvalWeights)) == 0);
+    // 初始為 0 的權重（draw_odds）也會被擾動；得分差不為 0 的一輪之後就會離開 0
+    double tunerScore = 0;
+    tunerConfig.a = 1.0;
+    tunerConfig.gamesPerIteration = 8;
+    init_search_config(&tunerConfig.search);
+    tunerConfig.search.maxDepth = 2;
+    tunerConfig.search.nodeLimit = 500;
+    run_eval_tuner(&tunerConfig, record_tuner_score, &tunerScore, &tuned[1]);
+    assert_true("初始為 0 的權重會被調整",
+                tunerConfig.start.drawOdds == 0 && tunerScore != 0 && tuned[1].drawOdds != 0);
+    tuned[0].inRange = -7;
+    EvalWeights loadedWeights;
+    assert_true("權重檔讀寫", save_eval_weights("test_weights.txt", &tuned[0]) &&
+                                  load_eval_weights("test_weights.txt", &loadedWeights) &&
+                                  memcmp(&tuned[0], &loadedWeights, sizeof(EvalWeights)) == 0);
+    FILE *weightsFile = fopen("test_weights.txt", "w");
+    if (weightsFile != NULL)
+    {
+        fprintf(weightsFile, "life 50\nunknown 3\n");
+        fclose(weightsFile);
+    }
+    assert_true("不認得的權重名稱讀取失敗", !load_eval_weights("test_weights.txt", &loadedWeights));
+    remove("test_weights.txt");
+}
+
+void test_plugin(void)
+{
+    printf("\n=== 測試外掛 ===\n");
+
+    // 外掛：載入後以名稱當作策略使用，只回傳合法選擇
+    const LoadedPlugin *plugin = load_bot_plugin("example_plugin.so:50");
+    assert_true("載入外掛", plugin != NULL && find_bot_policy("example") == &plugin->policy);
+    assert_true("外掛名稱不可重複", load_bot_plugin("example_plugin.so") == NULL);
+    assert_true("外掛參數錯誤時載入失敗", load_bot_plugin("example_plugin.so:200") == NULL);
+    // 結構太短（舊版外掛）或版本不同時不讀取其他欄位
+    TfBotPlugin pluginAbi;
+    memset(&pluginAbi, 0, sizeof(pluginAbi));
+    if (plugin != NULL)
+        pluginAbi = *plugin->plugin;
+    bool abiAccepted = check_bot_plugin(&pluginAbi) && TF_HAS_MEMBER(TfBotPlugin, &pluginAbi, destroy);
+    pluginAbi.size = (uint32_t)offsetof(TfBotPlugin, destroy);
+    bool shortRejected = !check_bot_plugin(&pluginAbi) && !TF_HAS_MEMBER(TfBotPlugin, &pluginAbi, destroy);
+    pluginAbi.size = sizeof(TfBotPlugin);
+    pluginAbi.abiVersion = 1;
+    assert_true("外掛結構大小與版本檢查", abiAccepted && shortRejected && !check_bot_plugin(&pluginAbi));
+    SimConfig pluginSim;
+    sim_init_config(&pluginSim);
+    pluginSim.bots[0] = find_bot_policy("example");
+    pluginSim.bots[1] = find_bot_policy("greedy");
+    SimGameResult *pluginResult = malloc(sizeof(SimGameResult));
+    if (plugin != NULL && pluginResult != NULL)
+    {
+        sim_play_game(&pluginSim, 0, pluginResult);
+        assert_true("外掛對局正常結束且選擇合法",
+                    pluginResult->choices > 0 && atomic_load(&plugin->invalidChoices) == 0);
+    }
+    free(pluginResult);
+    game viewGame;
+    init_duel(&viewGame, 1, 4);
+    TfGameView view;
+    build_game_view(&viewGame, NULL, &view);
+    assert_true("唯讀畫面對應局面", view.size == sizeof(TfGameView) && view.self == viewGame.now_turn_player_id &&
+                                         view.players[1].life == viewGame.players[1].life &&
+                                         view.players[0].hand.count == viewGame.players[0].hand.SIZE &&
+                                         view.features == NULL);
+    unload_bot_plugins();
+    assert_true("卸載後策略移除", find_bot_policy("example") == NULL);
+}
+
+void test_game_codec(void)
+{
+    printf("\n=== 測試局面編碼與引擎協定 ===\n");
+
+    // 局面編碼：對局中途的局面解碼後雜湊相同、再次編碼的結果相同，資料不完整時失敗
+    game codecGame;
+    vector codecChoices;
+    play_random_choices(&codecGame, 42);
+    char *stateText = malloc(GAME_CODEC_MAX_TEXT);
+    uint8_t *codecBytes = malloc(2 * GAME_CODEC_MAX_BYTES);
+    game *decoded = malloc(sizeof(game));
+    if (stateText != NULL && codecBytes != NULL && decoded != NULL)
+    {
+        size_t textLength = encode_game_text(&codecGame, stateText, GAME_CODEC_MAX_TEXT);
+        bool decodedOk = textLength > 0 && decode_game_text(stateText, textLength, decoded);
+        size_t size0 = encode_game(&codecGame, codecBytes, GAME_CODEC_MAX_BYTES);
+        size_t size1 = decodedOk ? encode_game(decoded, codecBytes + GAME_CODEC_MAX_BYTES, GAME_CODEC_MAX_BYTES) : 0;
+        assert_true("局面編碼解碼", decodedOk && hash_game(decoded) == hash_game(&codecGame) && size0 == size1 &&
+                                         memcmp(codecBytes, codecBytes + GAME_CODEC_MAX_BYTES, size0) == 0);
+        assert_true("不完整的局面解碼失敗", !decode_game_text(stateText, textLength - 2, decoded) &&
+                                                !decode_game(codecBytes, size0 + 1, decoded));
+        stateText[1] = '!';
+        assert_true("不合法的字元解碼失敗", !decode_game_text(stateText, textLength, decoded));
+
+        // 欄位型別合法但語意不合法的值（角色、卡牌編號、位置）解碼失敗
+        bool roundTrips = true;
+        for (uint64_t seed = 1; seed <= 20; seed++)
+        {
+            play_random_choices(decoded, seed);
+            size_t size = encode_game(decoded, codecBytes, GAME_CODEC_MAX_BYTES);
+            roundTrips = roundTrips && size > 0 && decode_game(codecBytes, size, decoded);
+        }
+        assert_true("對局中途的局面都能解碼", roundTrips);
+        *decoded = codecGame;
+        decoded->players[1].character = CHARACTER_COUNT;
+        size_t badSize = encode_game(decoded, codecBytes, GAME_CODEC_MAX_BYTES);
+        assert_true("不合法的角色解碼失敗", badSize > 0 && !decode_game(codecBytes, badSize, decoded));
+        *decoded = codecGame;
+        vector_pushback(&decoded->players[0].hand, CARD_ID_MAX + 1);
+        badSize = encode_game(decoded, codecBytes, GAME_CODEC_MAX_BYTES);
+        bool badCard = badSize > 0 && !decode_game(codecBytes, badSize, decoded);
+        *decoded = codecGame;
+        vector_pushback(&decoded->players[1].graveyard, 0);
+        badSize = encode_game(decoded, codecBytes, GAME_CODEC_MAX_BYTES);
+        assert_true("不合法的卡牌解碼失敗", badCard && badSize > 0 && !decode_game(codecBytes, badSize, decoded));
+        *decoded = codecGame;
+        decoded->players[0].locate[0] = TRACK_MAX + 1;
+        badSize = encode_game(decoded, codecBytes, GAME_CODEC_MAX_BYTES);
+        assert_true("不合法的位置解碼失敗", badSize > 0 && !decode_game(codecBytes, badSize, decoded));
+
+        // 引擎協定：以檔案代替 stdin/stdout
+        encode_game_text(&codecGame, stateText, GAME_CODEC_MAX_TEXT);
+        FILE *engineIn = tmpfile();
+        FILE *engineOut = tmpfile();
+        if (engineIn != NULL && engineOut != NULL)
+        {
+            fprintf(engineIn, "tfp\nisready\ngo\nposition %s\ngo nodes 200 depth 2\nfoo\nquit\ngo\n", stateText);
+            rewind(engineIn);
+            EngineOptions engineOptions;
+            init_engine_options(&engineOptions);
+            uint64_t searches = run_engine_loop(&engineOptions, engineIn, engineOut);
+            rewind(engineOut);
+            char engineLine[256];
+            int handshake = 0;
+            int bestChoices = 0;
+            bool legal = true;
+            bool unknown = false;
+            get_legal_choices(&codecGame, &codecChoices);
+            while (fgets(engineLine, sizeof(engineLine), engineOut) != NULL)
+            {
+                handshake += strcmp(engineLine, "tfpok\n") == 0 || strcmp(engineLine, "readyok\n") == 0;
+                unknown = unknown || strcmp(engineLine, "info string unknown command foo\n") == 0;
+                if (strncmp(engineLine, "bestchoice ", 11) != 0)
+                    continue;
+                // 第一個 go 沒有局面
+                if (bestChoices++ == 0)
+                    legal = legal && strcmp(engineLine, "bestchoice none\n") == 0;
+                else
+                    legal = legal && findVector(&codecChoices, atoi(engineLine + 11)) >= 0;
+            }
+            assert_true("引擎協定回覆", searches == 2 && handshake == 2 && bestChoices == 2 && legal && unknown);
+        }
+        if (engineIn != NULL)
+            fclose(engineIn);
+        if (engineOut != NULL)
+            fclose(engineOut);
+    }
+    free(stateText);
+    free(codecBytes);
+    free(decoded);
+}
+
+void test_perft(void)
+{
+    printf("\n=== 測試 perft ===\n");
+
+    // 第一層為合法選擇數，結果與執行緒數無關且不改變局面
+    game codecGame;
+    vector codecChoices;
+    play_random_choices(&codecGame, 42);
+    PerftConfig perftConfig;
+    init_perft_config(&perftConfig);
+    perftConfig.depth = 5;
+    perftConfig.hashLeaves = true;
+    perftConfig.threads = 1;
+    PerftResult *perftResults = malloc(2 * sizeof(PerftResult));
+    if (perftResults != NULL)
+    {
+        uint64_t perftHash = hash_game(&codecGame);
+        run_perft(&perftConfig, &codecGame, &perftResults[0]);
+        perftConfig.threads = 3;
+        run_perft(&perftConfig, &codecGame, &perftResults[1]);
+        get_legal_choices(&codecGame, &codecChoices);
+        uint64_t divided = 0;
+        for (uint32_t i = 0; i < perftResults[0].rootCount; i++)
+            divided += perftResults[0].rootLeaves[i];
+        assert_true("perft 第一層與各分支", perftResults[0].total.nodes[1] == codecChoices.SIZE &&
+                                                 perftResults[0].total.rejected == 0 &&
+                                                 divided == perftResults[0].total.nodes[5]);
+        assert_true("perft 與執行緒數無關",
+                    memcmp(&perftResults[0], &perftResults[1], sizeof(PerftResult)) == 0 &&
+                        hash_game(&codecGame) == perftHash);
+    }
+    free(perftResults);
+}
+
+void test_purchase_advisor(void)
+{
+    printf("\n=== 測試購買建議 ===\n");
+
+    // 列出所有買得起的選項並排序，結果與執行緒數無關且不改變局面
+    vector codecChoices;
+    game *adviceGame = malloc(sizeof(game));
+    PurchaseAdvice *advice = malloc(2 * sizeof(PurchaseAdvice));
+    if (adviceGame != NULL && advice != NULL)
+    {
+        RngState adviceRng;
+        rng_seed(&adviceRng, 7, 0);
+        rng_set_active(&adviceRng);
+        init_duel(adviceGame, 0, 1);
+        rng_set_active(NULL);
+        adviceGame->players[adviceGame->now_turn_player_id].energy = 4;
+        uint64_t adviceHash = hash_game(adviceGame);
+        AdvisorConfig advisorConfig;
+        init_advisor_config(&advisorConfig);
+        advisorConfig.rolloutsPerOption = 16;
+        advisorConfig.threads = 1;
+        bool advised = advise_purchase(&advisorConfig, adviceGame, &advice[0]);
+        advisorConfig.threads = 3;
+        advised = advised && advise_purchase(&advisorConfig, adviceGame, &advice[1]);
+        bool unchanged = hash_game(adviceGame) == adviceHash;
+        bool sorted = advised;
+        for (uint32_t i = 1; advised && i < advice[0].count; i++)
+            sorted = sorted && advice[0].options[i - 1].value >= advice[0].options[i].value &&
+                     advice[0].options[i].cost <= 4 && advice[0].options[i].rollouts == 16;
+        apply_choice(adviceGame, 6);
+        get_legal_choices(adviceGame, &codecChoices);
+        assert_true("購買建議涵蓋所有選項並排序", sorted && advice[0].count == codecChoices.SIZE);
+        assert_true("購買建議與執行緒數無關",
+                    advised && memcmp(&advice[0], &advice[1], sizeof(PurchaseAdvice)) == 0);
+        assert_true("購買建議不改變局面", unchanged);
+
+        SimConfig advisorSim;
+        sim_init_config(&advisorSim);
+        advisorSim.bots[0] = find_bot_policy("advisor");
+        advisorSim.bots[1] = find_bot_policy("greedy");
+        SimGameResult advisorResult;
+        sim_play_game(&advisorSim, 3, &advisorResult);
+        assert_true("advisor 策略可以完成對局", advisorResult.choices > 0 && advisorResult.winner >= 0);
+    }
+    free(adviceGame);
+    free(advice);
+}
+
+void test_draw_odds(void)
+{
+    printf("\n=== 測試抽牌機率 ===\n");
+
+    // 抽牌機率：與手算的超幾何分布相同，牌堆不夠時從棄牌堆繼續抽，相同組成使用快取
+    PileComposition piles;
+    DrawOdds odds;
+    memset(&piles, 0, sizeof(piles));
+    piles.deck[DRAW_ATTACK] = 2;
+    piles.deck[DRAW_DEFENSE] = 3;
+    assert_true("抽牌機率（單一牌堆）", get_draw_odds(&piles, 2, &odds) && odds.draws == 2 &&
+                                            fabs(odds.atLeast[DRAW_ATTACK][1] - 0.7) < 1e-12 &&
+                                            fabs(odds.atLeast[DRAW_ATTACK][2] - 0.1) < 1e-12 &&
+                                            fabs(odds.atLeast[DRAW_DEFENSE][0] - 1.0) < 1e-12);
+    memset(&piles, 0, sizeof(piles));
+    piles.deck[DRAW_ATTACK] = 1;
+    piles.graveyard[DRAW_ATTACK] = 1;
+    piles.graveyard[DRAW_MOVE] = 2;
+    assert_true("抽牌機率（洗入棄牌堆）", get_draw_odds(&piles, 3, &odds) && odds.draws == 3 &&
+                                              fabs(odds.atLeast[DRAW_ATTACK][1] - 1.0) < 1e-12 &&
+                                              fabs(odds.atLeast[DRAW_ATTACK][2] - 2.0 / 3.0) < 1e-12 &&
+                                              odds.atLeast[DRAW_MOVE][3] == 0.0);
+    uint64_t drawHits[2], drawMisses[2];
+    get_draw_cache_stats(&drawHits[0], &drawMisses[0]);
+    DrawOdds cachedOdds;
+    get_draw_odds(&piles, 6, &odds);
+    get_draw_odds(&piles, 6, &cachedOdds);
+    get_draw_cache_stats(&drawHits[1], &drawMisses[1]);
+    assert_true("抽牌機率快取", odds.draws == 4 && drawHits[1] == drawHits[0] + 1 &&
+                                    drawMisses[1] == drawMisses[0] + 1 &&
+                                    memcmp(&odds, &cachedOdds, sizeof(DrawOdds)) == 0 &&
+                                    !get_draw_odds(&piles, DRAW_MAX_DRAWS + 1, &odds));
+}
+
+typedef struct {
+    int32_t capped;
+    int32_t energy;
+    uint32_t cards;
+} ComboScore;
+
+// 窮舉每張牌不使用、單獨打出或與之後的技能卡組合，used 為已使用的手牌位元
+static void combo_brute_force(vector *hand, ComboGoal goal, int32_t target, int32_t room, uint32_t index,
+                              uint32_t used, int32_t effect, int32_t energy, uint32_t cards, ComboScore *best)
+{
+    if (index == hand->SIZE)
+    {
+        ComboScore score = {effect < target ? effect : target, energy < room ? energy : room, cards};
+        if (score.capped > best->capped || (score.capped == best->capped && score.energy > best->energy) ||
+            (score.capped == best->capped && score.energy == best->energy && score.cards < best->cards))
+            *best = score;
+        return;
+    }
+    combo_brute_force(hand, goal, target, room, index + 1, used, effect, energy, cards, best);
+    int32_t card = hand->array[index];
+    CardType type = get_card_type(card);
+    int32_t value = get_card_value(card);
+    if ((used >> index) & 1 || (type != (CardType)(CARD_TYPE_BASIC_ATK + goal) && type != CARD_TYPE_BASIC_GENERAL))
+        return;
+    combo_brute_force(hand, goal, target, room, index + 1, used | 1u << index, effect + value, energy + value,
+                      cards + 1, best);
+    for (uint32_t i = 0; i < hand->SIZE; i++)
+    {
+        int32_t skill = hand->array[i];
+        if (!((used >> i) & 1) && get_card_type(skill) == (CardType)(CARD_TYPE_SKILL_ATK + goal) &&
+            cards_can_combine(skill, card))
+            combo_brute_force(hand, goal, target, room, index + 1, used | 1u << index | 1u << i,
+                              effect + value + get_card_value(skill), energy, cards + 2, best);
+    }
+}
+
+void test_combo_solver(void)
+{
+    printf("\n=== 測試出牌組合 ===\n");
+
+    // 出牌組合：相容矩陣與規則相同，技能卡搭配通用牌、攻擊牌單獨換能量，效果上限內優先能量
+    assert_true("卡牌組合相容矩陣", cards_can_combine(11, 3) && cards_can_combine(11, 10) &&
+                                        !cards_can_combine(11, 4) && cards_can_combine(14, 5) &&
+                                        !cards_can_combine(12, 5) &&
+                                        !cards_can_combine(3, 11));
+    vector comboHand;
+    int32_t comboCards[] = {11, 3, 10};
+    vector_init(&comboHand);
+    for (int i = 0; i < 3; i++)
+        vector_pushback(&comboHand, comboCards[i]);
+    ComboPlan plan;
+    solve_combo(&comboHand, COMBO_GOAL_ATTACK, COMBO_UNCAPPED, 0, &plan);
+    assert_true("出牌組合（技能卡搭配通用牌）", plan.count == 2 && plan.plays[0].skill == 0 &&
+                                                   plan.plays[0].basic == 2 && plan.plays[1].skill == -1 &&
+                                                   plan.plays[1].basic == 1 && plan.effect == 5 &&
+                                                   plan.energy == 3 && plan.cards == 3);
+    comboHand.SIZE = 2;
+    solve_combo(&comboHand, COMBO_GOAL_ATTACK, 3, 0, &plan);
+    assert_true("出牌組合（效果上限）", plan.count == 1 && plan.plays[0].skill == -1 &&
+                                            plan.plays[0].basic == 1 && plan.effect == 3 && plan.cards == 1);
+
+    // 隨機手牌與窮舉比較
+    RngState comboRng;
+    rng_seed(&comboRng, 46, 0);
+    bool comboMatches = true;
+    for (int trial = 0; trial < 200 && comboMatches; trial++)
+    {
+        vector_init(&comboHand);
+        uint32_t size = 3 + rng_bounded(&comboRng, 6);
+        for (uint32_t i = 0; i < size; i++)
+            vector_pushback(&comboHand, rng_bounded(&comboRng, 2) ? 1 + (int32_t)rng_bounded(&comboRng, 10)
+                                                                  : 11 + (int32_t)rng_bounded(&comboRng, 124));
+        ComboGoal goal = (ComboGoal)(trial % COMBO_GOAL_COUNT);
+        int32_t target = trial % 2 ? COMBO_UNCAPPED : (int32_t)rng_bounded(&comboRng, 12);
+        int32_t energy = (int32_t)rng_bounded(&comboRng, ENERGY_LIMIT + 1);
+        solve_combo(&comboHand, goal, target, energy, &plan);
+        ComboScore bruteBest = {-1, 0, 0};
+        combo_brute_force(&comboHand, goal, target, ENERGY_LIMIT - energy, 0, 0, 0, 0, 0, &bruteBest);
+        int32_t capped = plan.effect < target ? plan.effect : target;
+        comboMatches = capped == bruteBest.capped && plan.energy == bruteBest.energy &&
+                       plan.cards == bruteBest.cards;
+    }
+    assert_true("出牌組合與窮舉結果相同", comboMatches);
+}
+
+void test_action_preview(void)
+{
+    printf("\n=== 測試行動預覽 ===\n");
+
+    // 局面複本：向量只複製使用中的部分，結果與完整複製相同
+    static const int32_t comboCards[] = {11, 3, 10};
+    game *previewGame = malloc(sizeof(game));
+    game *previewCopy = malloc(sizeof(game));
+    if (previewGame != NULL && previewCopy != NULL)
+    {
+        init_duel(previewGame, 0, 1);
+        memset(previewCopy, 0xAB, sizeof(game));
+        clone_game(previewCopy, previewGame);
+        assert_true("局面複本", hash_game(previewCopy) == hash_game(previewGame) &&
+                                    previewCopy->status == previewGame->status &&
+                                    memcmp(previewCopy->players[0].deck.array, previewGame->players[0].deck.array,
+                                           previewGame->players[0].deck.SIZE * sizeof(int32_t)) == 0);
+
+        // 行動預覽：傷害先扣防禦、能量等於牌值，技能卡一併套用計畫中的搭配；局面與亂數不變
+        int8_t mover = previewGame->now_turn_player_id;
+        player *me = &previewGame->players[mover];
+        player *opp = &previewGame->players[1 - mover];
+        me->locate[0] = 4;
+        opp->locate[0] = 5;
+        opp->defense = 2;
+        me->energy = 0;
+        vector_init(&me->hand);
+        for (int i = 0; i < 3; i++)
+            vector_pushback(&me->hand, comboCards[i]);
+        previewGame->status = USE_ATK;
+        previewGame->nowUsingCardID = 0;
+        *previewCopy = *previewGame;
+        RngState previewRng;
+        rng_seed(&previewRng, 47, 0);
+        rng_set_active(&previewRng);
+        RngState rngBefore = previewRng;
+        ActionPreview preview;
+        bool previewed = preview_choice(previewGame, 2, &preview);
+        assert_true("行動預覽（基本攻擊）", previewed && preview.damage == 3 && preview.lifeDamage == 1 &&
+                                                preview.energyGained == 3 && preview.partnerChoice == 0 &&
+                                                preview.after[1 - mover].defense == 0 && !preview.endsTurn &&
+                                                preview_has_effect(&preview));
+        previewGame->status = USE_SKILL;
+        previewed = preview_choice(previewGame, 1, &preview);
+        assert_true("行動預覽（技能組合）", previewed && preview.partnerChoice == 3 && preview.damage == 2 &&
+                                                preview.energyGained == 0 && preview.nextStatus == CHOOSE_MOVE);
+        previewGame->status = USE_ATK;
+        assert_true("行動預覽不改變局面", !preview_choice(previewGame, 10, &preview) &&
+                                              memcmp(previewGame, previewCopy, sizeof(game)) == 0 &&
+                                              memcmp(&rngBefore, &previewRng, sizeof(RngState)) == 0 &&
+                                              rng_get_active() == &previewRng);
+        rng_set_active(NULL);
+    }
+    free(previewGame);
+    free(previewCopy);
+}
+
+void test_card_db(void)
+{
+    printf("\n=== 測試卡牌數值資料庫 ===\n");
+
+    // 卡牌數值資料庫：預設值與原本的規則相同；載入後牌值、花費、射程、搭配需求立即生效，檔案變更時重新載入
+    assert_true("卡牌數值預設值", card_db_get(3)->value == 3 && card_db_get(12)->cost == 2 &&
+                                      card_db_get(10)->range == 1 && card_db_get(11)->range == 1 &&
+                                      card_db_get(4)->range == 0 && card_db_get(20)->cost == 0 &&
+                                      card_db_get(-1)->value == 0);
+    CardStats cardStats[CARD_ID_COUNT];
+    memcpy(cardStats, card_db_defaults(), sizeof(cardStats));
+    cardStats[1].value = 4;
+    cardStats[1].range = 2;
+    cardStats[2].cost = 5;
+    cardStats[14].requirement = 2;
+    game *dbGame = malloc(sizeof(game));
+    if (dbGame != NULL)
+    {
+        init_duel(dbGame, 0, 1);
+        int8_t mover = dbGame->now_turn_player_id;
+        player *me = &dbGame->players[mover];
+        me->locate[0] = 3;
+        dbGame->players[1 - mover].locate[0] = 5;
+        me->energy = 10;
+        vector_init(&me->hand);
+        vector_pushback(&me->hand, 1);
+        dbGame->status = CHOOSE_MOVE;
+        vector dbChoices;
+        get_legal_choices(dbGame, &dbChoices);
+        bool outOfRange = findVector(&dbChoices, 1) < 0 && get_purchase_cost(dbGame, 2) == 2;
+
+        assert_true("寫入並載入卡牌數值檔", card_db_write("test_card_db.bin", cardStats) &&
+                                                card_db_load("test_card_db.bin"));
+        get_legal_choices(dbGame, &dbChoices);
+        assert_true("卡牌數值檔生效", outOfRange && findVector(&dbChoices, 1) >= 0 && get_card_value(1) == 4 &&
+                                          get_purchase_cost(dbGame, 2) == 5 && !cards_can_combine(14, 4) &&
+                                          cards_can_combine(14, 5));
+        free(dbGame);
+    }
+
+    cardStats[1].value = 6;
+    bool reloaded = card_db_write("test_card_db.bin", cardStats);
+    clock_t pollDeadline = clock() + CLOCKS_PER_SEC;
+    while (reloaded && !card_db_poll() && clock() < pollDeadline)
+        ;
+    assert_true("卡牌數值檔變更後重新載入", reloaded && get_card_value(1) == 6 && !card_db_poll());
+
+    // 對局的快照：持有期間重新載入不影響這個執行緒，釋放後舊的對應才解除
+    card_db_acquire();
+    cardStats[1].value = 7;
+    bool snapshotKept = card_db_write("test_card_db.bin", cardStats) && card_db_load("test_card_db.bin") &&
+                        get_card_value(1) == 6 && card_db_mapping_count() == 2;
+    card_db_release();
+    assert_true("對局快照保留舊數值", snapshotKept && get_card_value(1) == 7 && card_db_mapping_count() == 1);
+    // 使用中的檔案不能就地覆寫（見 card_db.h），先移除再寫入新檔案
+    remove("test_card_db.bin");
+    FILE *badDb = fopen("test_card_db.bin", "wb");
+    if (badDb != NULL)
+    {
+        fputs("not a card database", badDb);
+        fclose(badDb);
+    }
+    cardStats[1].value = -1;
+    assert_true("不合法的卡牌數值檔不會載入", !card_db_load("test_card_db.bin") && get_card_value(1) == 7 &&
+                                                  !card_db_write("test_card_db.bin", cardStats));
+    card_db_reset();
+    assert_true("卡牌數值回到預設值", get_card_value(1) == 1 && !card_db_poll() && card_db_mapping_count() == 0);
+    remove("test_card_db.bin");
+}
+
+void test_card_effect(void)
+{
+    printf("\n=== 測試卡牌效果 ===\n");
+
+    // 卡牌效果程式：技能牌由 card_spec.tsv 的效果欄組譯而來，沒有程式的牌回傳 NULL
+    const EffectInstr *attackEffect = get_card_effect(11);
+    assert_true("卡牌效果程式", attackEffect != NULL && attackEffect[0].op == EFFECT_ADD_CARD &&
+                                    get_card_effect(12) == attackEffect && get_card_effect(14) != NULL &&
+                                    get_card_effect(1) == NULL && get_card_effect(20) == NULL &&
+                                    get_card_effect(-1) == NULL);
+    game *effectGame = malloc(sizeof(game));
+    if (effectGame != NULL)
+    {
+        init_duel(effectGame, 0, 1);
+        int8_t mover = effectGame->now_turn_player_id;
+        player *me = &effectGame->players[mover];
+        player *opp = &effectGame->players[1 - mover];
+        me->locate[0] = 3;
+        opp->locate[0] = 5;
+        opp->defense = 0;
+        effectGame->nowATK = 0;
+        effectGame->totalDamage = 0;
+        uint8_t life = opp->life;
+        bool moves = run_skill_effect(effectGame, 11, 2);
+        assert_true("技能效果程式（攻擊）", !moves && effectGame->nowATK == 3 && effectGame->totalDamage == 3 &&
+                                                opp->life == life - 3);
+
+        // 擊退 2 格、棄對手牌庫頂 2 張、放入至多 2 張中毒牌（只剩 1 張）、自己抽 1 張
+        static const EffectInstr program[] = {{EFFECT_SET, 2},    {EFFECT_KNOCKBACK, 0}, {EFFECT_MILL, 0},
+                                              {EFFECT_POISON, 0}, {EFFECT_SET, 1},       {EFFECT_DRAW, 0},
+                                              {EFFECT_END, 0}};
+        vector_init(&me->snowWhite.remindPosion);
+        vector_pushback(&me->snowWhite.remindPosion, CARD_POISON_LV1);
+        uint32_t deckSize = opp->deck.SIZE;
+        uint32_t graveyardSize = opp->graveyard.SIZE;
+        uint32_t handSize = me->hand.SIZE;
+        int32_t milledCard = opp->deck.array[deckSize - 1];
+        moves = run_effect_program(effectGame, program, 11, 2);
+        assert_true("自訂效果程式", !moves && opp->locate[0] == 7 && opp->deck.SIZE == deckSize - 2 &&
+                                        opp->graveyard.SIZE == graveyardSize + 3 &&
+                                        opp->graveyard.array[graveyardSize] == milledCard &&
+                                        opp->graveyard.array[graveyardSize + 2] == CARD_POISON_LV1 &&
+                                        me->snowWhite.remindPosion.SIZE == 0 && me->hand.SIZE == handSize + 1);
+        static const EffectInstr pushOut[] = {{EFFECT_SET, 9}, {EFFECT_KNOCKBACK, 0}, {EFFECT_END, 0}};
+        run_effect_program(effectGame, pushOut, 11, 2);
+        assert_true("擊退不超出軌道", opp->locate[0] == TRACK_MAX);
+
+        // card_spec.tsv 的角色效果：白雪公主的攻擊技能棄對手牌庫頂 L 張、防禦技能放入 O 張中毒牌，
+        // 小紅帽的移動技能擊退 O 格，桃樂絲的防禦技能抽 1 張
+        init_duel(effectGame, 1, 0);
+        me = &effectGame->players[0];
+        opp = &effectGame->players[1];
+        me->locate[0] = 3;
+        opp->locate[0] = 4;
+        bool poisonDeck = me->snowWhite.remindPosion.SIZE == 18 &&
+                          me->snowWhite.remindPosion.array[17] == CARD_POISON_LV1 &&
+                          me->snowWhite.remindPosion.array[0] == CARD_POISON_LV3;
+        deckSize = opp->deck.SIZE;
+        graveyardSize = opp->graveyard.SIZE;
+        run_skill_effect(effectGame, 24, 1);
+        bool milled = opp->deck.SIZE == deckSize - 2 && opp->graveyard.SIZE == graveyardSize + 2;
+        run_skill_effect(effectGame, 26, 2);
+        assert_true("白雪公主的棄牌與中毒", poisonDeck && milled && opp->graveyard.SIZE == graveyardSize + 4 &&
+                                                opp->graveyard.array[graveyardSize + 3] == CARD_POISON_LV1 &&
+                                                me->snowWhite.remindPosion.SIZE == 16);
+        init_duel(effectGame, 0, 8);
+        me = &effectGame->players[0];
+        opp = &effectGame->players[1];
+        me->locate[0] = 3;
+        opp->locate[0] = 4;
+        moves = run_skill_effect(effectGame, 17, 2);
+        bool knocked = !moves && opp->locate[0] == 6;
+        effectGame->now_turn_player_id = 1;
+        handSize = opp->hand.SIZE;
+        run_skill_effect(effectGame, 110, 1);
+        assert_true("小紅帽的擊退與桃樂絲的抽牌", knocked && opp->hand.SIZE == handSize + 1);
+    }
+    free(effectGame);
+}
+
+
 TestResult run_all_tests(void)
 {
     init_test_env();
@@ -206,6 +1490,28 @@ TestResult run_all_tests(void)
     test_character_system();
     test_game_state();
     test_battle_system();
+    test_simulation();
+    test_tournament();
+    test_search();
+    test_game_hash();
+    test_transposition();
+    test_opening_book();
+    test_ponder();
+    test_game_features();
+    test_rl_env();
+    test_shm_ring();
+    test_dataset();
+    test_nn_eval();
+    test_eval_tuner();
+    test_plugin();
+    test_game_codec();
+    test_perft();
+    test_purchase_advisor();
+    test_draw_odds();
+    test_combo_solver();
+    test_action_preview();
+    test_card_db();
+    test_card_effect();
 
     printf("\n=== 測試結果 ===\n");
     printf("總計: %d\n", test_result.total);
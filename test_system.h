@@ -7,6 +7,33 @@
 #include "game_state.h"
 #include "game_init.h"
 #include "utils.h"
+#include "game_action.h"
+#include "simulation.h"
+#include "matchup.h"
+#include "card_impact.h"
+#include "tournament.h"
+#include "search.h"
+#include "game_hash.h"
+#include "transposition.h"
+#include "opening_book.h"
+#include "ponder.h"
+#include "rl_env.h"
+#include "game_features.h"
+#include "shm_ring.h"
+#include "dataset.h"
+#include "nn_eval.h"
+#include "eval_tuner.h"
+#include "plugin_loader.h"
+#include "game_codec.h"
+#include "engine_protocol.h"
+#include "perft.h"
+#include "purchase_advisor.h"
+#include "draw_odds.h"
+#include "card_combination.h"
+#include "combo_solver.h"
+#include "action_preview.h"
+#include "card_db.h"
+#include "card_effect.h"
 
 // 測試結果結構
 typedef struct {
@@ -36,6 +63,72 @@ void test_game_state(void);
 // 戰鬥系統測試
 void test_battle_system(void);
 
+// 無互動選擇與模擬測試
+void test_simulation(void);
+
+// 錦標賽測試
+void test_tournament(void);
+
+// 搜尋測試
+void test_search(void);
+
+// 局面雜湊測試
+void test_game_hash(void);
+
+// 置換表測試
+void test_transposition(void);
+
+// 開局庫測試
+void test_opening_book(void);
+
+// 預先搜尋測試
+void test_ponder(void);
+
+// 局面特徵測試
+void test_game_features(void);
+
+// 強化學習環境測試
+void test_rl_env(void);
+
+// 共享記憶體緩衝區測試
+void test_shm_ring(void);
+
+// 資料集測試
+void test_dataset(void);
+
+// 神經網路評估測試
+void test_nn_eval(void);
+
+// 評估權重調整測試
+void test_eval_tuner(void);
+
+// 外掛測試
+void test_plugin(void);
+
+// 局面編碼與引擎協定測試
+void test_game_codec(void);
+
+// perft測試
+void test_perft(void);
+
+// 購買建議測試
+void test_purchase_advisor(void);
+
+// 抽牌機率測試
+void test_draw_odds(void);
+
+// 出牌組合測試
+void test_combo_solver(void);
+
+// 行動預覽測試
+void test_action_preview(void);
+
+// 卡牌數值資料庫測試
+void test_card_db(void);
+
+// 卡牌效果測試
+void test_card_effect(void);
+
 // 驗證函數
 void assert_true(const char* test_name, bool condition);
 void assert_equal_int(const char* test_name, int expected, int actual);
@@ -0,0 +1,296 @@
+#include <pthread.h>
+#include "tournament.h"
+
+#define ELO_ITERATIONS 200
+#define SPRT_MIN_VARIANCE 1e-6
+
+typedef struct {
+    const TournamentConfig *config;
+    TournamentPairing *active[TOURNAMENT_MAX_PAIRINGS];
+    uint64_t batchFirst[TOURNAMENT_MAX_PAIRINGS];  // 這一批的第一場編號
+    uint64_t batchLast[TOURNAMENT_MAX_PAIRINGS];
+    uint64_t chunksPerPairing;
+    pthread_mutex_t lock;
+} TournamentBatch;
+
+void init_tournament_config(TournamentConfig *config)
+{
+    config->botCount = 0;
+    for (int i = 0; i < get_bot_policy_count() && i < TOURNAMENT_MAX_BOTS; i++)
+        config->bots[config->botCount++] = get_bot_policy(i);
+    config->mode = TOURNAMENT_ROUND_ROBIN;
+    config->seed = 1;
+    config->maxTurns = SIM_DEFAULT_MAX_TURNS;
+    config->maxGames = 10 * TOURNAMENT_ROTATION_GAMES;
+    config->batchGames = TOURNAMENT_ROTATION_GAMES;
+    config->useSprt = true;
+    config->sprt.elo0 = 0;
+    config->sprt.elo1 = 10;
+    config->sprt.alpha = 0.05;
+    config->sprt.beta = 0.05;
+    config->threads = 0;
+}
+
+static double elo_to_score(double elo)
+{
+    return 1 / (1 + pow(10, -elo / 400));
+}
+
+static double score_to_elo(double score)
+{
+    if (score <= 0)
+        score = 1e-6;
+    if (score >= 1)
+        score = 1 - 1e-6;
+    return -400 * log10(1 / score - 1);
+}
+
+// 常態近似的三項式 SPRT（勝=1、和=0.5、負=0）
+double sprt_llr(const SprtConfig *sprt, uint64_t wins, uint64_t draws, uint64_t losses)
+{
+    double n = (double)(wins + draws + losses);
+    if (n == 0)
+        return 0;
+
+    double w = (double)wins / n;
+    double d = (double)draws / n;
+    double l = (double)losses / n;
+    double mean = w + 0.5 * d;
+    double variance = w * (1 - mean) * (1 - mean) + d * (0.5 - mean) * (0.5 - mean) + l * mean * mean;
+    // 全勝、全負或全和時變異數為 0，給一個下限讓檢定仍能往正確的方向結束
+    if (variance < SPRT_MIN_VARIANCE)
+        variance = SPRT_MIN_VARIANCE;
+
+    double s0 = elo_to_score(sprt->elo0);
+    double s1 = elo_to_score(sprt->elo1);
+    return 0.5 * n * (s1 - s0) * (2 * mean - s0 - s1) / variance;
+}
+
+SprtStatus sprt_status(const SprtConfig *sprt, double llr)
+{
+    double lower = log(sprt->beta / (1 - sprt->alpha));
+    double upper = log((1 - sprt->beta) / sprt->alpha);
+    if (llr >= upper)
+        return SPRT_ACCEPT_H1;
+    if (llr <= lower)
+        return SPRT_ACCEPT_H0;
+    return SPRT_CONTINUE;
+}
+
+double pairing_elo(const TournamentPairing *pairing, double *margin)
+{
+    double n = (double)(pairing->wins + pairing->draws + pairing->losses);
+    if (n == 0)
+    {
+        *margin = 0;
+        return 0;
+    }
+
+    double w = (double)pairing->wins / n;
+    double d = (double)pairing->draws / n;
+    double l = (double)pairing->losses / n;
+    double mean = w + 0.5 * d;
+    double variance = w * (1 - mean) * (1 - mean) + d * (0.5 - mean) * (0.5 - mean) + l * mean * mean;
+    double stdError = sqrt(variance / n);
+
+    *margin = (score_to_elo(mean + 1.96 * stdError) - score_to_elo(mean - 1.96 * stdError)) / 2;
+    return score_to_elo(mean);
+}
+
+// 第 i 場：a 的先後手每場交換，角色每兩場輪替一次
+static void play_pairing_game(const TournamentConfig *config, const TournamentPairing *pairing,
+                              uint64_t i, SimGameResult *result, int *seatA)
+{
+    SimConfig sim;
+    sim_init_config(&sim);
+    *seatA = (int)(i % 2);
+    sim.characters[*seatA] = (uint8_t)((i / 2) % CHARACTER_COUNT);
+    sim.characters[1 - *seatA] = (uint8_t)((i / (2 * CHARACTER_COUNT)) % CHARACTER_COUNT);
+    sim.bots[*seatA] = config->bots[pairing->a];
+    sim.bots[1 - *seatA] = config->bots[pairing->b];
+    sim.seed = rng_mix64(config->seed + (uint64_t)(pairing->a * TOURNAMENT_MAX_BOTS + pairing->b));
+    sim.maxTurns = config->maxTurns;
+    sim_play_game(&sim, i, result);
+}
+
+static void run_batch_chunk(void *ctx, size_t task)
+{
+    TournamentBatch *batch = ctx;
+    size_t slot = task / batch->chunksPerPairing;
+    TournamentPairing *pairing = batch->active[slot];
+    uint64_t first = batch->batchFirst[slot] + (task % batch->chunksPerPairing) * SIM_CHUNK_GAMES;
+    uint64_t last = first + SIM_CHUNK_GAMES;
+    if (last > batch->batchLast[slot])
+        last = batch->batchLast[slot];
+
+    uint64_t wins = 0, draws = 0, losses = 0;
+    for (uint64_t i = first; i < last; i++)
+    {
+        SimGameResult result;
+        int seatA;
+        play_pairing_game(batch->config, pairing, i, &result, &seatA);
+        if (result.winner < 0)
+            draws++;
+        else if (result.winner == seatA)
+            wins++;
+        else
+            losses++;
+    }
+
+    pthread_mutex_lock(&batch->lock);
+    pairing->wins += wins;
+    pairing->draws += draws;
+    pairing->losses += losses;
+    pthread_mutex_unlock(&batch->lock);
+}
+
+static uint64_t pairing_games(const TournamentPairing *pairing)
+{
+    return pairing->wins + pairing->draws + pairing->losses;
+}
+
+void run_tournament(const TournamentConfig *config, TournamentResult *result)
+{
+    memset(result, 0, sizeof(TournamentResult));
+    for (int a = 0; a < config->botCount; a++)
+    {
+        for (int b = a + 1; b < config->botCount; b++)
+        {
+            if (config->mode == TOURNAMENT_GAUNTLET && a != 0)
+                break;
+            TournamentPairing *pairing = &result->pairings[result->pairingCount++];
+            pairing->a = a;
+            pairing->b = b;
+            pairing->status = SPRT_CONTINUE;
+        }
+    }
+
+    TournamentBatch *batch = malloc(sizeof(TournamentBatch));
+    if (batch == NULL)
+        return;
+    batch->config = config;
+    uint64_t batchGames = config->batchGames > 0 ? config->batchGames : TOURNAMENT_ROTATION_GAMES;
+    batch->chunksPerPairing = (batchGames + SIM_CHUNK_GAMES - 1) / SIM_CHUNK_GAMES;
+    pthread_mutex_init(&batch->lock, NULL);
+
+    // 每批只跑尚未決定的配對，批次結束後才檢查 SPRT，因此停止點與執行緒數無關
+    while (true)
+    {
+        size_t activeCount = 0;
+        for (int p = 0; p < result->pairingCount; p++)
+        {
+            TournamentPairing *pairing = &result->pairings[p];
+            uint64_t played = pairing_games(pairing);
+            if (pairing->status != SPRT_CONTINUE || played >= config->maxGames)
+                continue;
+            batch->active[activeCount] = pairing;
+            batch->batchFirst[activeCount] = played;
+            batch->batchLast[activeCount] = played + batchGames < config->maxGames ? played + batchGames
+                                                                                 : config->maxGames;
+            activeCount++;
+        }
+        if (activeCount == 0)
+            break;
+
+        sim_parallel_for(activeCount * batch->chunksPerPairing, config->threads, run_batch_chunk, batch);
+
+        for (size_t i = 0; i < activeCount; i++)
+        {
+            TournamentPairing *pairing = batch->active[i];
+            pairing->llr = sprt_llr(&config->sprt, pairing->wins, pairing->draws, pairing->losses);
+            if (config->useSprt)
+                pairing->status = sprt_status(&config->sprt, pairing->llr);
+        }
+    }
+
+    pthread_mutex_destroy(&batch->lock);
+    free(batch);
+
+    for (int p = 0; p < result->pairingCount; p++)
+        result->totalGames += pairing_games(&result->pairings[p]);
+    compute_tournament_ratings(config, result);
+}
+
+// Bradley-Terry 最大概似估計（MM 演算法），每組配對加一場虛擬和局避免全勝時發散
+void compute_tournament_ratings(const TournamentConfig *config, TournamentResult *result)
+{
+    double strength[TOURNAMENT_MAX_BOTS];
+    double score[TOURNAMENT_MAX_BOTS] = {0};
+
+    for (int i = 0; i < config->botCount; i++)
+        strength[i] = 1;
+    for (int p = 0; p < result->pairingCount; p++)
+    {
+        const TournamentPairing *pairing = &result->pairings[p];
+        score[pairing->a] += (double)pairing->wins + 0.5 * (double)pairing->draws + 0.5;
+        score[pairing->b] += (double)pairing->losses + 0.5 * (double)pairing->draws + 0.5;
+    }
+
+    for (int iter = 0; iter < ELO_ITERATIONS; iter++)
+    {
+        double denom[TOURNAMENT_MAX_BOTS] = {0};
+        for (int p = 0; p < result->pairingCount; p++)
+        {
+            const TournamentPairing *pairing = &result->pairings[p];
+            double games = (double)pairing_games(pairing) + 1;
+            double sum = strength[pairing->a] + strength[pairing->b];
+            denom[pairing->a] += games / sum;
+            denom[pairing->b] += games / sum;
+        }
+
+        double logMean = 0;
+        for (int i = 0; i < config->botCount; i++)
+        {
+            if (denom[i] > 0)
+                strength[i] = score[i] / denom[i];
+            logMean += log(strength[i]);
+        }
+        // 正規化使平均 Elo 為 0
+        logMean /= config->botCount;
+        for (int i = 0; i < config->botCount; i++)
+            strength[i] /= exp(logMean);
+    }
+
+    for (int i = 0; i < config->botCount; i++)
+        result->ratings[i] = 400 * log10(strength[i]);
+}
+
+static const char *sprt_status_name(SprtStatus status)
+{
+    switch (status)
+    {
+    case SPRT_ACCEPT_H0:
+        return "H0";
+    case SPRT_ACCEPT_H1:
+        return "H1";
+    default:
+        return "-";
+    }
+}
+
+void print_tournament(FILE *fp, const TournamentConfig *config, const TournamentResult *result)
+{
+    fprintf(fp, "%-12s %-12s %8s %8s %8s %8s %14s %8s %5s\n", "bot", "opponent", "games", "wins", "draws",
+            "losses", "elo", "llr", "sprt");
+    for (int p = 0; p < result->pairingCount; p++)
+    {
+        const TournamentPairing *pairing = &result->pairings[p];
+        double margin;
+        double elo = pairing_elo(pairing, &margin);
+        fprintf(fp, "%-12s %-12s %8llu %8llu %8llu %8llu %+7.1f +-%5.1f %8.3f %5s\n",
+                config->bots[pairing->a]->name, config->bots[pairing->b]->name,
+                (unsigned long long)pairing_games(pairing), (unsigned long long)pairing->wins,
+                (unsigned long long)pairing->draws, (unsigned long long)pairing->losses, elo, margin,
+                pairing->llr, sprt_status_name(pairing->status));
+    }
+
+    double lower = log(config->sprt.beta / (1 - config->sprt.alpha));
+    double upper = log((1 - config->sprt.beta) / config->sprt.alpha);
+    fprintf(fp, "\nSPRT elo0=%.1f elo1=%.1f alpha=%.3f beta=%.3f bounds [%.3f, %.3f]\n", config->sprt.elo0,
+            config->sprt.elo1, config->sprt.alpha, config->sprt.beta, lower, upper);
+    fprintf(fp, "Total games: %llu\n\n", (unsigned long long)result->totalGames);
+
+    fprintf(fp, "%-12s %8s\n", "bot", "elo");
+    for (int i = 0; i < config->botCount; i++)
+        fprintf(fp, "%-12s %+8.1f\n", config->bots[i]->name, result->ratings[i]);
+}
@@ -0,0 +1,82 @@
+#ifndef _TOURNAMENT_H
+#define _TOURNAMENT_H
+
+#include "character_system.h"
+#include "simulation.h"
+
+#define TOURNAMENT_MAX_BOTS 16
+#define TOURNAMENT_MAX_PAIRINGS (TOURNAMENT_MAX_BOTS * (TOURNAMENT_MAX_BOTS - 1) / 2)
+
+// 角色、先後手輪替一輪的場數，每批場數取它的倍數才不會偏向某些配對
+#define TOURNAMENT_ROTATION_GAMES (2 * CHARACTER_COUNT * CHARACTER_COUNT)
+
+typedef enum {
+    TOURNAMENT_ROUND_ROBIN,  // 所有策略兩兩對戰
+    TOURNAMENT_GAUNTLET      // bots[0] 對其他所有策略
+} TournamentMode;
+
+// 序貫機率比檢定（SPRT）
+// H0: 兩策略 Elo 差為 elo0，H1: Elo 差為 elo1
+typedef struct {
+    double elo0;
+    double elo1;
+    double alpha;  // 型一錯誤率
+    double beta;   // 型二錯誤率
+} SprtConfig;
+
+typedef enum {
+    SPRT_CONTINUE,   // 尚未決定
+    SPRT_ACCEPT_H0,
+    SPRT_ACCEPT_H1
+} SprtStatus;
+
+typedef struct {
+    const BotPolicy* bots[TOURNAMENT_MAX_BOTS];
+    int botCount;
+    TournamentMode mode;
+    uint64_t seed;
+    uint32_t maxTurns;
+    uint64_t maxGames;     // 每組配對的場數上限
+    uint64_t batchGames;   // 每批場數，每批結束時檢查 SPRT
+    bool useSprt;          // false 時每組都打滿 maxGames
+    SprtConfig sprt;
+    int threads;           // 0 表示使用全部核心
+} TournamentConfig;
+
+// 一組配對的結果（以 a 的角度計算）
+typedef struct {
+    int a;
+    int b;
+    uint64_t wins;
+    uint64_t draws;
+    uint64_t losses;
+    double llr;         // 目前的對數概似比
+    SprtStatus status;
+} TournamentPairing;
+
+typedef struct {
+    int pairingCount;
+    TournamentPairing pairings[TOURNAMENT_MAX_PAIRINGS];
+    double ratings[TOURNAMENT_MAX_BOTS];  // 最大概似 Elo，平均為 0
+    uint64_t totalGames;
+} TournamentResult;
+
+// 初始化設定（所有已註冊策略循環賽、SPRT [0, 10]、alpha=beta=0.05）
+void init_tournament_config(TournamentConfig* config);
+
+// 執行錦標賽；結果與執行緒數無關
+void run_tournament(const TournamentConfig* config, TournamentResult* result);
+
+// SPRT：由勝/和/負計算對數概似比，以及判斷是否可以停止
+double sprt_llr(const SprtConfig* sprt, uint64_t wins, uint64_t draws, uint64_t losses);
+SprtStatus sprt_status(const SprtConfig* sprt, double llr);
+
+// 一組配對的 Elo 差與 95% 信賴區間半徑
+double pairing_elo(const TournamentPairing* pairing, double* margin);
+
+// 由所有配對結果計算每個策略的 Elo
+void compute_tournament_ratings(const TournamentConfig* config, TournamentResult* result);
+
+void print_tournament(FILE* fp, const TournamentConfig* config, const TournamentResult* result);
+
+#endif // _TOURNAMENT_H
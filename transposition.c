@@ -0,0 +1,140 @@
+#include "transposition.h"
+
+// data 的欄位配置
+#define TT_VALUE_BITS 32
+#define TT_DEPTH_SHIFT 32
+#define TT_BOUND_SHIFT 40
+#define TT_GENERATION_SHIFT 42
+#define TT_GENERATION_MASK 0x3F
+#define TT_CHOICE_SHIFT 48
+#define TT_CHOICE_OFFSET 32768
+
+// 取代時每差一個世代等同少幾層深度
+#define TT_AGE_WEIGHT 4
+
+bool tt_init(TranspositionTable *table, size_t megabytes)
+{
+    size_t bytes = megabytes * 1024 * 1024;
+    size_t buckets = 1;
+    while (buckets * 2 * TT_BUCKET_ENTRIES * sizeof(TTEntry) <= bytes)
+        buckets *= 2;
+
+    table->entries = calloc(buckets * TT_BUCKET_ENTRIES, sizeof(TTEntry));
+    if (table->entries == NULL)
+    {
+        table->bucketCount = 0;
+        return false;
+    }
+    table->bucketCount = buckets;
+    atomic_init(&table->generation, 0);
+    return true;
+}
+
+void tt_free(TranspositionTable *table)
+{
+    free(table->entries);
+    table->entries = NULL;
+    table->bucketCount = 0;
+}
+
+void tt_clear(TranspositionTable *table)
+{
+    for (size_t i = 0; i < table->bucketCount * TT_BUCKET_ENTRIES; i++)
+    {
+        atomic_store_explicit(&table->entries[i].key, 0, memory_order_relaxed);
+        atomic_store_explicit(&table->entries[i].data, 0, memory_order_relaxed);
+    }
+}
+
+void tt_new_search(TranspositionTable *table)
+{
+    atomic_fetch_add_explicit(&table->generation, 1, memory_order_relaxed);
+}
+
+static uint64_t pack_data(int32_t value, int depth, TTBound bound, uint32_t generation, int32_t bestChoice)
+{
+    if (depth < 0)
+        depth = 0;
+    if (depth > UINT8_MAX)
+        depth = UINT8_MAX;
+    return (uint64_t)(uint32_t)value | (uint64_t)depth << TT_DEPTH_SHIFT | (uint64_t)bound << TT_BOUND_SHIFT |
+           (uint64_t)(generation & TT_GENERATION_MASK) << TT_GENERATION_SHIFT |
+           (uint64_t)(uint16_t)(bestChoice + TT_CHOICE_OFFSET) << TT_CHOICE_SHIFT;
+}
+
+static int data_depth(uint64_t data)
+{
+    return (int)((data >> TT_DEPTH_SHIFT) & 0xFF);
+}
+
+static uint32_t data_generation(uint64_t data)
+{
+    return (uint32_t)((data >> TT_GENERATION_SHIFT) & TT_GENERATION_MASK);
+}
+
+static TTEntry *bucket_of(TranspositionTable *table, uint64_t hash)
+{
+    return &table->entries[(hash & (table->bucketCount - 1)) * TT_BUCKET_ENTRIES];
+}
+
+bool tt_probe(TranspositionTable *table, uint64_t hash, TTEntryInfo *info)
+{
+    if (table->bucketCount == 0)
+        return false;
+
+    TTEntry *bucket = bucket_of(table, hash);
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++)
+    {
+        uint64_t data = atomic_load_explicit(&bucket[i].data, memory_order_relaxed);
+        uint64_t key = atomic_load_explicit(&bucket[i].key, memory_order_relaxed);
+        if (data == 0 || (key ^ data) != hash)
+            continue;
+
+        info->value = (int32_t)(uint32_t)(data & ((1ULL << TT_VALUE_BITS) - 1));
+        info->depth = data_depth(data);
+        info->bound = (TTBound)((data >> TT_BOUND_SHIFT) & 0x3);
+        info->bestChoice = (int32_t)(uint16_t)(data >> TT_CHOICE_SHIFT) - TT_CHOICE_OFFSET;
+        return true;
+    }
+    return false;
+}
+
+void tt_store(TranspositionTable *table, uint64_t hash, int32_t value, int depth, TTBound bound, int32_t bestChoice)
+{
+    if (table->bucketCount == 0)
+        return;
+
+    uint32_t generation = atomic_load_explicit(&table->generation, memory_order_relaxed);
+    TTEntry *bucket = bucket_of(table, hash);
+    TTEntry *target = NULL;
+    int targetScore = INT_MAX;
+
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++)
+    {
+        uint64_t data = atomic_load_explicit(&bucket[i].data, memory_order_relaxed);
+        uint64_t key = atomic_load_explicit(&bucket[i].key, memory_order_relaxed);
+
+        if (data != 0 && (key ^ data) == hash)
+        {
+            // 同一個局面：保留同世代裡較深的非精確結果
+            if (bound != TT_BOUND_EXACT && data_depth(data) > depth &&
+                data_generation(data) == (generation & TT_GENERATION_MASK))
+                return;
+            target = &bucket[i];
+            break;
+        }
+
+        // 空位最優先，其次是深度淺、世代舊的資料
+        int age = (int)((generation - data_generation(data)) & TT_GENERATION_MASK);
+        int score = data == 0 ? INT_MIN : data_depth(data) - TT_AGE_WEIGHT * age;
+        if (score < targetScore)
+        {
+            targetScore = score;
+            target = &bucket[i];
+        }
+    }
+
+    uint64_t data = pack_data(value, depth, bound, generation, bestChoice);
+    atomic_store_explicit(&target->key, hash ^ data, memory_order_relaxed);
+    atomic_store_explicit(&target->data, data, memory_order_relaxed);
+}
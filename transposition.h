@@ -0,0 +1,51 @@
+#ifndef _TRANSPOSITION_H
+#define _TRANSPOSITION_H
+
+#include <stdatomic.h>
+#include "architecture.h"
+
+// 多執行緒共用的置換表（無鎖）
+// 每筆資料存成 (雜湊 ^ 資料, 資料) 兩個 64 位元原子變數，讀取時驗證，
+// 同時寫入造成的不一致資料會被當成沒有命中，因此不需要鎖
+
+#define TT_DEFAULT_MEGABYTES 16
+#define TT_BUCKET_ENTRIES 4  // 一個 bucket 剛好一條 64 bytes 的 cache line
+
+typedef enum {
+    TT_BOUND_NONE = 0,
+    TT_BOUND_EXACT,
+    TT_BOUND_LOWER,  // 真正的值 >= value
+    TT_BOUND_UPPER   // 真正的值 <= value
+} TTBound;
+
+typedef struct {
+    int32_t value;
+    int depth;
+    TTBound bound;
+    int32_t bestChoice;
+} TTEntryInfo;
+
+typedef struct {
+    _Atomic uint64_t key;   // 雜湊 ^ data
+    _Atomic uint64_t data;  // 值、深度、邊界、世代、最佳選擇
+} TTEntry;
+
+typedef struct {
+    TTEntry* entries;
+    size_t bucketCount;  // 2 的次方
+    _Atomic uint32_t generation;
+} TranspositionTable;
+
+// 配置不超過 megabytes 的表（至少一個 bucket）
+bool tt_init(TranspositionTable* table, size_t megabytes);
+void tt_free(TranspositionTable* table);
+void tt_clear(TranspositionTable* table);
+
+// 每次新的搜尋開始時呼叫，舊世代的資料會優先被取代
+void tt_new_search(TranspositionTable* table);
+
+bool tt_probe(TranspositionTable* table, uint64_t hash, TTEntryInfo* info);
+void tt_store(TranspositionTable* table, uint64_t hash, int32_t value, int depth, TTBound bound,
+              int32_t bestChoice);
+
+#endif // _TRANSPOSITION_H
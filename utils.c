@@ -1,21 +1,16 @@
 #include <stdlib.h>
-#include <time.h>
 #include "utils.h"
 #include "debug_log.h"
+#include "rng.h"
 
 void shuffle_deck(vector* deck) {
     DEBUG_LOG("洗牌開始，牌堆大小：%u", deck->SIZE);
     
     if (deck->SIZE <= 1) return;
     
-    static bool seeded = false;
-    if (!seeded) {
-        srand((unsigned int)time(NULL));
-        seeded = true;
-    }
-    
+    // 使用目前執行緒的亂數來源（模擬時可重現，一般遊戲退回 rand()）
     for (uint32_t i = deck->SIZE - 1; i > 0; i--) {
-        uint32_t j = rand() % (i + 1);
+        uint32_t j = rng_random_below(i + 1);
         // 交換卡片
         int32_t temp = deck->array[i];
         deck->array[i] = deck->array[j];